@@ -10,20 +10,182 @@
 //
 /////////////////////////////////////////////////////////////////////////////
 
+#include <list>
 #include "S_scheme.h"
+#include "context.h"
 
 using std::vector;
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Workspace
+//
+//   Gives access to a block of work storage of type W for dimension N.
+//   Storage is kept in a per-thread pool and reused by later calls, so
+//   that the inner loop of the S_scheme does not need to allocate
+//   memory. Workspaces in use are skipped, such that nested calls
+//   (e.g. a chunk which calculates its own matrices) get separate storage.
+//
+//   The pool holds at most max_pool_size workspaces per thread; beyond
+//   that, the least recently used idle one is freed. Workspaces in use
+//   are never freed, so deep nesting can temporarily exceed this limit.
+//
+//   W should have a constructor taking N and members 'N' and 'in_use'.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template <class W>
+class Workspace
+{
+  public:
+
+    Workspace(int N)
+    {
+      std::list<W>& p = pool();
+
+      typename std::list<W>::iterator i;
+      for (i=p.begin(); i!=p.end(); i++)
+        if ( (!i->in_use) && (i->N == N) )
+          break;
+
+      if (i == p.end())
+      {
+        // Drop the least recently used idle workspace if the pool is full.
+
+        if (p.size() >= max_pool_size)
+          for (typename std::list<W>::iterator j=p.begin(); j!=p.end(); j++)
+            if (!j->in_use)
+            {
+              p.erase(j);
+              break;
+            }
+
+        p.push_back(W(N));
+        i = --p.end();
+      }
+      else
+        p.splice(p.end(), p, i); // Most recently used at the back.
+
+      w = &*i;
+      w->in_use = true;
+    }
+
+    ~Workspace() {w->in_use = false;}
+
+    W& operator*() {return *w;}
+
+  protected:
+
+    W* w;
+
+    static const unsigned int max_pool_size = 8;
+
+    static std::list<W>& pool()
+      {static thread_local std::list<W> p; return p;}
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DenseWorkspace
+//
+//   Storage for S_scheme with dense matrices. All arrays are 1-based and
+//   column-major, as LAPACK and calc_tilde expect.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+struct DenseWorkspace
+{
+  DenseWorkspace(int N_);
+  DenseWorkspace(const DenseWorkspace& w)
+    : DenseWorkspace(w.N) {} // Fresh storage rather than blitz references.
+  
+  void alloc();
+
+  int N;
+  bool in_use;
+
+  // 'Tilde' matrices and propagation factors.
+
+  cMatrix r12, r21, t12, t21;
+  cVector prop;
+
+  // Current and next result.
+
+  cMatrix R12, R21, T12, T21;
+  cMatrix nR12, nR21, nT12, nT21;
+
+  // System A*X=B, where B1 and B2 are views on the two halves of B.
+
+  cMatrix A, B, B1, B2;
+  iVector P;
+};
+
+DenseWorkspace::DenseWorkspace(int N_)
+  : N(N_), in_use(false),
+    r12(fortranArray), r21(fortranArray),
+    t12(fortranArray), t21(fortranArray), prop(fortranArray),
+     R12(fortranArray),  R21(fortranArray),
+     T12(fortranArray),  T21(fortranArray),
+    nR12(fortranArray), nR21(fortranArray),
+    nT12(fortranArray), nT21(fortranArray),
+    A(fortranArray), B(fortranArray), B1(fortranArray), B2(fortranArray),
+    P(fortranArray)
+{
+  alloc();
+}
+
+void DenseWorkspace::alloc()
+{
+  r12.resize(N,N); r21.resize(N,N); t12.resize(N,N); t21.resize(N,N);
+  prop.resize(N);
+
+   R12.resize(N,N);  R21.resize(N,N);  T12.resize(N,N);  T21.resize(N,N);
+  nR12.resize(N,N); nR21.resize(N,N); nT12.resize(N,N); nT21.resize(N,N);
+
+  A.resize(N,N); B.resize(N,2*N); P.resize(N);
+
+  B1.reference(B(blitz::Range::all(), blitz::Range(1,  N)));
+  B2.reference(B(blitz::Range::all(), blitz::Range(N+1,2*N)));
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// calc_prop
+//
+//   Calculates the propagation factors of a chunk in 'prop'.
+//   Returns false if there is no propagation.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+bool calc_prop(const Chunk& chunk, cVector* prop)
+{
+  if (abs(chunk.d) == 0)
+    return false;
+
+  for (int i=1; i<=global.N; i++)
+    (*prop)(i) = exp(-I*chunk.sc->get_ext()->get_mode(i)->get_kz()*chunk.d);
+
+  return true;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // calc_tilde
 //
 //   Calculates 'tilde' matrices used in S_scheme.
+//   'prop' is used as storage for the propagation factors.
 //  
 /////////////////////////////////////////////////////////////////////////////
 
 void calc_tilde(const Chunk& chunk,
-                cMatrix* r12, cMatrix* r21, cMatrix* t12, cMatrix* t21)
+                cMatrix* r12, cMatrix* r21, cMatrix* t12, cMatrix* t21,
+                cVector* prop)
 {
   // No propagation needed?
 
@@ -39,9 +201,7 @@ void calc_tilde(const Chunk& chunk,
 
   // Create vector with propagation factors.
 
-  cVector prop(global.N,fortranArray);
-  for (int i=1; i<=global.N; i++)
-    prop(i) = exp( -I * s->get_ext()->get_mode(i)->get_kz() * chunk.d );
+  calc_prop(chunk, prop);
   
   // Transparent scatterer?
 
@@ -50,16 +210,16 @@ void calc_tilde(const Chunk& chunk,
     *r12 = 0; *r21 = 0; *t12 = 0; *t21 = 0;
     
     for (int i=1; i<=global.N; i++)
-      (*t12)(i,i) = (*t21)(i,i) = prop(i);
+      (*t12)(i,i) = (*t21)(i,i) = (*prop)(i);
   }
   else
   {
     blitz::firstIndex i; blitz::secondIndex j;
 
-    *r12 =           (s->get_R12());
-    *r21 = prop(i) * (s->get_R21())(i,j) * prop(j);
-    *t12 = prop(i) * (s->get_T12())(i,j);
-    *t21 =           (s->get_T21())(i,j) * prop(j);
+    *r12 =              (s->get_R12());
+    *r21 = (*prop)(i) * (s->get_R21())(i,j) * (*prop)(j);
+    *t12 = (*prop)(i) * (s->get_T12())(i,j);
+    *t21 =              (s->get_T21())(i,j) * (*prop)(j);
   }
 }
 
@@ -67,78 +227,210 @@ void calc_tilde(const Chunk& chunk,
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// S_scheme
+// Diagonal scaling of matrices, i.e. M <- P*M, M <- M*P and M <- P*M*P,
+// with P=diag(p).
 //  
 /////////////////////////////////////////////////////////////////////////////
 
-void S_scheme(const vector<Chunk>& chunks, DenseScatterer* result)
-{ 
-  result->allocRT();
+inline void scale_rows(cMatrix* M, const cVector& p)
+{
+  for (int j=1; j<=M->columns(); j++)
+    for (int i=1; i<=M->rows(); i++)
+      (*M)(i,j) *= p(i);
+}
 
-  // Matrices to store result from previous iteration.
+inline void scale_columns(cMatrix* M, const cVector& p)
+{
+  for (int j=1; j<=M->columns(); j++)
+    for (int i=1; i<=M->rows(); i++)
+      (*M)(i,j) *= p(j);
+}
 
-  DenseScatterer prev; prev.allocRT();
+inline void scale_both(cMatrix* M, const cVector& p)
+{
+  for (int j=1; j<=M->columns(); j++)
+    for (int i=1; i<=M->rows(); i++)
+      (*M)(i,j) *= p(i) * p(j);
+}
 
-  const cMatrix& pR12(prev.get_R12()); const cMatrix& pR21(prev.get_R21());
-  const cMatrix& pT12(prev.get_T12()); const cMatrix& pT21(prev.get_T21());
 
-  // 'Tilde' matrices.
 
-  const int N = global.N;
+/////////////////////////////////////////////////////////////////////////////
+//
+// solve_star
+//
+//   Solves A*X=B in place, with X overwriting B.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void solve_star(DenseWorkspace* w)
+{
+  if (global.stability != SVD)
+    solve_in_place(&w->A, &w->B, &w->P);
+  else
+    w->B = multiply(invert_svd(w->A), w->B);
+}
 
-  cMatrix r12(N,N,fortranArray); cMatrix r21(N,N,fortranArray);
-  cMatrix t12(N,N,fortranArray); cMatrix t21(N,N,fortranArray);
-  
-  // Unit and auxiliary matrices.
-  
-  cMatrix U1(N,N,fortranArray), M(N,N,fortranArray), tmp(N,N,fortranArray);
 
-  U1 = 0.0;
-  for (int i=1; i<=N; i++)
-    U1(i,i) = Complex(1.0, 0.0);
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// set_unit_minus
+//
+//   A = U - B*C.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void set_unit_minus(cMatrix* A, const cMatrix& B, const cMatrix& C)
+{
+  *A = 0.0;
+  for (int i=1; i<=A->rows(); i++)
+    (*A)(i,i) = 1.0;
+
+  multiply(B, C, A, -1.0, 1.0);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// S_scheme_serial
+//
+//   Combines the chunks from left to right.
+//
+//   Rather than forming the inverses explicitly, the star product is
+//   written as two linear systems with a double right hand side.
+//   With r12, r21, t12, t21 the matrices of the scatterer of the chunk
+//   and P the diagonal propagation matrix, i.e. r21~ = P*r21*P,
+//   t12~ = P*t12 and t21~ = t21*P:
+//
+//     (U - r12*R21) * [X1 X2] = [r12*T12  t21]
+//     R12 <- R12 + T21*X1, T21 <- T21*X2*P
+//
+//     (U - R21*r12) * [X1 X2] = [R21*t21  T12]
+//     R21 <- P*(r21 + t12*X1)*P, T12 <- P*t12*X2
+//
+//   This way P is applied as a scaling of the results, and the scaled
+//   matrices of the chunk are never formed. A transparent chunk only
+//   scales the current result.
+//
+//   All intermediate results live in a pooled workspace.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void S_scheme_serial(const vector<Chunk>& chunks, DenseScatterer* result)
+{ 
+  const int N = global.N;
+
+  Workspace<DenseWorkspace> lock(N);
+  DenseWorkspace& w(*lock);
   
   // Initialise matrices from first chunk.
-  // Make sure 'result' contains separate data from other matrices,
-  // since it will be overwritten.
   
-  calc_tilde(chunks[0], &r12, &r21, &t12, &t21);
-
-  result->copy_R12(r12); result->copy_R21(r21);
-  result->copy_T12(t12); result->copy_T21(t21);
+  calc_tilde(chunks[0], &w.R12, &w.R21, &w.T12, &w.T21, &w.prop);
   
   // Loop from second chunk to last one.
   
   for (unsigned int k=1; k<chunks.size(); k++)
   {
-    // Previous result = current result (fast shallow copy).
+    const bool propagate = calc_prop(chunks[k], &w.prop);
+
+    // Transparent scatterer?
+
+    MultiScatterer* s = dynamic_cast<MultiScatterer*>(chunks[k].sc);
+
+    if (dynamic_cast<TransparentScatterer*>(s))
+    {
+      if (propagate)
+      {
+        scale_columns(&w.T21, w.prop);
+        scale_both   (&w.R21, w.prop);
+        scale_rows   (&w.T12, w.prop);
+      }
+
+      continue;
+    }
+
+    const cMatrix& r12(s->get_R12()); const cMatrix& r21(s->get_R21());
+    const cMatrix& t12(s->get_T12()); const cMatrix& t21(s->get_T21());
 
-    prev.swap_RT_with(*result);
-    
     // Calculate new result matrices.
 
-    calc_tilde(chunks[k], &r12, &r21, &t12, &t21);
-    
-    tmp = U1 - multiply(r12, pR21);
-    if (global.stability != SVD)
-      M.reference(invert    (tmp));
-    else
-      M.reference(invert_svd(tmp));
-
-    tmp = multiply(pT21, M, r12, pT12) + pR12;
-    result->copy_R12(tmp);
-    result-> set_T21(multiply(pT21, M, t21));
+    set_unit_minus(&w.A, r12, w.R21);
+    multiply(r12, w.T12, &w.B1);
+    w.B2 = t21;
+    solve_star(&w);
+
+    w.nR12 = w.R12;
+    multiply(w.T21, w.B1, &w.nR12, 1.0, 1.0);
+    multiply(w.T21, w.B2, &w.nT21);
+
+    set_unit_minus(&w.A, w.R21, r12);
+    multiply(w.R21, t21, &w.B1);
+    w.B2 = w.T12;
+    solve_star(&w);
+
+    w.nR21 = r21;
+    multiply(t12, w.B1, &w.nR21, 1.0, 1.0);
+    multiply(t12, w.B2, &w.nT12);
+
+    if (propagate)
+    {
+      scale_columns(&w.nT21, w.prop);
+      scale_both   (&w.nR21, w.prop);
+      scale_rows   (&w.nT12, w.prop);
+    }
     
-    tmp = U1 - multiply(pR21, r12);
-    if(global.stability != SVD)
-      M.reference(invert    (tmp));
-    else
-      M.reference(invert_svd(tmp));
+    // Current result = next result (fast shallow copy).
 
-    tmp = multiply(t12, M, pR21, t21) + r21;
-
-    result->copy_R21(tmp);
-    result-> set_T12(multiply(t12, M, pT12));
+    blitz::cycleArrays(w.R12, w.nR12); blitz::cycleArrays(w.R21, w.nR21);
+    blitz::cycleArrays(w.T12, w.nT12); blitz::cycleArrays(w.T21, w.nT21);
   }
+
+  // Copy to result, which should contain separate data from the workspace.
+  
+  result->allocRT();
+
+  result->copy_R12(w.R12); result->copy_R21(w.R21);
+  result->copy_T12(w.T12); result->copy_T21(w.T21);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiagWorkspace
+//
+//   Storage for S_scheme with diagonal matrices. All vectors are 1-based.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+struct DiagWorkspace
+{
+  DiagWorkspace(int N_);
+  DiagWorkspace(const DiagWorkspace& w) : DiagWorkspace(w.N) {}
+  
+  void alloc();
+
+  int N;
+  bool in_use;
+
+  cVector R12, R21, T12, T21;
+  cVector prop, M;
+};
+
+DiagWorkspace::DiagWorkspace(int N_)
+  : N(N_), in_use(false),
+    R12(fortranArray), R21(fortranArray),
+    T12(fortranArray), T21(fortranArray), prop(fortranArray), M(fortranArray)
+{
+  alloc();
+}
+
+void DiagWorkspace::alloc()
+{
+  R12.resize(N); R21.resize(N); T12.resize(N); T21.resize(N);
+  prop.resize(N); M.resize(N);
 }
 
 
@@ -148,11 +440,13 @@ void S_scheme(const vector<Chunk>& chunks, DenseScatterer* result)
 // calc_tilde
 //
 //   Calculates 'tilde' vectors used in S_scheme.
+//   'prop' is used as storage for the propagation factors.
 //  
 /////////////////////////////////////////////////////////////////////////////
 
 void calc_tilde(const Chunk& chunk,
-                cVector* r12, cVector* r21, cVector* t12, cVector* t21)
+                cVector* r12, cVector* r21, cVector* t12, cVector* t21,
+                cVector* prop)
 {
   // No propagation needed?
 
@@ -168,25 +462,20 @@ void calc_tilde(const Chunk& chunk,
 
   // Create vector with propagation constants.
 
-  cVector prop(global.N,fortranArray);
-  for (int i=1; i<=global.N; i++)
-    prop(i) = exp( -I * s->get_ext()->get_mode(i)->get_kz() * chunk.d );
+  calc_prop(chunk, prop);
 
   // Transparent scatterer?
 
   if (dynamic_cast<TransparentScatterer*>(s))
   {
-    *r12 = 0; *r21 = 0; *t12 = 0; *t21 = 0;
-    
-    for (int i=1; i<=global.N; i++)
-      (*t12)(i) = (*t21)(i) = prop(i);
+    *r12 = 0; *r21 = 0; *t12 = *prop; *t21 = *prop;
   }
   else
   {
-    *r12 =        s->get_diag_R12();
-    *r21 = prop * s->get_diag_R21() * prop;
-    *t12 = prop * s->get_diag_T12();
-    *t21 =        s->get_diag_T21() * prop;
+    *r12 =           s->get_diag_R12();
+    *r21 = *prop * s->get_diag_R21() * *prop;
+    *t12 = *prop * s->get_diag_T12();
+    *t21 =           s->get_diag_T21() * *prop;
   }
 }
 
@@ -194,62 +483,77 @@ void calc_tilde(const Chunk& chunk,
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// S_scheme for diagonal Scatterers.
+// S_scheme_serial for diagonal Scatterers.
 //  
 /////////////////////////////////////////////////////////////////////////////
 
-void S_scheme(const vector<Chunk>& chunks, DiagScatterer* result)
+void S_scheme_serial(const vector<Chunk>& chunks, DiagScatterer* result)
 { 
-  result->allocRT();
-  
-  // Vectors to store result from previous iteration.
+  Workspace<DiagWorkspace> lock(global.N);
+  DiagWorkspace& w(*lock);
 
-  DiagScatterer prev; prev.allocRT();
+  cVector& R12(w.R12); cVector& R21(w.R21);
+  cVector& T12(w.T12); cVector& T21(w.T21);
 
-  const cVector& pR12(prev.get_diag_R12());
-  const cVector& pR21(prev.get_diag_R21());
-  const cVector& pT12(prev.get_diag_T12());
-  const cVector& pT21(prev.get_diag_T21());
-  
-  // 'Tilde' vectors.
-
-  const int N = global.N;
-    
-  cVector r12(N,fortranArray), r21(N,fortranArray);
-  cVector t21(N,fortranArray), t12(N,fortranArray);
-    
-  // Auxiliary and temporary vectors.
-  
-  cVector M(N,fortranArray), tmp(N,fortranArray);
+  cVector& P(w.prop); cVector& M(w.M);
   
   // Initialise vectors from first chunk.
-  // Make sure 'result' contains separate data from other matrices,
-  // since it will be overwritten.
-  
-  calc_tilde(chunks[0], &r12, &r21, &t12, &t21);
   
-  result->copy_diag_R12(r12); result->copy_diag_R21(r21);
-  result->copy_diag_T12(t12); result->copy_diag_T21(t21);
+  calc_tilde(chunks[0], &R12, &R21, &T12, &T21, &P);
   
-  // Loop from second chunk to last one.
+  // Loop from second chunk to last one. Since all operations are
+  // elementwise, the result can be updated in place, as long as
+  // R12 and R21 are updated before T21 and T12.
+  //
+  // As in the dense case, the bare vectors of the chunk are used and
+  // the propagation factors are applied to the results afterwards.
   
   for (unsigned int k=1; k<chunks.size(); k++)
   { 
-    // Previous result = current result (fast shallow copy).
+    const bool propagate = calc_prop(chunks[k], &P);
+
+    // Transparent scatterer?
+
+    MultiScatterer* s = dynamic_cast<MultiScatterer*>(chunks[k].sc);
+
+    if (dynamic_cast<TransparentScatterer*>(s))
+    {
+      if (propagate)
+      {
+        T21 *= P;
+        R21 *= P * P;
+        T12 *= P;
+      }
+
+      continue;
+    }
+
+    const cVector& r12(s->get_diag_R12());
+    const cVector& r21(s->get_diag_R21());
+    const cVector& t12(s->get_diag_T12());
+    const cVector& t21(s->get_diag_T21());
+
+    M = 1.0/(1.0-r12*R21);
+
+    R12 = T21 * M *  r12 * T12  +  R12;
+    T21 = T21 * M *  t21;
+    R21 = t12 * M *  R21 * t21  +  r21;
+    T12 = t12 * M *  T12;
+
+    if (propagate)
+    {
+      T21 *= P;
+      R21 *= P * P;
+      T12 *= P;
+    }
+  }
 
-    prev.swap_RT_with(*result);
-    
-    // Calculate new result vectors.
+  // Copy to result, which should contain separate data from the workspace.
 
-    calc_tilde(chunks[k], &r12, &r21, &t12, &t21);
-    
-    M = 1.0/(1.0-r12*pR21);
+  result->allocRT();
 
-    tmp = pT21 * M *  r12 * pT12  +  pR12; result->copy_diag_R12(tmp);
-    tmp = pT21 * M *  t21;                 result->copy_diag_T21(tmp);
-    tmp =  t12 * M * pR21 *  t21  +   r21; result->copy_diag_R21(tmp);
-    tmp =  t12 * M * pT12;                 result->copy_diag_T12(tmp);
-  }
+  result->copy_diag_R12(R12); result->copy_diag_R21(R21);
+  result->copy_diag_T12(T12); result->copy_diag_T21(T21);
 }
 
 
@@ -300,11 +604,11 @@ void calc_tilde(const Chunk& chunk,
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// S_scheme for Monoscatterers
+// S_scheme_serial for Monoscatterers
 //  
 /////////////////////////////////////////////////////////////////////////////
 
-void S_scheme(const vector<Chunk>& chunks, MonoScatterer* result)
+void S_scheme_serial(const vector<Chunk>& chunks, MonoScatterer* result)
 {
   // Variables to store result from previous iteration.
   
@@ -348,3 +652,147 @@ void S_scheme(const vector<Chunk>& chunks, MonoScatterer* result)
     result->set_T12( t12 * M * pT12);
   }
 }
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// prepare_chunks
+//
+//   Makes sure that the matrices of the chunks can be read concurrently,
+//   by doing the lazy conversion of DiagScatterers to dense matrices
+//   beforehand.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void prepare_chunks(const vector<Chunk>& chunks, DenseScatterer*)
+{
+  for (unsigned int k=0; k<chunks.size(); k++)
+  {
+    MultiScatterer* s = dynamic_cast<MultiScatterer*>(chunks[k].sc);
+    
+    s->get_R12(); s->get_R21(); s->get_T12(); s->get_T21();
+  }
+}
+
+void prepare_chunks(const vector<Chunk>& chunks,  DiagScatterer*) {}
+void prepare_chunks(const vector<Chunk>& chunks,  MonoScatterer*) {}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// S_scheme_tree
+//
+//   Since the star product of scatterers is associative, the chunks can
+//   be split in blocks which are combined concurrently. The results of
+//   the blocks are then combined pairwise in a balanced tree, where the
+//   pairs on the same level are again independent.
+//
+//   T = DenseScatterer, DiagScatterer or MonoScatterer.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+void S_scheme_tree(const vector<Chunk>& chunks, T* result, int threads)
+{
+  prepare_chunks(chunks, result);
+
+  const int K = chunks.size();
+  const int B = (threads < K/2) ? threads : K/2;
+
+  const ThreadContext context = get_thread_context();
+
+  // Combine the chunks in each block from left to right.
+  
+  vector<T*> blocks(B);
+
+  #pragma omp parallel for num_threads(threads) schedule(static)
+  for (int b=0; b<B; b++)
+  {
+    ContextSwitch context_switch(context);
+
+    vector<Chunk> block(chunks.begin() + (b*K)/B, 
+                        chunks.begin() + ((b+1)*K)/B);
+
+    blocks[b] = new T;
+    S_scheme_serial(block, blocks[b]);
+  }
+
+  // Combine the blocks pairwise.
+
+  for (int stride=1; stride<B; stride*=2)
+  {
+    #pragma omp parallel for num_threads(threads) schedule(static)
+    for (int b=0; b<B-stride; b+=2*stride)
+    {
+      ContextSwitch context_switch(context);
+
+      vector<Chunk> pair;
+      pair.push_back(Chunk(blocks[b]));
+      pair.push_back(Chunk(blocks[b+stride]));
+
+      T* combined = new T;
+      S_scheme_serial(pair, combined);
+
+      delete blocks[b];
+      delete blocks[b+stride];
+
+      blocks[b] = combined;
+    }
+  }
+
+  result->copy_RT_from(*blocks[0]);
+  delete blocks[0];
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// use_tree
+//
+//   Determines whether the tree variant of the S_scheme should be used.
+//   Forced recalculation is excluded, since then reading the matrices of
+//   a chunk can trigger a recalculation.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool use_tree(const vector<Chunk>& chunks)
+{
+  return    (global.threads > 1)
+         && (chunks.size() >= 4)
+         && (global.always_recalculate == false);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// S_scheme
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void S_scheme(const vector<Chunk>& chunks, DenseScatterer* result)
+{
+  if (use_tree(chunks))
+    S_scheme_tree(chunks, result, global.threads);
+  else
+    S_scheme_serial(chunks, result);
+}
+
+void S_scheme(const vector<Chunk>& chunks, DiagScatterer* result)
+{
+  if (use_tree(chunks))
+    S_scheme_tree(chunks, result, global.threads);
+  else
+    S_scheme_serial(chunks, result);
+}
+
+void S_scheme(const vector<Chunk>& chunks, MonoScatterer* result)
+{
+  if (use_tree(chunks))
+    S_scheme_tree(chunks, result, global.threads);
+  else
+    S_scheme_serial(chunks, result);
+}
@@ -33,6 +33,9 @@
 // Different variants are optimised for structures with diagonal matrices
 // or monomode structures.
 //
+// If global.threads is larger than one, long stacks are combined in a
+// balanced tree rather than from left to right, so that independent
+// parts can be calculated concurrently.
 //
 /////////////////////////////////////////////////////////////////////////////
 
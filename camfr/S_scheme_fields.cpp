@@ -243,6 +243,214 @@ void S_scheme_fields_T
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: RightScatterers
+//
+//   Provides the combined scatterer of chunks k+1..end, for k running
+//   from 0 to the last chunk, using a linear number of star products.
+//
+//   A first backward sweep keeps the composite of every 'stride'-th
+//   chunk. When the forward loop enters the next segment, the composites
+//   of that segment are rebuilt from the checkpoint to its right. For K
+//   chunks, this stores about 2*sqrt(K) composites at the cost of about
+//   2*K star products.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+class RightScatterers
+{
+  public:
+
+    RightScatterers(const vector<Chunk>& chunks);
+    ~RightScatterers();
+
+    // Combined scatterer of chunks k+1..end, or NULL for the last chunk.
+    // Should be called for increasing k.
+
+    T* get(int k);
+
+  protected:
+
+    // Returns composite of chunk k+1 and 'right', the composite of the
+    // chunks after it.
+
+    T* combine(int k, T* right);
+
+    void free_segment();
+
+    const vector<Chunk>& chunks;
+
+    int last;   // Highest k with a composite.
+    int stride;
+
+    vector<T*> checkpoint; // For k = 0, stride, 2*stride, ...
+    vector<T*> segment;    // For k = start, start+1, ...
+    int start;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// RightScatterers::RightScatterers
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+RightScatterers<T>::RightScatterers(const vector<Chunk>& chunks_)
+  : chunks(chunks_), last(int(chunks_.size())-2), stride(1), start(-1)
+{
+  while (stride*stride < last+1)
+    stride++;
+
+  if (last < 0)
+    return;
+
+  checkpoint.assign(last/stride+1, (T*)NULL);
+
+  T* right = NULL;
+  for (int k=last; k>=0; k--)
+  {
+    T* composite = combine(k, right);
+
+    if (right && ((k+1) % stride != 0))
+      delete right;
+
+    if (k % stride == 0)
+      checkpoint[k/stride] = composite;
+
+    right = composite;
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// RightScatterers::~RightScatterers
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+RightScatterers<T>::~RightScatterers()
+{
+  free_segment();
+
+  for (unsigned int i=0; i<checkpoint.size(); i++)
+    delete checkpoint[i];
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// RightScatterers::combine
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+T* RightScatterers<T>::combine(int k, T* right)
+{
+  vector<Chunk> pair;
+  pair.push_back(chunks[k+1]);
+  if (right)
+    pair.push_back(Chunk(right, 0.0));
+
+  T* composite = new T;
+  S_scheme(pair, composite);
+
+  return composite;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// RightScatterers::free_segment
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+void RightScatterers<T>::free_segment()
+{
+  // The first element is a checkpoint.
+
+  for (unsigned int i=1; i<segment.size(); i++)
+    delete segment[i];
+
+  segment.clear();
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// RightScatterers::get
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+T* RightScatterers<T>::get(int k)
+{
+  if (k > last)
+    return NULL;
+
+  // Rebuild segment if needed.
+
+  const int s = (k/stride)*stride;
+
+  if (s != start)
+  {
+    free_segment();
+    start = s;
+
+    const int end = (s+stride-1 < last) ? s+stride-1 : last;
+    segment.assign(end-s+1, (T*)NULL);
+    segment[0] = checkpoint[s/stride];
+
+    T* right = (end < last) ? checkpoint[(s+stride)/stride] : NULL;
+    for (int j=end; j>s; j--)
+      right = segment[j-s] = combine(j, right);
+  }
+
+  return segment[k-start];
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// solve_T21
+//
+//   Solves T21.x = b, which is cheaper than inverting T21.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+cVector solve_T21(const cMatrix& T21, const cVector& b)
+{
+  const int N = b.rows();
+
+  cMatrix B(N,1,fortranArray);
+  for (int i=1; i<=N; i++)
+    B(i,1) = b(i);
+
+  cMatrix X(N,1,fortranArray);
+  if (global.stability != SVD)
+    X.reference(solve    (T21, B));
+  else
+    X.reference(solve_svd(T21, B));
+
+  cVector x(N,fortranArray);
+  for (int i=1; i<=N; i++)
+    x(i) = X(i,1);
+
+  return x;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // calc_S_S
@@ -259,6 +467,10 @@ void calc_S_S(const vector<Chunk>& chunks,
   
   cVector fw0(N,fortranArray); fw0 = (*field)[0].fw;
   cVector bw0(N,fortranArray); bw0 = (*field)[0].bw;
+
+  // Scatterers to the right of each chunk.
+
+  RightScatterers<DenseScatterer> right_sc(chunks);
   
   // Loop over chunks.
 
@@ -274,14 +486,8 @@ void calc_S_S(const vector<Chunk>& chunks,
     cVector tmp(N,fortranArray);
     tmp = bw0 - multiply(R12,fw0);
 
-    cMatrix inv_T21(N,N,fortranArray);
-    if(global.stability != SVD)
-      inv_T21.reference(invert    (T21));
-    else
-      inv_T21.reference(invert_svd(T21));
-
     cVector fw_int(N,fortranArray);
-    fw_int = multiply(T12,fw0) + multiply(R21,inv_T21,tmp);
+    fw_int = multiply(T12,fw0) + multiply(R21,solve_T21(T21,tmp));
 
     // Calculate fw field after propagation.
 
@@ -294,20 +500,15 @@ void calc_S_S(const vector<Chunk>& chunks,
 
     // Calculate bw field after propagation.
     
-    vector<Chunk> right_chunks;
-    for (unsigned int j=k+1; j<chunks.size(); j++)
-      right_chunks.push_back(chunks[j]);
+    DenseScatterer* right = right_sc.get(k);
 
     cVector bw_prop(N,fortranArray);
-    if (right_chunks.size() != 0)
+    if (right)
     {
-      DenseScatterer right; right.allocRT();
-      S_scheme(right_chunks, &right);
-
-      bw_prop.reference(multiply(right.get_R12(),fw_prop));
+      bw_prop.reference(multiply(right->get_R12(),fw_prop));
 
       if (inc_right_bw)
-        bw_prop = bw_prop + multiply(right.get_T21(), *inc_right_bw);
+        bw_prop = bw_prop + multiply(right->get_T21(), *inc_right_bw);
     }
     else
       if (inc_right_bw)
@@ -356,6 +557,10 @@ void calc_S_S_diag(const vector<Chunk>& chunks,
   if (chunks[0].sc->get_inc() == chunks[0].sc->get_ext())
     chunks[0].sc->calcRT();
 
+  // Scatterers to the right of each chunk.
+
+  RightScatterers<DiagScatterer> right_sc(chunks);
+
   // Loop over chunks.
   
   for (unsigned int k=0; k<chunks.size(); k++)
@@ -383,21 +588,15 @@ void calc_S_S_diag(const vector<Chunk>& chunks,
 
     // Calculate bw field after propagation.
     
-    vector<Chunk> right_chunks;
-    for (unsigned int j=k+1; j<chunks.size(); j++)
-      right_chunks.push_back(chunks[j]);
+    DiagScatterer* right = right_sc.get(k);
 
     cVector bw_prop(N,fortranArray);
-    if (right_chunks.size() != 0)
+    if (right)
     {
-      DiagScatterer right; right.allocRT();
-
-      S_scheme(right_chunks, &right);
-      
-      bw_prop = right.get_diag_R12() * fw_prop;
+      bw_prop = right->get_diag_R12() * fw_prop;
 
       if (inc_right_bw)
-        bw_prop = bw_prop + right.get_diag_T21() * (*inc_right_bw);
+        bw_prop = bw_prop + right->get_diag_T21() * (*inc_right_bw);
     }
     else
       if (inc_right_bw)
@@ -444,6 +643,13 @@ void calc_S_S_mono(const vector<Chunk>& chunks,
   if (chunks[0].sc->get_inc() == chunks[0].sc->get_ext())
     chunks[0].sc->calcRT();
 
+  // Scatterers to the right of each chunk.
+
+  for (unsigned int j=1; j<chunks.size(); j++)
+    chunks[j].sc->calcRT(); // Transparent scatterer isn't auto-calculateded.
+
+  RightScatterers<MonoScatterer> right_sc(chunks);
+
   // Loop over chunks.
 
   for (unsigned int k=0; k<chunks.size(); k++)
@@ -469,23 +675,15 @@ void calc_S_S_mono(const vector<Chunk>& chunks,
 
     // Calculate bw field after propagation.
     
-    vector<Chunk> right_chunks;
-    for (unsigned int j=k+1; j<chunks.size(); j++)
-    {
-      right_chunks.push_back(chunks[j]);
-      chunks[j].sc->calcRT(); // Transparent scatterer isn't auto-calculateded.
-    }
+    MonoScatterer* right = right_sc.get(k);
 
     cVector bw_prop(1,fortranArray);
-    if (right_chunks.size() != 0)
+    if (right)
     {
-      MonoScatterer right; right.allocRT();
-      S_scheme(right_chunks, &right);
-      
-      bw_prop = right.get_R12() * fw_prop;
+      bw_prop = right->get_R12() * fw_prop;
 
       if (inc_right_bw)
-        bw_prop = bw_prop + right.get_T21() * (*inc_right_bw);
+        bw_prop = bw_prop + right->get_T21() * (*inc_right_bw);
     }
     else
       if (inc_right_bw)
@@ -510,6 +708,240 @@ void calc_S_S_mono(const vector<Chunk>& chunks,
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// scale_rows_prop
+//
+//   Multiplies row i of A by the propagation factor of mode i over a
+//   distance d in waveguide wg.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void scale_rows_prop(cMatrix* A, Waveguide* wg, const Complex& d)
+{
+  for (int i=1; i<=A->rows(); i++)
+  {
+    const Complex prop = exp(-I * wg->get_mode(i)->get_kz() * d);
+    
+    for (int j=1; j<=A->columns(); j++)
+      (*A)(i,j) *= prop;
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// calc_S_S_multi
+//
+//   Matrix counterpart of calc_S_S, where each product is a single
+//   matrix-matrix multiplication for all excitations.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void calc_S_S_multi(const vector<Chunk>& chunks,
+                    vector<cMatrix>* fw, vector<cMatrix>* bw,
+                    const cMatrix* inc_right_bw)
+{
+  // Fields at left side.
+
+  const int N = global.N;
+  const int K = (*fw)[0].columns();
+
+  cMatrix fw0(N,K,fortranArray); fw0 = (*fw)[0];
+  cMatrix bw0(N,K,fortranArray); bw0 = (*bw)[0];
+
+  // Scatterers to the right of each chunk.
+
+  RightScatterers<DenseScatterer> right_sc(chunks);
+  
+  // Loop over chunks.
+
+  for (unsigned int k=0; k<chunks.size(); k++)
+  {
+    // Calculate fw field after interface.
+
+    MultiScatterer* sc = dynamic_cast<MultiScatterer*>(chunks[k].sc);
+
+    const cMatrix& R12(sc->get_R12()); const cMatrix& R21(sc->get_R21());
+    const cMatrix& T12(sc->get_T12()); const cMatrix& T21(sc->get_T21());
+
+    cMatrix tmp(N,K,fortranArray);
+    tmp = bw0;
+    multiply(R12, fw0, &tmp, -1.0, 1.0);
+
+    cMatrix bw_right(N,K,fortranArray);
+    if (global.stability != SVD)
+      bw_right.reference(solve    (T21, tmp));
+    else
+      bw_right.reference(solve_svd(T21, tmp));
+
+    cMatrix fw_int(N,K,fortranArray);
+    multiply(T12, fw0,      &fw_int);
+    multiply(R21, bw_right, &fw_int, 1.0, 1.0);
+
+    // Calculate fw field after propagation.
+
+    Waveguide* wg = chunks[k].sc->get_ext();
+
+    cMatrix fw_prop(N,K,fortranArray);
+    fw_prop = fw_int;
+    scale_rows_prop(&fw_prop, wg, chunks[k].d);
+
+    // Calculate bw field after propagation.
+
+    DenseScatterer* right = right_sc.get(k);
+
+    cMatrix bw_prop(N,K,fortranArray);
+    if (right)
+    {
+      multiply(right->get_R12(), fw_prop, &bw_prop);
+
+      if (inc_right_bw)
+        multiply(right->get_T21(), *inc_right_bw, &bw_prop, 1.0, 1.0);
+    }
+    else
+      if (inc_right_bw)
+        bw_prop = *inc_right_bw;
+      else
+        bw_prop = 0.0;
+
+    // Calculate bw field after interface.
+
+    cMatrix bw_int(N,K,fortranArray);
+    bw_int = bw_prop;
+    scale_rows_prop(&bw_int, wg, chunks[k].d);
+
+    // Update field vectors.
+
+    fw->push_back(fw_int);  bw->push_back(bw_int);
+    fw->push_back(fw_prop); bw->push_back(bw_prop);
+
+    fw0 = fw_prop;
+    bw0 = bw_prop;
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// calc_S_S_diag_multi
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void calc_S_S_diag_multi(const vector<Chunk>& chunks,
+                         vector<cMatrix>* fw, vector<cMatrix>* bw,
+                         const cMatrix* inc_right_bw)
+{
+  // Fields at left side.
+
+  const int N = global.N;
+  const int K = (*fw)[0].columns();
+
+  cMatrix fw0(N,K,fortranArray); fw0 = (*fw)[0];
+  cMatrix bw0(N,K,fortranArray); bw0 = (*bw)[0];
+
+  // A transparent diagonal scatterer is not automatically calculated.
+
+  if (chunks[0].sc->get_inc() == chunks[0].sc->get_ext())
+    chunks[0].sc->calcRT();
+
+  // Scatterers to the right of each chunk.
+
+  RightScatterers<DiagScatterer> right_sc(chunks);
+
+  // Loop over chunks.
+  
+  for (unsigned int k=0; k<chunks.size(); k++)
+  {
+    DiagScatterer* sc = dynamic_cast<DiagScatterer*>(chunks[k].sc);
+
+    const cVector& R12(sc->get_diag_R12());
+    const cVector& R21(sc->get_diag_R21());
+    const cVector& T12(sc->get_diag_T12());
+    const cVector& T21(sc->get_diag_T21());
+
+    DiagScatterer* right = right_sc.get(k);
+
+    Waveguide* wg = chunks[k].sc->get_ext();
+
+    cMatrix fw_int (N,K,fortranArray); cMatrix bw_int (N,K,fortranArray);
+    cMatrix fw_prop(N,K,fortranArray); cMatrix bw_prop(N,K,fortranArray);
+    
+    for (int i=1; i<=N; i++)
+    {
+      const Complex prop = exp(-I * wg->get_mode(i)->get_kz() * chunks[k].d);
+
+      for (int j=1; j<=K; j++)
+      {
+        // Forward field after interface and propagation.
+
+        fw_int(i,j) = T12(i)*fw0(i,j)
+                    + R21(i)*(bw0(i,j) - R12(i)*fw0(i,j)) / T21(i);
+        
+        fw_prop(i,j) = fw_int(i,j) * prop;
+
+        // Backward field after propagation and interface.
+
+        bw_prop(i,j) = right ? right->get_diag_R12()(i) * fw_prop(i,j) : 0.0;
+        
+        if (inc_right_bw)
+          bw_prop(i,j) += right ? right->get_diag_T21()(i)*(*inc_right_bw)(i,j)
+                                : (*inc_right_bw)(i,j);
+
+        bw_int(i,j) = bw_prop(i,j) * prop;
+      }
+    }
+
+    // Update field vectors.
+
+    fw->push_back(fw_int);  bw->push_back(bw_int);
+    fw->push_back(fw_prop); bw->push_back(bw_prop);
+
+    fw0 = fw_prop;
+    bw0 = bw_prop;
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// S_scheme_fields_S_multi
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void S_scheme_fields_S_multi
+  (const vector<Chunk>& chunks, vector<cMatrix>* fw, vector<cMatrix>* bw,
+   const cMatrix* inc_right_bw)
+{
+  // Check input.
+
+  if ( (fw->size() != 1) || (bw->size() != 1) )
+  {
+    py_error("Error: invalid source fields in S_scheme_fields_S_multi.");
+    exit (-1);
+  }
+
+  // Check type of chunks and call corresponding function.
+
+  for (unsigned int i=0; i<chunks.size(); i++)
+    if (chunks[i].sc->is_mono())
+    {
+      py_error("Error: multiple excitations not supported for MonoStacks.");
+      exit (-1);
+    }
+
+  for (unsigned int i=0; i<chunks.size(); i++) 
+    if (! dynamic_cast<DiagScatterer*>(chunks[i].sc))
+      return calc_S_S_multi(chunks, fw, bw, inc_right_bw);
+
+  return calc_S_S_diag_multi(chunks, fw, bw, inc_right_bw);
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // S_scheme_fields_S
@@ -46,4 +46,23 @@ void S_scheme_fields_S
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Same as S_scheme_fields_S, but for K excitations at once.
+//
+//   fw[0] and bw[0] contain the N x K field before chunk[0], with one
+//   excitation per column. The other elements are added in the same
+//   order as above. 'inc_right_bw' is an optional N x K matrix.
+//
+//   Not available for chunks of MonoScatterers.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void S_scheme_fields_S_multi
+  (const std::vector<Chunk>& chunks,
+   std::vector<cMatrix>* fw, std::vector<cMatrix>* bw,
+   const cMatrix* inc_right_bw=NULL);
+
+
+
 #endif
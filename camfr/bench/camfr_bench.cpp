@@ -0,0 +1,762 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     camfr_bench.cpp
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <Python.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../defs.h"
+#include "../material.h"
+#include "../expression.h"
+#include "../interface.h"
+#include "../icache.h"
+#include "../stack.h"
+#include "../S_scheme.h"
+#include "../math/bessel/bessel.h"
+#include "../math/calculus/fourier/fourier.h"
+#include "../math/calculus/fourier/toeplitz.h"
+#include "../primitives/slab/generalslab.h"
+#include "../primitives/section/section.h"
+#include "../primitives/circ/circ.h"
+
+using std::vector;
+using std::string;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Benchmark suite for the hot paths of CAMFR.
+//
+//   camfr_bench [-o results.json] [-b baseline.json] [-t tolerance]
+//               [-r min_time] [-j threads] [-f filter]
+//
+//   Each benchmark is repeated until it has run for 'min_time' seconds
+//   (default 0.5) and at least three times. The best time of a single
+//   repetition is reported, as JSON on stdout or in the file given by -o.
+//
+//   With -b, the results are compared to those of an earlier run. Every
+//   benchmark which is more than a fraction 'tolerance' (default 0.1)
+//   slower is flagged, and the exit status is 1. The earlier run must have
+//   used the same number of threads.
+//
+//   -f only runs the benchmarks whose name contains 'filter'.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Settings at startup, restored before each benchmark.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+SolverContext global_defaults;
+SlabGlobal    global_slab_defaults;
+SectionGlobal global_section_defaults;
+CircGlobal    global_circ_defaults;
+
+void reset_globals(int N)
+{
+  global         = global_defaults;
+  global_slab    = global_slab_defaults;
+  global_section = global_section_defaults;
+  global_circ    = global_circ_defaults;
+
+  global.N = N;
+  global.lambda = 1.55;
+  global.polarisation = TE;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Bench
+//
+//   A single benchmark. The constructor does the setup, 'run' does the
+//   work that is timed.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class Bench
+{
+  public:
+
+    virtual ~Bench() {}
+
+    virtual void run() = 0;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Materials and waveguides shared by several benchmarks.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Material air (1.0);
+Material SiO2(1.45);
+Material GaAs(3.5);
+
+Expression slab_expression(Material& core, Real d_core, Material& clad)
+{
+  Expression e;
+
+  e.add_term(Term(clad(1.0)));
+  e.add_term(Term(core(d_core)));
+  e.add_term(Term(clad(1.0)));
+
+  return e;
+}
+
+// A stack of 'layers' alternating layers of two slab waveguides.
+
+class SlabStack
+{
+  public:
+
+    SlabStack(int layers)
+      : wg_a(slab_expression(GaAs, 0.2, air)),
+        wg_b(slab_expression(GaAs, 0.4, air))
+    {
+      e.add_term(Term(wg_a(0.0)));
+      for (int i=0; i<layers; i++)
+        e.add_term(Term((i%2) ? wg_a(0.3) : wg_b(0.2)));
+      e.add_term(Term(wg_a(0.0)));
+    }
+
+    Slab wg_a, wg_b;
+    Expression e;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: S_scheme_bench
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class S_scheme_bench : public Bench
+{
+  public:
+
+    S_scheme_bench(int layers) : slabs(layers), stack(slabs.e)
+      {stack.calcRT();}
+
+    void run() {S_scheme(*stack.get_chunks(), &result);}
+
+  protected:
+
+    SlabStack slabs;
+    DenseStack stack;
+    DenseStack result;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Interface_bench
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class BenchInterface : public DenseInterface
+{
+  public:
+
+    BenchInterface(Waveguide& inc, Waveguide& ext)
+      : DenseInterface(inc, ext) {}
+
+    void calcRT_fast() {DenseInterface::calcRT_fast();}
+};
+
+class Interface_bench : public Bench
+{
+  public:
+
+    Interface_bench() : slabs(0), interface(slabs.wg_a, slabs.wg_b)
+      {interface.calcRT();}
+
+    void run() {interface.calcRT_fast();}
+
+  protected:
+
+    SlabStack slabs;
+    BenchInterface interface;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Slab_bench
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class Slab_bench : public Bench
+{
+  public:
+
+    Slab_bench(Solver solver) : slab(slab_expression(GaAs, 0.2, air))
+      {global.solver = solver; global.always_recalculate = true;}
+
+    void run() {slab.find_modes();}
+
+  protected:
+
+    Slab slab;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Section_bench
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class Section_bench : public Bench
+{
+  public:
+
+    Section_bench(Section_solver solver)
+      : core(slab_expression(GaAs, 0.2, SiO2)), clad(Term(SiO2(2.2)))
+    {
+      global_section.section_solver = solver;
+
+      e.add_term(Term(core(0.5)));
+      e.add_term(Term(clad(1.0)));
+
+      section = new Section(e, 20, 20);
+
+      global.always_recalculate = true;
+    }
+
+    ~Section_bench() {delete section;}
+
+    void run() {section->find_modes();}
+
+  protected:
+
+    Slab core, clad;
+    Expression e;
+    Section* section;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Circ_bench
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class Circ_bench : public Bench
+{
+  public:
+
+    Circ_bench() : circ(0.5, GaAs, 2.0, air)
+      {global_circ.order = 1; global.always_recalculate = true;}
+
+    void run() {circ.find_modes();}
+
+  protected:
+
+    Circ_2 circ;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Fourier_bench, Fourier_2D_bench, FFT_2D_bench
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class Fourier_bench : public Bench
+{
+  public:
+
+    Fourier_bench(int M_) : M(M_)
+    {
+      for (int i=0; i<=10; i++)
+        disc.push_back(i*0.1);
+      for (int i=0; i<10; i++)
+        f.push_back((i%2) ? 1.0 : 12.25);
+    }
+
+    void run() {fourier(f, disc, M);}
+
+  protected:
+
+    int M;
+    vector<Complex> f, disc;
+};
+
+class Fourier_2D_bench : public Bench
+{
+  public:
+
+    Fourier_2D_bench(int M_) : M(M_)
+    {
+      for (int i=0; i<=10; i++)
+        disc_x.push_back(i*0.1);
+
+      for (int i=0; i<10; i++)
+      {
+        vector<Complex> y, eps;
+        for (int j=0; j<=10; j++)
+          y.push_back(j*0.1);
+        for (int j=0; j<10; j++)
+          eps.push_back(((i+j)%2) ? 1.0 : 12.25);
+
+        disc_y.push_back(y);
+        f.push_back(eps);
+      }
+    }
+
+    void run() {fourier_2D(disc_x, disc_y, f, M, M);}
+
+  protected:
+
+    int M;
+    vector<Complex> disc_x;
+    vector<vector<Complex> > disc_y, f;
+};
+
+class FFT_2D_bench : public Bench
+{
+  public:
+
+    FFT_2D_bench(int n_) : n(n_), a(n_*n_)
+    {
+      for (int i=0; i<n*n; i++)
+        a[i] = Complex(i%7, i%3);
+    }
+
+    void run() {fft_2D(a, n, n); fft_2D(a, n, n, true);}
+
+  protected:
+
+    int n;
+    vector<Complex> a;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Bessel_bench
+//
+//   Same kernels and grid as math/bessel/bench.cpp.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class Bessel_bench : public Bench
+{
+  public:
+
+    void run()
+    {
+      for (int i=1; i<=100; i++)
+        for (int j=1; j<=100; j++)
+        {
+          const Complex z(0.1*i, 0.1*j);
+
+          dJ (1, z);
+          dY (1, z);
+          dH1(1, z);
+          dH2(1, z);
+        }
+    }
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Field_bench
+//
+//   Field map on a grid of points, either point by point with field,
+//   or with field_grid.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class Field_bench : public Bench
+{
+  public:
+
+    Field_bench(bool grid_) : grid(grid_), slabs(10), stack(slabs.e)
+    {
+      stack.calcRT();
+
+      cVector inc(global.N, fortranArray);
+      inc = 0.0;
+      inc(1) = 1.0;
+      stack.set_inc_field(inc);
+
+      const Real width = real(slabs.wg_a.c1_size());
+      const Real length = real(stack.get_total_thickness());
+
+      for (int i=0; i<40; i++)
+      {
+        x.push_back((i+0.5) * width  / 40.0);
+        z.push_back((i+0.5) * length / 40.0);
+      }
+    }
+
+    void run()
+    {
+      if (grid)
+      {
+        cHyperM result;
+        stack.field_grid(x, z, &result);
+        return;
+      }
+
+      for (unsigned int k=0; k<z.size(); k++)
+        for (unsigned int i=0; i<x.size(); i++)
+          stack.field(Coord(x[i], 0.0, z[k]));
+    }
+
+  protected:
+
+    bool grid;
+    SlabStack slabs;
+    Stack stack;
+    vector<Complex> x, z;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// STRUCT: BenchEntry
+//
+/////////////////////////////////////////////////////////////////////////////
+
+struct BenchEntry
+{
+    BenchEntry(const string& name_, int N_, std::function<Bench*()> create_)
+      : name(name_), N(N_), create(create_) {}
+
+    string name;
+    int N;
+    std::function<Bench*()> create;
+};
+
+vector<BenchEntry> all_benchmarks()
+{
+  vector<BenchEntry> b;
+
+  const int N_values[] = {20, 40, 80};
+  const int layer_values[] = {10, 100};
+
+  for (int i=0; i<3; i++)
+    for (int j=0; j<2; j++)
+    {
+      const int layers = layer_values[j];
+      std::ostringstream name;
+      name << "S_scheme/N=" << N_values[i] << "/layers=" << layers;
+      b.push_back(BenchEntry(name.str(), N_values[i],
+                  [=]() -> Bench* {return new S_scheme_bench(layers);}));
+    }
+
+  for (int i=0; i<3; i++)
+  {
+    std::ostringstream name;
+    name << "DenseInterface::calcRT_fast/N=" << N_values[i];
+    b.push_back(BenchEntry(name.str(), N_values[i],
+                [=]() -> Bench* {return new Interface_bench();}));
+  }
+
+  const Solver solvers[] = {ADR, track, series, ASR, stretched_ASR};
+  const char* solver_names[] = {"ADR","track","series","ASR","stretched_ASR"};
+
+  for (int i=0; i<5; i++)
+  {
+    const Solver solver = solvers[i];
+    b.push_back(BenchEntry(string("Slab_M::find_modes/") + solver_names[i],
+                40, [=]() -> Bench* {return new Slab_bench(solver);}));
+  }
+
+  const Section_solver section_solvers[]
+    = {OS, NT, L, L_anis, ASR_2D, ASR_2D_stretched};
+  const char* section_solver_names[]
+    = {"OS", "NT", "L", "L_anis", "ASR_2D", "ASR_2D_stretched"};
+
+  for (int i=0; i<6; i++)
+  {
+    const Section_solver solver = section_solvers[i];
+    b.push_back(BenchEntry(string("Section2D::find_modes/")
+                           + section_solver_names[i], 4,
+                [=]() -> Bench* {return new Section_bench(solver);}));
+  }
+
+  b.push_back(BenchEntry("Circ_2::find_modes", 20,
+              []() -> Bench* {return new Circ_bench();}));
+
+  b.push_back(BenchEntry("fourier/M=200", 1,
+              []() -> Bench* {return new Fourier_bench(200);}));
+  b.push_back(BenchEntry("fourier_2D/M=10", 1,
+              []() -> Bench* {return new Fourier_2D_bench(10);}));
+  b.push_back(BenchEntry("fft_2D/n=128", 1,
+              []() -> Bench* {return new FFT_2D_bench(128);}));
+
+  b.push_back(BenchEntry("bessel/dJ_dY_dH1_dH2", 1,
+              []() -> Bench* {return new Bessel_bench();}));
+
+  b.push_back(BenchEntry("Stack::field/40x40", 20,
+              []() -> Bench* {return new Field_bench(false);}));
+  b.push_back(BenchEntry("Stack::field_grid/40x40", 20,
+              []() -> Bench* {return new Field_bench(true);}));
+
+  return b;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// time_bench
+//
+//   Returns the best time of a single repetition in seconds.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Real time_bench(Bench* bench, Real min_time, int* repetitions)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  Real best = 0.0, total = 0.0;
+  *repetitions = 0;
+
+  while (    ((total < min_time) || (*repetitions < 3))
+          && (*repetitions < 100000) )
+  {
+    const Clock::time_point start = Clock::now();
+    bench->run();
+    const Real t = std::chrono::duration<Real>(Clock::now() - start).count();
+
+    if ( (*repetitions == 0) || (t < best) )
+      best = t;
+
+    total += t;
+    (*repetitions)++;
+  }
+
+  return best;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// read_results
+//
+//   Reads the times and the number of threads from an earlier output
+//   file. Only understands the format written by this program, with one
+//   result per line.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool read_results(const string& filename, std::map<string, Real>* results,
+                  int* threads)
+{
+  std::ifstream file(filename.c_str());
+
+  if (!file)
+    return false;
+
+  const string name_tag    = "\"name\": \"";
+  const string seconds_tag = "\"seconds\": ";
+  const string threads_tag = "\"threads\": ";
+
+  *threads = 0;
+
+  string line;
+  while (std::getline(file, line))
+  {
+    const string::size_type j = line.find(threads_tag);
+    if (j != string::npos)
+      *threads = atoi(line.c_str() + j + threads_tag.size());
+
+    const string::size_type n = line.find(name_tag);
+    const string::size_type s = line.find(seconds_tag);
+
+    if ( (n == string::npos) || (s == string::npos) )
+      continue;
+
+    const string::size_type start = n + name_tag.size();
+    const string name = line.substr(start, line.find('"', start) - start);
+
+    (*results)[name] = atof(line.c_str() + s + seconds_tag.size());
+  }
+
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// main
+//
+/////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+  string output, baseline, filter;
+  Real tolerance = 0.1;
+  Real min_time = 0.5;
+  int threads = 1;
+
+  const string usage = "Usage: camfr_bench [-o results.json] "
+    "[-b baseline.json] [-t tolerance] [-r min_time] [-j threads] [-f filter]";
+
+  for (int i=1; i<argc; i++)
+  {
+    const string arg(argv[i]);
+
+    if (    (arg.size() != 2) || (arg[0] != '-')
+         || (string("obftrj").find(arg[1]) == string::npos) || (i+1 == argc) )
+    {
+      std::cerr << usage << std::endl;
+      return 2;
+    }
+
+    const char* value = argv[++i];
+
+    switch (arg[1])
+    {
+      case 'o': output    = value;       break;
+      case 'b': baseline  = value;       break;
+      case 'f': filter    = value;       break;
+      case 't': tolerance = atof(value); break;
+      case 'r': min_time  = atof(value); break;
+      case 'j': threads   = atoi(value); break;
+    }
+  }
+
+  std::map<string, Real> base;
+  int base_threads;
+  if (!baseline.empty() && !read_results(baseline, &base, &base_threads))
+  {
+    std::cerr << "Error: could not read " << baseline << std::endl;
+    return 2;
+  }
+
+  // Times for a different number of threads are not comparable.
+
+  if (!baseline.empty() && (base_threads != threads))
+  {
+    std::cerr << "Error: " << baseline << " was run with " << base_threads
+              << " threads instead of " << threads << "." << std::endl;
+    return 2;
+  }
+
+  // The print functions go through the Python interpreter.
+
+  Py_Initialize();
+
+  global.threads = threads;
+
+  global_defaults         = global;
+  global_slab_defaults    = global_slab;
+  global_section_defaults = global_section;
+  global_circ_defaults    = global_circ;
+
+  // Run the benchmarks.
+
+  std::ostringstream json;
+  json.precision(6);
+
+  json << "{" << std::endl
+       << "  \"threads\": " << threads << "," << std::endl
+       << "  \"min_time\": " << min_time << "," << std::endl
+       << "  \"results\": [" << std::endl;
+
+  const vector<BenchEntry> benchmarks = all_benchmarks();
+
+  bool first = true;
+  int slowdowns = 0;
+
+  for (unsigned int i=0; i<benchmarks.size(); i++)
+  {
+    const BenchEntry& b = benchmarks[i];
+
+    if (!filter.empty() && (b.name.find(filter) == string::npos))
+      continue;
+
+    reset_globals(b.N);
+
+    Bench* bench = b.create();
+    int repetitions;
+    const Real t = time_bench(bench, min_time, &repetitions);
+    delete bench;
+
+    interface_cache.clear();
+
+    json << (first ? "" : ",\n") << "    {\"name\": \"" << b.name << "\", "
+         << "\"N\": " << b.N << ", "
+         << "\"seconds\": " << std::scientific << t << ", "
+         << "\"repetitions\": " << repetitions;
+
+    std::cerr << b.name << ": " << t << " s";
+
+    std::map<string, Real>::const_iterator it = base.find(b.name);
+    if (it != base.end())
+    {
+      const Real ratio = t / it->second;
+      const bool slower = (ratio > 1.0 + tolerance);
+
+      json << ", \"baseline\": " << it->second
+           << ", \"ratio\": " << std::fixed << ratio
+           << ", \"slowdown\": " << (slower ? "true" : "false");
+
+      std::cerr << " (" << ratio << " x baseline)";
+
+      if (slower)
+      {
+        std::cerr << " SLOWDOWN";
+        slowdowns++;
+      }
+    }
+
+    json << "}";
+    std::cerr << std::endl;
+
+    first = false;
+  }
+
+  json << std::endl << "  ]," << std::endl
+       << "  \"slowdowns\": " << slowdowns << std::endl
+       << "}" << std::endl;
+
+  // Write results.
+
+  if (output.empty())
+    std::cout << json.str();
+  else
+  {
+    std::ofstream file(output.c_str());
+    file << json.str();
+  }
+
+  Py_Finalize();
+
+  return (slowdowns > 0) ? 1 : 0;
+}
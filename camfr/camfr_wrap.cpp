@@ -10,6 +10,8 @@
 //
 /////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <type_traits>
 #include <boost/python.hpp>
 #include "numpy/core/include/numpy/arrayobject.h"
 
@@ -27,7 +29,9 @@
 #include "cavity.h"
 #include "bloch.h"
 #include "icache.h"
+#include "diskcache.h"
 #include "infstack.h"
+#include "sweep.h"
 #include "primitives/planar/planar.h"
 #include "primitives/circ/circ.h"
 #include "primitives/slab/generalslab.h"
@@ -280,6 +284,61 @@ inline void set_always_dense(bool b)
 inline void set_mueller_precision(Real d)
   {global.mueller_precision = d;}
 
+inline void set_threads(int n)
+  {global.threads = (n < 1) ? 1 : n;}
+
+inline int get_threads()
+  {return global.threads;}
+
+inline void set_n_eff_target(const Complex& n_eff)
+  {global.n_eff_target = n_eff;}
+
+inline Complex get_n_eff_target()
+  {return global.n_eff_target;}
+
+inline void set_incremental_stacks(bool b)
+  {global.incremental_stacks = b;}
+
+inline void set_interface_cache_budget(Real bytes)
+  {interface_cache.set_budget(bytes < 0 ? 0 : std::size_t(bytes));}
+
+inline Real get_interface_cache_budget()
+  {return interface_cache.get_budget();}
+
+inline void reset_interface_cache_stats()
+  {interface_cache.reset_stats();}
+
+inline bool open_disk_cache(const std::string& filename)
+  {return disk_cache.open(filename);}
+
+inline void close_disk_cache()
+  {disk_cache.close();}
+
+boost::python::dict disk_cache_stats()
+{
+  boost::python::dict stats;
+
+  stats["hits"]    = disk_cache.get_hits();
+  stats["misses"]  = disk_cache.get_misses();
+  stats["records"] = disk_cache.get_records();
+
+  return stats;
+}
+
+boost::python::dict interface_cache_stats()
+{
+  boost::python::dict stats;
+
+  stats["hits"]      = interface_cache.get_hits();
+  stats["misses"]    = interface_cache.get_misses();
+  stats["evictions"] = interface_cache.get_evictions();
+  stats["entries"]   = interface_cache.get_entries();
+  stats["bytes"]     = Real(interface_cache.get_bytes());
+  stats["budget"]    = Real(interface_cache.get_budget());
+
+  return stats;
+}
+
 inline void set_fourier_orders(int Mx, int My=0)
 {
   global_blochsection.Mx = Mx;
@@ -348,6 +407,8 @@ inline boost::python::object stack_fw_bw_2(Stack& s, Real z, Limit l)
 
 inline Real stack_length(Stack& s) 
   {return real(s.get_total_thickness());}
+inline void stack_set_thickness(Stack& s, int k, Real d)
+  {s.set_thickness(k, d);}
 inline Real stack_width(Stack& s) 
   {return real(s.get_inc()->c1_size());}
 
@@ -362,20 +423,82 @@ inline void free_tmp_interfaces(Waveguide& w)
 //
 /////////////////////////////////////////////////////////////////////////////
 
-struct cVector_to_python
+/////////////////////////////////////////////////////////////////////////////
+//
+// cVectors and cMatrices are returned as copies, so that a later
+// calculation cannot change the arrays already handed out.
+//
+// The explicitly named view accessors, e.g. Stack.R12_view(), return
+// read-only views sharing the blitz storage instead. Such a view keeps the
+// storage and its Python owner alive, but a later calculation on the owner
+// can overwrite it.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+template <int N>
+void delete_blitz_array(PyObject* capsule)
 {
-  static PyObject* convert(const cVector& c)
-  {    
-    int dim[1]; dim[0] = c.rows();
+  delete (blitz::Array<Complex,N>*) PyCapsule_GetPointer(capsule, NULL);
+}
+
+template <int N>
+PyObject* blitz_to_python_view(const blitz::Array<Complex,N>& c, int nd,
+                               npy_intp* dim, npy_intp* strides,
+                               bool writeable=false, PyObject* owner=NULL)
+{
+  if (c.numElements() == 0)
+    return PyArray_New(&PyArray_Type, nd, dim, PyArray_CDOUBLE,
+                       NULL, NULL, 0, 0, NULL);
+
+  PyArrayObject* result = (PyArrayObject*)
+    PyArray_New(&PyArray_Type, nd, dim, PyArray_CDOUBLE, strides,
+                (void*) c.data(), 0,
+                writeable ? NPY_ALIGNED|NPY_WRITEABLE : NPY_ALIGNED, NULL);
 
-    PyArrayObject* result 
-      = (PyArrayObject*) PyArray_FromDims(1, dim, PyArray_CDOUBLE);
+  // The copy constructor makes the new array refer to the same storage.
 
-    for (int i=0; i<c.rows(); i++)
-        *(Complex*)(result->data + i*result->strides[0]) = c(i+1);
+  PyObject* storage = PyCapsule_New(new blitz::Array<Complex,N>(c), NULL,
+                                    delete_blitz_array<N>);
 
-    return PyArray_Return(result);
+  result->base = owner ? Py_BuildValue("(NO)", storage, owner) : storage;
+
+  return (PyObject*) result;
+}
+
+template <int N>
+PyObject* blitz_to_python_view(const blitz::Array<Complex,N>& c,
+                               bool writeable=false, PyObject* owner=NULL)
+{
+  npy_intp dim[N], strides[N];
+  for (int i=0; i<N; i++)
+  {
+    dim[i]     = c.extent(i);
+    strides[i] = c.stride(i) * sizeof(Complex);
   }
+
+  return blitz_to_python_view(c, N, dim, strides, writeable, owner);
+}
+
+template <int N>
+PyObject* blitz_to_python_copy(const blitz::Array<Complex,N>& c)
+{
+  PyArrayObject* view = (PyArrayObject*) blitz_to_python_view(c);
+  PyObject* result = PyArray_NewCopy(view, NPY_CORDER);
+  Py_DECREF(view);
+
+  return result;
+}
+
+struct cVector_to_python
+{
+  static PyObject* convert(const cVector& c)
+    {return blitz_to_python_copy(c);}
+};
+
+struct cMatrix_to_python
+{
+  static PyObject* convert(const cMatrix& c)
+    {return blitz_to_python_copy(c);}
 };
 
 struct register_cVector_from_python
@@ -408,13 +531,14 @@ struct register_cVector_from_python
       boost::python::converter::rvalue_from_python_storage<cVector>*)data)
         ->storage.bytes;
 
-    new (storage) cVector(global.N, fortranArray);
+    cVector* c = new (storage) cVector(global.N, fortranArray);
+
+    // The C++ side can hold on to the vector, so it gets its own storage.
 
     PyArrayObject* a = (PyArrayObject *)
       PyArray_ContiguousFromObject(o, PyArray_CDOUBLE, 1, 1);
 
-    for (int i=0; i<global.N; i++)      
-      (*(cVector*)(storage))(i+1) = *(Complex*)(a->data + i*a->strides[0]);
+    std::copy((Complex*) a->data, (Complex*) a->data + global.N, c->data());
     
     Py_DECREF(a);
 
@@ -423,23 +547,483 @@ struct register_cVector_from_python
 
 };
 
-struct cMatrix_to_python
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Returns a blitz view of a caller-provided array 'out', so that results
+// can be written into it directly. 'out' should be a writeable, aligned
+// complex array of the given shape, in any memory layout. Anything else
+// raises a ValueError, rather than being broadcast or converted.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+template <int N>
+blitz::Array<Complex,N> python_to_blitz_view
+  (boost::python::object out, const blitz::TinyVector<int,N>& shape)
 {
-  static PyObject* convert(const cMatrix& c)
+  PyArrayObject* o = (PyArrayObject*) out.ptr();
+
+  if (    !PyArray_Check(out.ptr())
+       || (PyArray_TYPE(o) != PyArray_CDOUBLE)
+       || !PyArray_ISWRITEABLE(o)
+       || !PyArray_ISALIGNED(o) )
   {
-    int dim[2]; dim[0] = c.rows(); dim[1] = c.columns();
+    PyErr_SetString(PyExc_ValueError,
+      "output should be a writeable, aligned complex array.");
+    boost::python::throw_error_already_set();
+  }
+
+  bool same_shape = (PyArray_NDIM(o) == N);
+  for (int i=0; same_shape && (i<N); i++)
+    if (PyArray_DIM(o,i) != shape(i))
+      same_shape = false;
+
+  if (!same_shape)
+  {
+    PyErr_SetString(PyExc_ValueError, "output array has the wrong shape.");
+    boost::python::throw_error_already_set();
+  }
+
+  // The stride type differs between blitz versions.
+
+  typedef blitz::Array<Complex,N> Array;
+  typename std::decay<decltype(Array().stride())>::type strides;
+
+  const npy_intp size = sizeof(Complex);
+  for (int i=0; i<N; i++)
+  {
+    if (PyArray_STRIDE(o,i) % size)
+    {
+      PyErr_SetString(PyExc_ValueError,
+        "output array strides are not a multiple of the element size.");
+      boost::python::throw_error_already_set();
+    }
+
+    strides(i) = PyArray_STRIDE(o,i) / size;
+  }
+
+  return Array((Complex*) PyArray_DATA(o), shape, strides,
+               blitz::neverDeleteData, blitz::FortranArray<N>());
+}
+
+inline void copy_to_python(const cMatrix& c, boost::python::object out)
+{
+  cMatrix o(python_to_blitz_view(out, c.shape()));
+  o = c;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Wavelength sweeps.
+//
+//   Returns a tuple (R12, T12) of arrays indexed by (lambda, i, j), or by
+//   (lambda, element) if specific elements were requested.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+PyObject* sweep_to_python(const cMatrix& c, bool full)
+{
+  // The results are not shared with anything else, so they can be
+  // returned as a writeable view.
+
+  if (!full)
+    return blitz_to_python_view(c, true);
+
+  const int N = int(sqrt(Real(c.columns())) + 0.5);
+
+  npy_intp dim[3]; dim[0] = c.rows(); dim[1] = N; dim[2] = N;
+
+  npy_intp strides[3];
+  strides[0] =     c.stride(0) * sizeof(Complex);
+  strides[1] = N * c.stride(1) * sizeof(Complex);
+  strides[2] =     c.stride(1) * sizeof(Complex);
+
+  return blitz_to_python_view(c, 3, dim, strides, true);
+}
+
+void sweep_arguments
+  (boost::python::object s, boost::python::object l, boost::python::object e,
+   std::vector<Stack*>* stacks, std::vector<Complex>* lambdas,
+   std::vector<Element>* elements)
+{
+  using namespace boost::python;
+
+  extract<Stack&> single(s);
+  if (single.check())
+    stacks->push_back(&single());
+  else
+    for (int i=0; i<len(s); i++)
+      stacks->push_back(&extract<Stack&>(s[i])());
+
+  for (int i=0; i<len(l); i++)
+    lambdas->push_back(extract<Complex>(l[i]));
+
+  for (int i=0; i<len(e); i++)
+    elements->push_back(Element(extract<int>(e[i][0]) + 1,
+                                extract<int>(e[i][1]) + 1));
   
-    PyArrayObject* result 
-      = (PyArrayObject*) PyArray_FromDims(2, dim, PyArray_CDOUBLE);
-    
-    for (int i=0; i<c.rows(); i++)
-      for (int j=0; j<c.columns(); j++)
-        *(Complex*)(result->data + i*result->strides[0] + j*result->strides[1])
-          = c(i+1,j+1);
+  const std::string error = check_sweep(*stacks, *elements);
+  if (!error.empty())
+  {
+    PyErr_SetString(PyExc_ValueError, error.c_str());
+    throw_error_already_set();
+  }
+}
+
+void run_sweep(const std::vector<Stack*>& stacks,
+               const std::vector<Complex>& lambdas,
+               const std::vector<Element>& elements, cMatrix* R12, cMatrix* T12)
+{
+  // Release the interpreter lock, so that the workers can print warnings.
+
+  Py_BEGIN_ALLOW_THREADS
+  sweep_lambda(stacks, lambdas, elements, R12, T12);
+  Py_END_ALLOW_THREADS
+}
+
+boost::python::object stack_sweep_lambda
+  (boost::python::object s, boost::python::object l, boost::python::object e)
+{
+  using namespace boost::python;
+
+  std::vector<Stack*> stacks;
+  std::vector<Complex> lambdas;
+  std::vector<Element> elements;
+  sweep_arguments(s, l, e, &stacks, &lambdas, &elements);
+
+  cMatrix R12(fortranArray), T12(fortranArray);
+  run_sweep(stacks, lambdas, elements, &R12, &T12);
+
+  const bool full = elements.empty();
+
+  return make_tuple(object(handle<>(sweep_to_python(R12, full))),
+                    object(handle<>(sweep_to_python(T12, full))));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Sweeps into caller-provided arrays.
+//
+//   The results are written straight into views of the arrays. For a full
+//   sweep, the (i, j) axes of an array are combined into one element axis,
+//   ordered as they are stored. Arrays where that is not possible, or
+//   where R12_out and T12_out disagree on the order, are filled through a
+//   temporary.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+// Sets 'm' to a (lambda, element) view of 'a', with j running fastest
+// if 'j_fastest' is true and i otherwise. Returns false if the strides
+// of 'a' don't allow this.
+
+bool flatten(const blitz::Array<Complex,3>& a, bool j_fastest, cMatrix* m)
+{
+  const int N     = a.extent(1);
+  const int inner = j_fastest ? 2 : 1;
+  const int outer = j_fastest ? 1 : 2;
+
+  if ((N > 1) && (a.stride(outer) != N*a.stride(inner)))
+    return false;
+
+  const blitz::TinyVector<int,2> shape(a.extent(0), N*N);
+  std::decay<decltype(m->stride())>::type strides;
+  strides(0) = a.stride(0);
+  strides(1) = a.stride(inner);
 
-    return PyArray_Return(result);
+  m->reference(cMatrix(const_cast<Complex*>(a.data()), shape, strides,
+                       blitz::neverDeleteData, blitz::FortranArray<2>()));
+
+  return true;
+}
+
+void unflatten(const cMatrix& m, bool j_fastest, blitz::Array<Complex,3>* a)
+{
+  const int N = a->extent(1);
+
+  for (int l=1; l<=a->extent(0); l++)
+    for (int i=1; i<=N; i++)
+      for (int j=1; j<=N; j++)
+        (*a)(l,i,j) = m(l, j_fastest ? (i-1)*N+j : (j-1)*N+i);
+}
+
+void stack_sweep_lambda_3
+  (boost::python::object s, boost::python::object l, boost::python::object e,
+   boost::python::object R12_out, boost::python::object T12_out)
+{
+  std::vector<Stack*> stacks;
+  std::vector<Complex> lambdas;
+  std::vector<Element> elements;
+  sweep_arguments(s, l, e, &stacks, &lambdas, &elements);
+
+  const int L = lambdas.size();
+
+  if (!elements.empty())
+  {
+    const blitz::TinyVector<int,2> shape(L, elements.size());
+
+    cMatrix R12(python_to_blitz_view(R12_out, shape));
+    cMatrix T12(python_to_blitz_view(T12_out, shape));
+
+    run_sweep(stacks, lambdas, elements, &R12, &T12);
+
+    return;
   }
-};
+
+  const int N = stacks[0]->as_multi() ? global.N : 1;
+  const blitz::TinyVector<int,3> shape(L, N, N);
+
+  blitz::Array<Complex,3> R3(python_to_blitz_view(R12_out, shape));
+  blitz::Array<Complex,3> T3(python_to_blitz_view(T12_out, shape));
+
+  // Follow the storage order of R12_out, e.g. j fastest for C order and
+  // i fastest for Fortran order.
+
+  const bool j_fastest = (N == 1) || (R3.stride(1) == N*R3.stride(2));
+
+  for (int i=1; i<=N; i++)
+    for (int j=1; j<=N; j++)
+      elements.push_back(j_fastest ? Element(i,j) : Element(j,i));
+
+  cMatrix R12(fortranArray), T12(fortranArray);
+  const bool R_direct = flatten(R3, j_fastest, &R12);
+  const bool T_direct = flatten(T3, j_fastest, &T12);
+
+  run_sweep(stacks, lambdas, elements, &R12, &T12);
+
+  if (!R_direct)
+    unflatten(R12, j_fastest, &R3);
+  if (!T_direct)
+    unflatten(T12, j_fastest, &T3);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Field on a grid.
+//
+//   Returns an array with dimensions (z, x, component).
+//
+/////////////////////////////////////////////////////////////////////////////
+
+boost::python::object stack_field_grid
+  (Stack& s, boost::python::object x, boost::python::object z, Complex y)
+{
+  using namespace boost::python;
+
+  std::vector<Complex> c1;
+  for (int i=0; i<len(x); i++)
+    c1.push_back(extract<Complex>(x[i]));
+
+  std::vector<Complex> z_values;
+  for (int i=0; i<len(z); i++)
+    z_values.push_back(extract<Complex>(z[i]));
+
+  cHyperM field;
+  s.field_grid(c1, z_values, &field, y);
+
+  int dim[3]; dim[0] = z_values.size(); dim[1] = c1.size(); dim[2] = 6;
+  PyArrayObject* result
+    = (PyArrayObject*) PyArray_FromDims(3, dim, PyArray_CDOUBLE);
+
+  for (int k=0; k<dim[0]; k++)
+    for (int i=0; i<dim[1]; i++)
+      for (int c=0; c<6; c++)
+        *(Complex*)(result->data + k*result->strides[0]
+                  + i*result->strides[1] + c*result->strides[2])
+          = field(k,i,c);
+
+  return object(handle<>(PyArray_Return(result)));
+}
+
+inline boost::python::object stack_field_grid_2
+  (Stack& s, boost::python::object x, boost::python::object z)
+    {return stack_field_grid(s, x, z, 0.0);}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Multiple excitations.
+//
+//   The incident fields are the columns of an N x K array. The interface
+//   fields are returned as a tuple (fw, bw) of arrays with dimensions
+//   (position, N, K).
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cMatrix cMatrix_from_python(boost::python::object o)
+{
+  // Fortran order, so that the data can be copied in one go.
+
+  PyArrayObject* a = (PyArrayObject *)
+    PyArray_FromAny(o.ptr(), PyArray_DescrFromType(PyArray_CDOUBLE),
+                    2, 2, NPY_FARRAY, NULL);
+
+  if (!a)
+  {
+    py_error("Error: expected a two-dimensional array.");
+    exit (-1);
+  }
+
+  cMatrix m(a->dimensions[0], a->dimensions[1], fortranArray);
+
+  std::copy((Complex*) a->data, (Complex*) a->data + m.numElements(),
+            m.data());
+
+  Py_DECREF(a);
+
+  return m;
+}
+
+PyObject* cMatrices_to_python(const std::vector<cMatrix>& m)
+{
+  int dim[3]; dim[0] = m.size(); dim[1] = m[0].rows(); dim[2] = m[0].columns();
+
+  PyArrayObject* result
+    = (PyArrayObject*) PyArray_FromDims(3, dim, PyArray_CDOUBLE);
+
+  for (int k=0; k<dim[0]; k++)
+    for (int i=0; i<dim[1]; i++)
+      for (int j=0; j<dim[2]; j++)
+        *(Complex*)(result->data + k*result->strides[0]
+                  + i*result->strides[1] + j*result->strides[2])
+          = m[k](i+1,j+1);
+
+  return PyArray_Return(result);
+}
+
+inline cMatrix stack_refl_fields(Stack& s, boost::python::object inc)
+  {return s.get_refl_fields(cMatrix_from_python(inc));}
+
+inline cMatrix stack_refl_fields_2
+  (Stack& s, boost::python::object inc, boost::python::object inc_bw)
+{
+  cMatrix bw(cMatrix_from_python(inc_bw));
+  return s.get_refl_fields(cMatrix_from_python(inc), &bw);
+}
+
+inline cMatrix stack_trans_fields(Stack& s, boost::python::object inc)
+  {return s.get_trans_fields(cMatrix_from_python(inc));}
+
+inline cMatrix stack_trans_fields_2
+  (Stack& s, boost::python::object inc, boost::python::object inc_bw)
+{
+  cMatrix bw(cMatrix_from_python(inc_bw));
+  return s.get_trans_fields(cMatrix_from_python(inc), &bw);
+}
+
+boost::python::object stack_interface_fields_2
+  (Stack& s, boost::python::object inc, boost::python::object inc_bw)
+{
+  using namespace boost::python;
+
+  cMatrix bw_inc(fortranArray);
+  if (inc_bw.ptr() != Py_None)
+    bw_inc.reference(cMatrix_from_python(inc_bw));
+
+  std::vector<cMatrix> fw, bw;
+  s.get_interface_fields(cMatrix_from_python(inc),
+                         (inc_bw.ptr() != Py_None) ? &bw_inc : NULL,
+                         &fw, &bw);
+
+  return make_tuple(object(handle<>(cMatrices_to_python(fw))),
+                    object(handle<>(cMatrices_to_python(bw))));
+}
+
+inline boost::python::object stack_interface_fields
+  (Stack& s, boost::python::object inc)
+    {return stack_interface_fields_2(s, inc, boost::python::object());}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Mode profiles on a set of transverse coordinates.
+//
+//   Returns an array with dimensions (component, point, mode).
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void waveguide_mode_profiles_2
+  (Waveguide& w, boost::python::object coords, boost::python::object out)
+{
+  using namespace boost::python;
+
+  std::vector<Coord> c;
+  for (int i=0; i<len(coords); i++)
+    c.push_back(extract<Coord>(coords[i]));
+
+  blitz::Array<Complex,3> result
+    (python_to_blitz_view(out, blitz::TinyVector<int,3>(6, c.size(), w.N())));
+
+  ModeProfiles profiles(&w, c);
+
+  for (int k=0; k<6; k++)
+    result(k+1, blitz::Range::all(), blitz::Range::all()) = profiles.table[k];
+}
+
+boost::python::object waveguide_mode_profiles
+  (Waveguide& w, boost::python::object coords)
+{
+  using namespace boost::python;
+
+  npy_intp dim[3]; dim[0] = 6; dim[1] = len(coords); dim[2] = w.N();
+  object result(handle<>(PyArray_SimpleNew(3, dim, PyArray_CDOUBLE)));
+
+  waveguide_mode_profiles_2(w, coords, result);
+
+  return result;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Bulk accessors.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cVector waveguide_kz_values(Waveguide& w)
+{
+  cVector kz(w.N(), fortranArray);
+  for (int i=1; i<=w.N(); i++)
+    kz(i) = w.get_mode(i)->get_kz();
+
+  return kz;
+}
+
+inline void stack_R12_out(const Stack& s, boost::python::object out)
+  {copy_to_python(s.get_R12(), out);}
+inline void stack_R21_out(const Stack& s, boost::python::object out)
+  {copy_to_python(s.get_R21(), out);}
+inline void stack_T12_out(const Stack& s, boost::python::object out)
+  {copy_to_python(s.get_T12(), out);}
+inline void stack_T21_out(const Stack& s, boost::python::object out)
+  {copy_to_python(s.get_T21(), out);}
+
+boost::python::object stack_view
+  (boost::python::object s, const cMatrix (Stack::*get)() const)
+{
+  using namespace boost::python;
+
+  const Stack& stack = extract<const Stack&>(s);
+
+  return object(handle<>(blitz_to_python_view((stack.*get)(), false,
+                                              s.ptr())));
+}
+
+inline boost::python::object stack_R12_view(boost::python::object s)
+  {return stack_view(s, &Stack::get_R12);}
+inline boost::python::object stack_R21_view(boost::python::object s)
+  {return stack_view(s, &Stack::get_R21);}
+inline boost::python::object stack_T12_view(boost::python::object s)
+  {return stack_view(s, &Stack::get_T12);}
+inline boost::python::object stack_T21_view(boost::python::object s)
+  {return stack_view(s, &Stack::get_T21);}
 
 
 
@@ -545,6 +1129,10 @@ void stack_set_inc_field(Stack& s, const cVector& f)
 void stack_set_inc_field_2(Stack& s, const cVector& f, const cVector& b) 
   {s.set_inc_field(f, &const_cast<cVector&>(b));}
 
+boost::python::object stack_sweep_lambda_2
+  (boost::python::object s, boost::python::object l)
+    {return stack_sweep_lambda(s, l, boost::python::list());}
+
 Complex material_epsr(Material& m)
   {return m.epsr();}
 
@@ -804,8 +1392,23 @@ BOOST_PYTHON_MODULE(_camfr)
   def("set_calc_field_profiles",    set_calc_field_profiles);
   def("set_always_dense",           set_always_dense);  
   def("set_mueller_precision",      set_mueller_precision);
+  def("set_threads",                set_threads);
+  def("get_threads",                get_threads);
+  def("set_n_eff_target",           set_n_eff_target);
+  def("get_n_eff_target",           get_n_eff_target);
+  def("set_incremental_stacks",     set_incremental_stacks);
+  def("set_interface_cache_budget", set_interface_cache_budget);
+  def("get_interface_cache_budget", get_interface_cache_budget);
+  def("interface_cache_stats",      interface_cache_stats);
+  def("reset_interface_cache_stats",reset_interface_cache_stats);
+  def("open_disk_cache",            open_disk_cache);
+  def("close_disk_cache",           close_disk_cache);
+  def("disk_cache_stats",           disk_cache_stats);
   def("free_tmps",                  free_tmps);
   def("free_tmp_interfaces",        free_tmp_interfaces);
+  def("sweep_lambda",               stack_sweep_lambda);
+  def("sweep_lambda",               stack_sweep_lambda_2);
+  def("sweep_lambda",               stack_sweep_lambda_3);
 
   // Wrap Coord.
 
@@ -908,6 +1511,9 @@ BOOST_PYTHON_MODULE(_camfr)
     .def("bw_mode",  waveguide_get_bw_mode,
          return_value_policy<reference_existing_object>())
     .def("calc",     &Waveguide::find_modes)
+    .def("mode_profiles", waveguide_mode_profiles)
+    .def("mode_profiles", waveguide_mode_profiles_2)
+    .def("kz_values", waveguide_kz_values)
     .def("__repr__", &Waveguide::repr)
     .def("__call__", waveguide_to_term)
     ;
@@ -1027,6 +1633,7 @@ BOOST_PYTHON_MODULE(_camfr)
     .def("scatterer",                &Stack::as_multi,
          return_value_policy<reference_existing_object>())
     .def("length",                   stack_length)
+    .def("set_thickness",            stack_set_thickness)
     .def("width",                    stack_width)
     .def("set_inc_field",            stack_set_inc_field)
     .def("set_inc_field",            stack_set_inc_field_2)
@@ -1036,9 +1643,17 @@ BOOST_PYTHON_MODULE(_camfr)
     .def("inc_field",                &Stack::get_inc_field)
     .def("refl_field",               &Stack::get_refl_field)
     .def("trans_field",              &Stack::get_trans_field)
+    .def("refl_fields",              stack_refl_fields)
+    .def("refl_fields",              stack_refl_fields_2)
+    .def("trans_fields",             stack_trans_fields)
+    .def("trans_fields",             stack_trans_fields_2)
+    .def("interface_fields",         stack_interface_fields)
+    .def("interface_fields",         stack_interface_fields_2)
     .def("inc_S_flux",               stack_inc_S_flux)
     .def("ext_S_flux",               stack_ext_S_flux)
     .def("field",                    &Stack::field)
+    .def("field_grid",               stack_field_grid)
+    .def("field_grid",               stack_field_grid_2)
     .def("fw_bw",                    stack_fw_bw)
     .def("fw_bw",                    stack_fw_bw_2)
     .def("lateral_S_flux",           stack_lateral_S_flux)
@@ -1054,6 +1669,14 @@ BOOST_PYTHON_MODULE(_camfr)
     .def("R21",                      stack_R21)
     .def("T12",                      stack_T12)
     .def("T21",                      stack_T21)    
+    .def("R12",                      stack_R12_out)
+    .def("R21",                      stack_R21_out)
+    .def("T12",                      stack_T12_out)
+    .def("T21",                      stack_T21_out)
+    .def("R12_view",                 stack_R12_view)
+    .def("R21_view",                 stack_R21_view)
+    .def("T12_view",                 stack_T12_view)
+    .def("T21_view",                 stack_T21_view)
     .def("R12_power",                &Stack::get_R12_power)    
     .def("T12_power",                &Stack::get_T12_power)
     .def(self + Expression())
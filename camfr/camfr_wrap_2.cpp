@@ -20,6 +20,7 @@
 #include "primitives/slab/isoslab/slab.h"
 #include "primitives/slab/isoslab/slabwall.h"
 #include "primitives/slab/isoslab/slabdisp.h"
+#include "primitives/slab/slabgeometry.h"
 #include "primitives/section/section.h"
 #include "primitives/section/sectiondisp.h"
 #include "primitives/section/refsection.h"
@@ -111,6 +112,34 @@ inline Complex blochmode_n(BlochMode& m, Coord &c)
 inline Complex sectionmode_n(SectionMode& m, Coord &c)
   {return m.get_geom()->n_at(c);}
 
+cMatrix blochsection_band_structure
+  (BlochSection& s, boost::python::object k_path, int threads)
+{
+  using namespace boost::python;
+
+  std::vector<Complex> kx0, ky0;
+  for (int i=0; i<len(k_path); i++)
+  {
+    kx0.push_back(extract<Complex>(k_path[i][0]));
+    ky0.push_back(extract<Complex>(k_path[i][1]));
+  }
+
+  cMatrix kz(fortranArray);
+
+  // Release the interpreter lock, so that other Python threads can run
+  // during the solve.
+
+  Py_BEGIN_ALLOW_THREADS
+  s.band_structure(kx0, ky0, &kz, threads);
+  Py_END_ALLOW_THREADS
+
+  return kz;
+}
+
+inline cMatrix blochsection_band_structure_2
+  (BlochSection& s, boost::python::object k_path)
+    {return blochsection_band_structure(s, k_path, global.threads);}
+
 
   
 /////////////////////////////////////////////////////////////////////////////
@@ -127,6 +156,18 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(cav_find_mode, Cavity::find_mode,2,5)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(cav_find_modes, \
   Cavity::find_modes_in_region,3,7)
 
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(cav_find_complex_lambda, \
+  Cavity::find_complex_lambda,1,2)
+
+void cavity_set_bracket_copies(Cavity& c, boost::python::object l)
+{
+  std::vector<Cavity*> copies;
+  for (int i=0; i<boost::python::len(l); i++)
+    copies.push_back(&boost::python::extract<Cavity&>(l[i])());
+
+  c.set_bracket_copies(copies);
+}
+
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -153,6 +194,35 @@ inline cVector slab_expand_plane_wave
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// The following functions are used by SlabGeometry.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void slabgeometry_add_polygon(SlabGeometry& g, boost::python::object xs,
+                              boost::python::object ys, Material& m)
+{
+  std::vector<Real> x, y;
+  for (int i=0; i<boost::python::len(xs); i++)
+    x.push_back(boost::python::extract<Real>(xs[i]));
+  for (int i=0; i<boost::python::len(ys); i++)
+    y.push_back(boost::python::extract<Real>(ys[i]));
+
+  g.add_polygon(x, y, m);
+}
+
+inline Expression slabgeometry_to_expression
+  (SlabGeometry& g, Real x0, Real x1, Real dx, Real y0, Real y1, Real dy)
+{
+  return g.to_expression(x0, x1, dx, y0, y1, dy);
+}
+
+inline unsigned long shared_slabs_size() {return shared_slabs.size();}
+inline unsigned long shared_slabs_hits() {return shared_slabs.get_hits();}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // More exported functions.
@@ -168,6 +238,9 @@ void camfr_wrap_2()
   class_<Cavity>("Cavity", init<Stack&, Stack&>())
     .def("find_mode",      &Cavity::find_mode, cav_find_mode())
     .def("find_all_modes", &Cavity::find_modes_in_region,cav_find_modes())
+    .def("find_complex_lambda", &Cavity::find_complex_lambda,
+         cav_find_complex_lambda())
+    .def("set_bracket_copies",  cavity_set_bracket_copies)
     .def("sigma",          cavity_calc_sigma)
     .def("set_source",     cavity_set_current_source)
     .def("set_source",     cavity_set_general_source)
@@ -287,6 +360,24 @@ void camfr_wrap_2()
     .def("add_kz2_estimate",  &Slab::add_kz2_estimate)
     ;
 
+  // Wrap SlabGeometry.
+
+  class_<SlabGeometry, boost::noncopyable>
+    ("SlabGeometry", init<Material&>())
+    .def("add_circle",      &SlabGeometry::add_circle)
+    .def("add_rectangle",   &SlabGeometry::add_rectangle)
+    .def("add_triangle",    &SlabGeometry::add_triangle)
+    .def("add_polygon",     slabgeometry_add_polygon)
+    .def("to_expression",   &SlabGeometry::to_expression)
+    .def("to_expression",   slabgeometry_to_expression)
+    .def("eps_average",     &SlabGeometry::get_eps_average)
+    .def("inv_eps_average", &SlabGeometry::get_inv_eps_average)
+    .def("__len__",         &SlabGeometry::size)
+    ;
+
+  def("shared_slabs",      shared_slabs_size);
+  def("shared_slabs_hits", shared_slabs_hits);
+
   // Wrap SectionDisp.
 
   class_<SectionDisp, bases<ComplexFunction> >
@@ -308,6 +399,8 @@ void camfr_wrap_2()
     .def("n",            &Section::n_at)
     .def("set_sorting",  &Section::set_sorting)
     .def("set_estimate", &Section::set_estimate)
+    .def("set_symmetry", &Section::set_symmetry)
+    .def("symmetry_block_size", &Section::symmetry_block_size)
     ;
 
   // Wrap RefSection.
@@ -340,6 +433,8 @@ void camfr_wrap_2()
     .def("set_kx0_ky0",   &BlochSection::set_kx0_ky0)    
     .def("get_kx0",       &BlochSection::get_kx0)    
     .def("get_ky0",       &BlochSection::get_ky0)
+    .def("band_structure", blochsection_band_structure)
+    .def("band_structure", blochsection_band_structure_2)
     ;
 
   // Wrap BlochSectionMode.
@@ -10,10 +10,16 @@
 //
 ////////////////////////////////////////////////////////////////////////////
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <sstream>
 #include <vector>
 #include "cavity.h"
+#include "context.h"
 #include "math/calculus/minimum/minimum.h"
+#include "math/calculus/croot/mueller.h"
 
 using std::vector;
 
@@ -34,6 +40,64 @@ Real Sigma_lambda::operator()(const Real& lambda)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Sigma_lambda::evaluate
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void Sigma_lambda::evaluate(const Real* lambda, Real* result, int n)
+{
+  const vector<Cavity*>& copies = cavity->get_bracket_copies();
+
+  if (copies.empty())
+  {
+    Function1D<Real>::evaluate(lambda, result, n);
+    return;
+  }
+
+  counter += n;
+
+  // The calling thread works on the cavity itself, the others on the
+  // copies. Each gets a contiguous range of wavelengths, such that the
+  // singular vector of its previous wavelength is a good starting point
+  // for the next one. The diagnostics are printed afterwards, in order.
+
+  vector<std::string> diagnostics(n);
+
+  const ThreadContext context = get_thread_context();
+
+  #pragma omp parallel num_threads(copies.size()+1)
+  {
+    ContextSwitch context_switch(context);
+
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+
+    Cavity* c = (thread == 0) ? cavity : copies[thread-1];
+
+    #pragma omp for schedule(static)
+    for (int i=0; i<n; i++)
+    {
+      global.lambda = lambda[i];
+      result[i] = c->calc_sigma(NULL, &diagnostics[i]);
+    }
+
+    // Interfaces created by the workers are keyed on waveguides which
+    // they cannot see being destroyed.
+
+    if (thread != 0)
+      clear_thread_caches();
+  }
+
+  for (int i=0; i<n; i++)
+    py_print(diagnostics[i]);
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Sigma_n_imag::operator()
@@ -51,6 +115,23 @@ Real Sigma_n_imag::operator()(const Real& n_imag)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Det_lambda::operator()
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+Complex Det_lambda::operator()(const Complex& lambda)
+{
+  counter++;
+  
+  global.lambda = lambda;
+  
+  return determinant(cavity->cavity_matrix());
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Cavity::Cavity
@@ -59,7 +140,8 @@ Real Sigma_n_imag::operator()(const Real& n_imag)
 
 Cavity::Cavity(Stack& bot_, Stack& top_)
   : bot(&bot_), top(&top_),
-    sigma_lambda(this), sigma_n_imag(this)
+    sigma_lambda(this), sigma_n_imag(this), det_lambda(this),
+    v_min(fortranArray)
 {
   if (!(    dynamic_cast<MultiScatterer*>(top->get_sc())
          && dynamic_cast<MultiScatterer*>(bot->get_sc()) ))
@@ -209,11 +291,41 @@ void Cavity::find_mode(Real lambda_start, Real lambda_stop,
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// Cavity::calc_sigma
+// Cavity::find_complex_lambda
 //  
 /////////////////////////////////////////////////////////////////////////////
 
-Real Cavity::calc_sigma(int* dominant_mode)
+Complex Cavity::find_complex_lambda(const Complex& lambda, Real eps)
+{
+  bool error = false;
+
+  Complex lambda_c = mueller(det_lambda, lambda, lambda*(1.0+1e-4), eps,
+                             0, 100, &error);
+
+  if (error)
+    py_print("Warning: complex wavelength refinement did not converge.");
+
+  // Calculate cavity field at resonance.
+
+  global.lambda = lambda_c;
+  calc_sigma();
+
+  std::ostringstream s;
+  s << "Complex lambda " << lambda_c;
+  py_print(s.str());
+
+  return lambda_c;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Cavity::cavity_matrix
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+cMatrix Cavity::cavity_matrix()
 {
   int N = global.N;
   
@@ -222,7 +334,7 @@ Real Cavity::calc_sigma(int* dominant_mode)
   top->calcRT();
   bot->calcRT();
   
-  // Do SVD of cavity matrix Q = R_top.R_bot - U1
+  // Q = R_top.R_bot - U1
   
   cMatrix Q(N, N, fortranArray);
   Q.reference(multiply(top->as_multi()->get_R12(),
@@ -230,9 +342,43 @@ Real Cavity::calc_sigma(int* dominant_mode)
   for (int i=1; i<=N; i++)
     Q(i,i) -= 1.0;
 
-  cMatrix Vh(N, N, fortranArray);
-  rVector sigma(N, fortranArray);
-  sigma.reference(svd(Q, &Vh));
+  return Q;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Cavity::calc_sigma
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+Real Cavity::calc_sigma(int* dominant_mode, std::string* diagnostics)
+{
+  int N = global.N;
+  
+  cMatrix Q(N, N, fortranArray);
+  Q.reference(cavity_matrix());
+
+  // Track the smallest singular value by inverse iteration, which is much
+  // cheaper than a full SVD. Fall back to the latter if the iteration
+  // stalls, e.g. for nearly degenerate singular values.
+
+  bool converged;
+  Real sigma_N = smallest_singular_value(Q, &v_min, &converged);
+
+  if (!converged)
+  {
+    cMatrix Vh(N, N, fortranArray);
+    rVector sigma(N, fortranArray);
+    sigma.reference(svd(Q, &Vh));
+
+    sigma_N = sigma(N);
+
+    v_min.resize(N);
+    for (int i=1; i<=N; i++)
+      v_min(i) = conj(Vh(N,i));
+  }
 
   // Find dominant mode.
 
@@ -248,10 +394,10 @@ Real Cavity::calc_sigma(int* dominant_mode)
 
   for (int i=1; i<=N; i++)
   {
-    bot_field(i) = conj(Vh(N,i));
-    if (abs(Vh(N,i)) > dominant_power)
+    bot_field(i) = v_min(i);
+    if (abs(v_min(i)) > dominant_power)
     {
-      dominant_power = abs(Vh(N,i));
+      dominant_power = abs(v_min(i));
       *dominant_mode = i;
     }
   }
@@ -270,14 +416,17 @@ Real Cavity::calc_sigma(int* dominant_mode)
   s << "@ " << real(global.lambda)
     << " " << (global.gain_mat ? imag(global.gain_mat->n()) : 0.0)
     << " " << (global.gain_mat ? global.gain_mat->gain()    : 0.0)
-    << " " << sigma(N)
+    << " " << sigma_N
     << " " << *dominant_mode;
+
+  if (diagnostics)
+    *diagnostics = s.str();
+  else
+    py_print(s.str());
   
-  py_print(s.str());
-  
-  current_sigma = sigma(N);
+  current_sigma = sigma_N;
   
-  return sigma(N);
+  return sigma_N;
 }
 
 
@@ -13,6 +13,8 @@
 #ifndef CAVITY_H
 #define CAVITY_H
 
+#include <vector>
+#include <string>
 #include "stack.h"
 #include "math/calculus/function.h"
 
@@ -35,6 +37,11 @@ class Sigma_lambda : public Function1D<Real>
 
     Real operator()(const Real& lambda);
 
+    // Distributes the wavelengths over the cavity and its bracketing
+    // copies, if any.
+
+    void evaluate(const Real* lambda, Real* result, int n);
+
   protected:
 
     Cavity* cavity;
@@ -66,6 +73,30 @@ class Sigma_n_imag : public Function1D<Real>
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Det_lambda
+//
+//  A function object to calculate the determinant of the cavity matrix
+//  as a function of the complex wavelength.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+class Det_lambda : public Function1D<Complex>
+{
+  public:
+
+    Det_lambda(Cavity* cavity_) : cavity(cavity_) {}
+
+    Complex operator()(const Complex& lambda);
+
+  protected:
+
+    Cavity* cavity;
+};
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // CLASS: Cavity
@@ -97,10 +128,32 @@ class Cavity
                    Real n_imag_start=0.0, Real n_imag_stop=0.015,
                    unsigned int passes=1);
 
+    // Refine a resonance wavelength found by 'find_mode' to the complex
+    // wavelength where the cavity matrix is singular, keeping the gain
+    // fixed. Also sets the cavity field profile.
+
+    Complex find_complex_lambda(const Complex& lambda, Real eps=1e-12);
+
     // Calculate sigma and dominant mode for sourceless problem with
     // current wavelength and gain. Also sets cavity field profile.
+    // Only the smallest singular value is calculated, using the 
+    // singular vector of the previous call as a starting point.
+    // If 'diagnostics' is given, the progress line is returned there
+    // instead of being printed.
+
+    Real calc_sigma(int* dominant_mode=NULL, std::string* diagnostics=NULL);
+
+    // Calculate the cavity matrix Q = R_top.R_bot - U1.
+
+    cMatrix cavity_matrix();
 
-    Real calc_sigma(int* dominant_mode=NULL);
+    // Independent copies of this cavity, i.e. built from different 
+    // Waveguide objects with the same gain material, which are used to
+    // bracket the minima in 'find_modes_in_region' in parallel, each in 
+    // its own thread.
+
+    void set_bracket_copies(const std::vector<Cavity*>& c) {copies = c;}
+    const std::vector<Cavity*>& get_bracket_copies() const {return copies;}
 
     // Calculates total field in the cavity after introduction of a 
     // general source.
@@ -137,8 +190,13 @@ class Cavity
 
     Sigma_lambda sigma_lambda;
     Sigma_n_imag sigma_n_imag;
+    Det_lambda   det_lambda;
 
     Real current_sigma;
+
+    cVector v_min; // Right singular vector of last calc_sigma.
+
+    std::vector<Cavity*> copies;
 };
 
 
@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     context.cpp
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include "context.h"
+#include "icache.h"
+#include "primitives/planar/planar.h"
+#include "primitives/slab/slabmatrixcache.h"
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// get_thread_context
+//
+/////////////////////////////////////////////////////////////////////////////
+
+ThreadContext get_thread_context()
+{
+  ThreadContext context;
+
+  context.global       = global;
+  context.slab         = global_slab;
+  context.section      = global_section;
+  context.blochsection = global_blochsection;
+  context.circ         = global_circ;
+  context.planar_kt    = Planar::get_kt();
+
+  return context;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// set_thread_context
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void set_thread_context(const ThreadContext& context)
+{
+  global              = context.global;
+  global_slab         = context.slab;
+  global_section      = context.section;
+  global_blochsection = context.blochsection;
+  global_circ         = context.circ;
+
+  Planar::set_kt(context.planar_kt);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// clear_thread_caches
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void clear_thread_caches()
+{
+  interface_cache.clear();
+  slabmatrix_cache.clear();
+}
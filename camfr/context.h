@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     context.h
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "defs.h"
+#include "primitives/slab/generalslab.h"
+#include "primitives/section/section.h"
+#include "primitives/blochsection/blochsection.h"
+#include "primitives/circ/circ.h"
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// STRUCT: ThreadContext
+//
+//   Snapshot of all the solver settings of a thread: the SolverContext
+//   'global' and the per-geometry parameters in 'global_slab',
+//   'global_section', 'global_blochsection', 'global_circ' and the
+//   transverse wavevector of Planars.
+//
+//   All of these are thread local. A worker thread starts out with the
+//   default values, so a snapshot of the calling thread should be
+//   installed in it before doing any calculations.
+//
+//   Note that the interface caches are thread local too. Since a
+//   Waveguide only deregisters itself from the cache of the thread that
+//   destroys it, workers should clear their caches when they are done.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+struct ThreadContext
+{
+    SolverContext      global;
+    SlabGlobal         slab;
+    SectionGlobal      section;
+    BlochSectionGlobal blochsection;
+    CircGlobal         circ;
+    Complex            planar_kt;
+};
+
+ThreadContext get_thread_context();
+void set_thread_context(const ThreadContext& context);
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: ContextSwitch
+//
+//   Installs a ThreadContext in the current thread for the lifetime of
+//   the object, and restores the previous one afterwards.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class ContextSwitch
+{
+  public:
+
+    ContextSwitch(const ThreadContext& context)
+      : saved(get_thread_context()) {set_thread_context(context);}
+
+    ~ContextSwitch() {set_thread_context(saved);}
+
+  protected:
+
+    ThreadContext saved;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// clear_thread_caches
+//
+//   Frees the interface and overlap matrix caches of the current thread.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void clear_thread_caches();
+
+
+
+#endif
@@ -12,11 +12,15 @@
 
 #include <Python.h>
 #include <iostream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "defs.h"
 
-Global global={0,0,TE,0,track,normal,100,1,0.01,100,100,Complex(1,1),false,
-               20,1e-14,true,1e-12,identical,GEV,lapack,true,true,false,
-               0.0,1.2,false,false,false,true,false,1e-14};
+thread_local SolverContext global=
+  {0,0,TE,0,track,normal,100,1,0.01,100,100,Complex(1,1),false,
+   20,1e-14,true,1e-12,identical,GEV,lapack,true,true,false,
+   0.0,1.2,false,false,false,true,false,1e-14,1,0.0,false};
 
 /////////////////////////////////////////////////////////////////////////////
 //
@@ -38,10 +42,53 @@ std::ostream& operator<< (std::ostream& s, const Polarisation& pol)
 //
 // Python print functions.
 //
+//   These can be called from worker threads, so they acquire the
+//   interpreter lock first. The exception are OpenMP threads other than
+//   the initial one: that thread can hold the lock while waiting for
+//   them, so these write to the C++ streams instead.
+//
+//   With nested parallel regions, a thread can be the master of an inner
+//   team while being a worker of an outer one, so all enclosing levels
+//   have to be checked.
+//
 /////////////////////////////////////////////////////////////////////////////
 
-void py_print(const std::string& s) {PySys_WriteStdout("%s\n",s.c_str());}
-void py_error(const std::string& s) {PySys_WriteStderr("%s\n",s.c_str());}
+inline bool in_omp_worker()
+{
+#ifdef _OPENMP
+  for (int level=omp_get_level(); level>0; level--)
+    if (omp_get_ancestor_thread_num(level) != 0)
+      return true;
+#endif
+
+  return false;
+}
+
+void py_print(const std::string& s)
+{
+  if (in_omp_worker())
+  {
+    std::cout << s << std::endl;
+    return;
+  }
+
+  PyGILState_STATE state = PyGILState_Ensure();
+  PySys_WriteStdout("%s\n",s.c_str());
+  PyGILState_Release(state);
+}
+
+void py_error(const std::string& s)
+{
+  if (in_omp_worker())
+  {
+    std::cerr << s << std::endl;
+    return;
+  }
+
+  PyGILState_STATE state = PyGILState_Ensure();
+  PySys_WriteStderr("%s\n",s.c_str());
+  PyGILState_Release(state);
+}
 
 
 
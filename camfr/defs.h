@@ -129,15 +129,20 @@ Real machine_eps();
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// STRUCT: Global
+// STRUCT: SolverContext
 //
-//   Groups global variables and numerical parameters
+//   Groups global variables and numerical parameters.
+//
+//   Every thread has its own copy, called 'global', so that several
+//   calculations (e.g. at different wavelengths) can run concurrently in
+//   the same address space. A new thread starts out with the default
+//   values. See context.h to hand the settings of one thread to another.
 //
 /////////////////////////////////////////////////////////////////////////////
 
 class Material; // forward declaration, see material.h
  
-struct Global
+struct SolverContext
 {
     // Wavelength.
     Complex lambda;
@@ -253,9 +258,26 @@ struct Global
 
     // Set precision used in Mueller solver (not yet used everywhere).
     Real mueller_precision;  
+
+    // Maximum number of threads used to parallelise a single calculation,
+    // e.g. the S-scheme of a long stack. 1 means serial.
+    unsigned int threads;
+
+    // If nonzero, the Fourier solvers for sections only calculate the
+    // global.N modes with effective index closest to this value, using
+    // shift-invert Arnoldi rather than a full eigendecomposition.
+    Complex n_eff_target;
+
+    // Switch to let Stacks keep the combined scatterers of their leading
+    // and trailing chunks, so that changing a single chunk only needs
+    // the star products with the combinations on either side of it.
+    // This costs up to 2K extra sets of R and T matrices for K chunks.
+    bool incremental_stacks;
 };
 
-extern Global global;
+typedef SolverContext Global; // Old name.
+
+extern thread_local SolverContext global;
 
 
 
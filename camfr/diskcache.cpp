@@ -0,0 +1,429 @@
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     diskcache.cpp
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+#include <cstring>
+#include "diskcache.h"
+
+using std::vector;
+using std::string;
+using std::streamoff;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// File layout.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const char header[] = "CAMFRDC1"; // 8 bytes, without trailing zero.
+
+const unsigned int marker = 0x31434552; // "REC1"
+
+// Size of record header: marker, hash, key length, number of values.
+
+const streamoff record_header = 4 + 8 + 4 + 8;
+
+// 64-bit FNV-1a hash.
+
+unsigned long long fnv(const char* data, std::size_t n,
+                       unsigned long long h=14695981039346656037ULL)
+{
+  for (std::size_t i=0; i<n; i++)
+  {
+    h ^= (unsigned char)(data[i]);
+    h *= 1099511628211ULL;
+  }
+
+  return h;
+}
+
+template <class T>
+inline void write_value(std::fstream& f, const T& t)
+  {f.write(reinterpret_cast<const char*>(&t), sizeof(T));}
+
+template <class T>
+inline bool read_value(std::fstream& f, T* t)
+  {f.read(reinterpret_cast<char*>(t), sizeof(T)); return bool(f);}
+
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiskCache::open
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool DiskCache::open(const string& filename)
+{
+  close();
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Create file if needed.
+
+  file.open(filename.c_str(), std::ios::in|std::ios::out|std::ios::binary);
+
+  if (!file)
+  {
+    file.clear();
+    file.open(filename.c_str(), std::ios::out|std::ios::binary);
+    file.write(header, 8);
+    file.close();
+
+    file.open(filename.c_str(), std::ios::in|std::ios::out|std::ios::binary);
+  }
+
+  if (!file)
+  {
+    py_error("Error: could not open disk cache " + filename + ".");
+    file.clear();
+    return false;
+  }
+
+  // Check header.
+
+  char h[8];
+  file.read(h, 8);
+
+  if (!file || std::memcmp(h, header, 8))
+  {
+    py_error("Error: " + filename + " is not a CAMFR disk cache.");
+    file.close();
+    file.clear();
+    return false;
+  }
+
+  // Index records. Later records take precedence.
+
+  streamoff pos = 8;
+  unsigned long long hash;
+  streamoff next;
+  
+  while (scan_record(pos, &hash, &next))
+  {
+    index[hash] = pos;
+    pos = next;
+  }
+
+  valid_end = pos;
+  file.clear();
+
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiskCache::scan_record
+//
+//   Validates the record at position 'pos'.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool DiskCache::scan_record(streamoff pos, unsigned long long* hash,
+                            streamoff* next)
+{
+  file.seekg(pos);
+  
+  unsigned int m, key_length;
+  unsigned long long n;
+
+  if (    !read_value(file, &m)  || (m != marker)
+       || !read_value(file, hash)
+       || !read_value(file, &key_length) || (key_length > (1<<20))
+       || !read_value(file, &n)          || (n > (1ULL<<32)) )
+    return false;
+
+  // Read key and data and verify checksum.
+
+  vector<char> buffer(key_length + n*sizeof(Complex));
+
+  if (buffer.size())
+    file.read(&buffer[0], buffer.size());
+
+  unsigned long long checksum;
+
+  if (!file || !read_value(file, &checksum))
+    return false;
+
+  if (buffer.size() && (checksum != fnv(&buffer[0], buffer.size())))
+    return false;
+
+  if (key_length && (*hash != fnv(&buffer[0], key_length)))
+    return false;
+
+  *next = pos + record_header + streamoff(buffer.size()) + 8;
+  
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiskCache::close
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void DiskCache::close()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (file.is_open())
+    file.close();
+
+  file.clear();
+  index.clear();
+  valid_end = 0;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiskCache::is_open
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool DiskCache::is_open()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  return file.is_open();
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiskCache::load
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool DiskCache::load(const string& key, vector<Complex>* data)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (!file.is_open())
+    return false;
+
+  const unsigned long long hash = fnv(key.data(), key.size());
+
+  std::map<unsigned long long, streamoff>::const_iterator i
+    = index.find(hash);
+
+  if (i == index.end())
+  {
+    misses++;
+    return false;
+  }
+
+  // Read record and check that the key really matches.
+
+  file.seekg(i->second + 12); // Skip marker and hash.
+
+  unsigned int key_length;
+  unsigned long long n;
+  
+  read_value(file, &key_length);
+  read_value(file, &n);
+
+  string stored_key(key_length, ' ');
+  if (key_length)
+    file.read(&stored_key[0], key_length);
+
+  if (!file || (stored_key != key))
+  {
+    file.clear();
+    misses++;
+    return false;
+  }
+
+  data->resize(n);
+  if (n)
+    file.read(reinterpret_cast<char*>(&(*data)[0]), n*sizeof(Complex));
+
+  if (!file)
+  {
+    file.clear();
+    misses++;
+    return false;
+  }
+
+  hits++;
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiskCache::save
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void DiskCache::save(const string& key, const vector<Complex>& data)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (!file.is_open())
+    return;
+
+  const unsigned long long hash = fnv(key.data(), key.size());
+
+  const char* values = reinterpret_cast<const char*>(data.data());
+  const std::size_t bytes = data.size()*sizeof(Complex);
+  
+  unsigned long long checksum = fnv(key.data(), key.size());
+  checksum = fnv(values, bytes, checksum);
+  
+  file.seekp(valid_end);
+
+  write_value(file, marker);
+  write_value(file, hash);
+  write_value(file, (unsigned int)(key.size()));
+  write_value(file, (unsigned long long)(data.size()));
+  file.write(key.data(), key.size());
+  file.write(values, bytes);
+  write_value(file, checksum);
+  file.flush();
+
+  if (!file)
+  {
+    py_error("Warning: could not write to disk cache.");
+    file.clear();
+    return;
+  }
+
+  index[hash] = valid_end;
+  valid_end += record_header + streamoff(key.size() + bytes) + 8;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiskCache::load
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool DiskCache::load(const string& key, const vector<cMatrix*>& M)
+{
+  vector<Complex> data;
+
+  if (!load(key, &data))
+    return false;
+
+  const int N = global.N;
+  
+  if (data.size() != M.size()*N*N)
+    return false;
+
+  unsigned int k = 0;
+  for (unsigned int m=0; m<M.size(); m++)
+  {
+    M[m]->resize(N,N);
+    
+    for (int j=1; j<=N; j++)
+      for (int i=1; i<=N; i++)
+        (*M[m])(i,j) = data[k++];
+  }
+
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiskCache::save
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void DiskCache::save(const string& key, const vector<cMatrix*>& M)
+{
+  if (!is_open())
+    return;
+  
+  vector<Complex> data;
+  
+  for (unsigned int m=0; m<M.size(); m++)
+    for (int j=1; j<=M[m]->columns(); j++)
+      for (int i=1; i<=M[m]->rows(); i++)
+        data.push_back((*M[m])(i,j));
+
+  save(key, data);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Global disk cache
+//
+/////////////////////////////////////////////////////////////////////////////
+
+DiskCache disk_cache;
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// key_number
+//
+/////////////////////////////////////////////////////////////////////////////
+
+string key_number(const Complex& c)
+{
+  std::ostringstream s;
+  s.precision(17);
+
+  s << real(c) << "," << imag(c);
+
+  return s.str();
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// solver_key
+//
+/////////////////////////////////////////////////////////////////////////////
+
+string solver_key()
+{
+  std::ostringstream s;
+
+  s <<  "l=" << key_number(global.lambda)
+    << " N=" << global.N
+    << " pol=" << global.polarisation
+    << " solver=" << global.solver
+    << " prec=" << global.precision
+    << "," << global.precision_enhancement
+    << "," << key_number(global.dx_enhanced)
+    << "," << global.precision_rad
+    << " C=" << global.C_steps
+    << "," << key_number(global.C_upperright)
+    << " trace=" << key_number(global.eps_trace_coarse)
+    << " orth=" << global.orthogonal
+    << " degen=" << global.degenerate
+    << " est=" << global.keep_all_1D_estimates
+    << " ky=" << key_number(global.slab_ky)
+    << " surplus=" << key_number(global.mode_surplus)
+    << " bw=" << global.backward_modes
+    << " mueller=" << key_number(global.mueller_precision);
+
+  return s.str();
+}
@@ -0,0 +1,107 @@
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     diskcache.h
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <mutex>
+#include "defs.h"
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: DiskCache
+//
+//   Persistent store for expensive results (mode propagation constants,
+//   interface matrices), which survives between runs.
+//
+//   Records are identified by a canonical key string, which should
+//   describe everything the result depends on. The file consists of
+//   records which are appended, each with the hash of their key and a
+//   checksum. When the file is opened, an index of the hashes is built.
+//   A truncated or corrupt tail, e.g. after a crash, is ignored and
+//   overwritten by later records.
+//
+//   The file uses the native binary representation, so it should not
+//   be shared between machines with a different architecture.
+//
+//   There is a single process-wide cache, which can be used from
+//   several threads at once.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class DiskCache
+{
+  public:
+
+    DiskCache() : valid_end(0), hits(0), misses(0) {}
+    ~DiskCache() {close();}
+
+    bool open(const std::string& filename);
+    void close();
+    bool is_open();
+
+    bool load(const std::string& key,       std::vector<Complex>* data);
+    void save(const std::string& key, const std::vector<Complex>&  data);
+
+    // Convenience functions for a set of N x N matrices.
+
+    bool load(const std::string& key, const std::vector<cMatrix*>& M);
+    void save(const std::string& key, const std::vector<cMatrix*>& M);
+
+    unsigned long get_hits()    const {return hits;}
+    unsigned long get_misses()  const {return misses;}
+    unsigned long get_records() const {return index.size();}
+
+  protected:
+
+    std::fstream file;
+    std::streamoff valid_end;
+
+    std::map<unsigned long long, std::streamoff> index;
+
+    std::mutex mutex;
+
+    unsigned long hits, misses;
+
+    bool scan_record(std::streamoff pos, unsigned long long* hash,
+                     std::streamoff* next);
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Global disk cache
+//
+/////////////////////////////////////////////////////////////////////////////
+
+extern DiskCache disk_cache;
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Helper functions to build canonical keys.
+//
+//   solver_key:  the global settings which influence mode solving.
+//   key_number:  full precision representation of a number.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+std::string solver_key();
+
+std::string key_number(const Complex& c);
+
+
+
+#endif
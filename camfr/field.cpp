@@ -183,6 +183,48 @@ Field FieldExpansion::field(const Coord& coord) const
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// FieldExpansion::field
+//
+//   Version using tabulated mode profiles.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void FieldExpansion::field(const ModeProfiles& profiles, const Complex& z,
+                           std::vector<Field>* result) const
+{
+  const int N = wg->N();
+  
+  cMatrix fw_z(N, 1, fortranArray);
+  cMatrix bw_z(N, 1, fortranArray);
+
+  for (int i=1; i<=N; i++)
+  {
+    Complex I_kz_d = I * wg->get_mode(i)->get_kz() * z;
+
+    fw_z(i,1) = fw(i) * exp(-I_kz_d);
+    bw_z(i,1) = bw(i) * exp( I_kz_d);
+  }
+
+  cHyperM f;
+  profiles.fields(fw_z, bw_z, &f);
+  
+  result->clear();
+  
+  for (unsigned int p=0; p<profiles.points(); p++)
+  {
+    Field f_p;
+
+    f_p.E1 = f(0,p,0); f_p.E2 = f(0,p,1); f_p.Ez = f(0,p,2);
+    f_p.H1 = f(0,p,3); f_p.H2 = f(0,p,4); f_p.Hz = f(0,p,5);
+
+    result->push_back(f_p);
+  }
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // FieldExpansion::propagate
@@ -252,3 +294,80 @@ std::string FieldExpansion::repr() const
 
   return s.str();
 }
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// ModeProfiles::ModeProfiles
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+ModeProfiles::ModeProfiles(Waveguide* wg_, const std::vector<Coord>& coords)
+  : wg(wg_)
+{
+  const int N = wg->N();
+  const int n = coords.size();
+
+  for (int c=0; c<6; c++)
+    table[c].reference(cMatrix(n, N, fortranArray));
+
+  for (int i=1; i<=N; i++)
+  {
+    Mode* mode = wg->get_mode(i);
+
+    for (int p=0; p<n; p++)
+    {
+      const Field f
+        = mode->field(Coord(coords[p].c1, coords[p].c2, 0.0,
+                            coords[p].c1_limit, coords[p].c2_limit));
+
+      table[0](p+1,i) = f.E1; table[1](p+1,i) = f.E2; table[2](p+1,i) = f.Ez;
+      table[3](p+1,i) = f.H1; table[4](p+1,i) = f.H2; table[5](p+1,i) = f.Hz;
+    }
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// ModeProfiles::fields
+//
+//   Transverse E and longitudinal H fields combine forward and backward
+//   waves with the same sign, the other components with opposite sign.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void ModeProfiles::fields(const cMatrix& fw, const cMatrix& bw,
+                          cHyperM* result) const
+{
+  const int N = wg->N();
+  const int n = points();
+  const int m = fw.columns();
+
+  cMatrix sum (N, m, fortranArray);
+  cMatrix diff(N, m, fortranArray);
+
+  for (int j=1; j<=m; j++)
+    for (int i=1; i<=N; i++)
+    {
+      sum (i,j) = fw(i,j) + bw(i,j);
+      diff(i,j) = fw(i,j) - bw(i,j);
+    }
+
+  result->resize(m, n, 6);
+  
+  cMatrix F(n, m, fortranArray);
+    
+  for (int c=0; c<6; c++)
+  {
+    const bool plus = (c == 0) || (c == 1) || (c == 5);
+      
+    multiply(table[c], plus ? sum : diff, &F);
+
+    for (int j=0; j<m; j++)
+      for (int p=0; p<n; p++)
+        (*result)(j,p,c) = F(p+1,j+1);
+  }
+}
@@ -14,6 +14,7 @@
 #define FIELD_H
 
 #include <string>
+#include <vector>
 #include "defs.h"
 #include "coord.h"
 #include "math/linalg/linalg.h"
@@ -82,7 +83,8 @@ inline Field operator*(const Complex& c, const Field& f) {return f*c;}
 //  
 /////////////////////////////////////////////////////////////////////////////
 
-class Waveguide; // forward declaration - see waveguide.h
+class Waveguide;    // forward declaration - see waveguide.h
+class ModeProfiles; // forward declaration - see below
 
 class FieldExpansion
 {
@@ -93,6 +95,11 @@ class FieldExpansion
 
     Field field(const Coord& coord) const;
 
+    // Field at all points of a profile table, at longitudinal position z.
+
+    void field(const ModeProfiles& profiles, const Complex& z,
+               std::vector<Field>* result) const;
+
     FieldExpansion propagate(const Complex& z) const;
 
     Waveguide* wg;
@@ -113,4 +120,39 @@ inline FieldExpansion operator*(const Complex& c, const FieldExpansion& f)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: ModeProfiles
+//
+//   Field profiles of all the modes of a waveguide, tabulated once on a
+//   fixed set of transverse points (the z component of the coordinates is
+//   ignored). Component c of mode i at point p is stored in table[c](p,i),
+//   with c running over E1, E2, Ez, H1, H2, Hz.
+//
+//   Fields of many expansions in the same waveguide then reduce to matrix
+//   products of these tables with the expansion coefficients.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+class ModeProfiles
+{
+  public:
+
+    ModeProfiles(Waveguide* wg, const std::vector<Coord>& coords);
+
+    unsigned int points() const {return table[0].rows();}
+
+    // Fields of a set of expansions, stored in the columns of fw and bw.
+    // On return, result(j,p,c) holds component c of expansion j at point p
+    // (zero-based indices).
+
+    void fields(const cMatrix& fw, const cMatrix& bw, cHyperM* result) const;
+
+    Waveguide* wg;
+
+    cMatrix table[6];
+};
+
+
+
 #endif
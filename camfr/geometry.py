@@ -237,6 +237,45 @@ class Triangle:
       
 
 
+############################################################################
+#
+# class Polygon
+#
+#   Convex polygon, with the vertices given in order.
+#
+############################################################################
+
+class Polygon:
+
+    def __init__(self, points, mat):
+        self.p = points
+        self.mat = mat
+        self.type = "Polygon"
+
+    def intersection_at_x(self, x):
+        r = []
+        for i in range(len(self.p)):
+            p1, p2 = self.p[i], self.p[(i+1) % len(self.p)]
+            if (x < min(p1.x, p2.x)) or (x > max(p1.x, p2.x)):
+                continue
+            if p1.x == p2.x:
+                r += [p1.y, p2.y]
+            else:
+                r.append(Line(p1, p2).intersection_at_x(x))
+        if len(r) == 0:
+            return []
+        return [min(r), max(r)]
+
+    def compare(self,p):
+      if p.type != self.type or len(p.p) != len(self.p) or self.mat != p.mat:
+        return 1
+      for i in range(len(self.p)):
+        if self.p[i].compare(p.p[i]):
+          return 1
+      return 0
+
+
+
 ############################################################################
 #
 # The following are some auxiliary functions operating on slabs. Here,
@@ -622,6 +661,39 @@ def makeRefractiveIndexList(camfr_mat, colors):
 
 
 
+############################################################################
+#
+# to_slab_geometry
+#
+#  Returns a native SlabGeometry with the same shapes, or None if some
+#  of the shapes are user-defined.
+#
+############################################################################
+
+def to_slab_geometry(background_mat, shapes):
+
+    g = SlabGeometry(background_mat)
+
+    for s in shapes:
+        if isinstance(s, Circle):
+            g.add_circle(s.c.x, s.c.y, s.r, s.mat)
+        elif isinstance(s, Rectangle):
+            g.add_rectangle(s.p1.x, s.p1.y, s.p2.x, s.p2.y, s.mat)
+        elif isinstance(s, Square):
+            g.add_rectangle(s.c.x - s.a/2., s.c.y - s.a/2.,
+                            s.c.x + s.a/2., s.c.y + s.a/2., s.mat)
+        elif isinstance(s, Triangle):
+            g.add_triangle(s.p1.x, s.p1.y, s.p2.x, s.p2.y,
+                           s.p3.x, s.p3.y, s.mat)
+        elif isinstance(s, Polygon):
+            g.add_polygon([p.x for p in s.p], [p.y for p in s.p], s.mat)
+        else:
+            return None
+
+    return g
+
+
+
 ############################################################################
 #
 # Geometry
@@ -640,6 +712,9 @@ def makeRefractiveIndexList(camfr_mat, colors):
 #   the values of dx and dy. Setting dy to zero will result in no slices
 #   being combined, unless they are identical.
 #
+#   For the built-in shapes, this is done by the native SlabGeometry, which
+#   also shares a single Slab between all identical slices.
+#
 ############################################################################
 
 slab_cache = []
@@ -681,6 +756,16 @@ class Geometry:
             if (x0 > x1) or (y0 > y1):
                 print "Error: Invalid boundaries for to_expression."
                 raise IndexError
+
+            g = to_slab_geometry(self.background_mat, self.shapes)
+
+            if (g is not None) and (dx > 0) and not verbose:
+                e = g.to_expression(x0, x1, dx, y0, y1, dy,
+                                    bool(add_flipped))
+                if calc_average == False:
+                    return e
+                else:
+                    return e, g.eps_average(), g.inv_eps_average()
     
             slabs = []
             
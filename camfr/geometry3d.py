@@ -176,11 +176,13 @@ class Box:
 
 section_cache = []
 
-def get_cached_section(xy):
+def get_cached_section(xy, cache=None):
   global section_cache
-  for i in range(len(section_cache)):
-    if not zintersection_compare(xy,section_cache[i][1]):
-      return section_cache[i][0]
+  if cache is None:
+    cache = section_cache
+  for i in range(len(cache)):
+    if not zintersection_compare(xy,cache[i][1]):
+      return cache[i][0]
   return 0
       
 class Geometry3D:
@@ -205,6 +207,7 @@ class Geometry3D:
             raise IndexError
 
         sections = []
+        native_cache = []
         z = z0 + dz/2.0
         
         while z < z1:
@@ -226,7 +229,20 @@ class Geometry3D:
             z += dz
             continue
            
-          # Build the section at this z position.
+          # Build the section at this z position, natively if possible.
+          # Native sections depend on the sampling steps dx and dy, so
+          # they are only reused within this call.
+
+          g = to_slab_geometry(self.background_mat, xyobjs)
+          if (g is not None) and (dx > 0):
+            sec = get_cached_section(xyobjs, native_cache)
+            if sec == 0:
+              sec = Section(g.to_expression(x0, x1, dx, y0, y1, dy),
+                            self.M1,self.M2)
+              native_cache.append((sec,xyobjs))
+            sections.append(sec)
+            z += dz
+            continue
           
           x = x0+dx/2.0
           slabs = []
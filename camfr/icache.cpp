@@ -28,10 +28,11 @@ Scatterer* InterfaceCache::get_interface(Waveguide* wg1, Waveguide* wg2)
 
   Scatterer* sc;
   
-  bool found = cache.lookup(std::pair<Waveguide*, Waveguide*>(wg1, wg2), &sc);
+  Entry* entry = cache.find(Key(wg1, wg2));
 
-  if (found)
+  if (entry)
   {
+    sc = entry->sc;
     
     if (    (global.always_dense == true)
          && (wg1->is_uniform() && wg2->is_uniform())
@@ -41,15 +42,31 @@ Scatterer* InterfaceCache::get_interface(Waveguide* wg1, Waveguide* wg2)
       deregister(wg2, wg1);
     }
     else
+    {
+      // Mark as most recently used.
+
+      lru.splice(lru.end(), lru, entry->lru);
+
+      if (entry->evicted)
+      {
+        misses++;
+        entry->evicted = false;
+      }
+      else
+        hits++;
+      
       return sc;
+    }
   }
+
+  misses++;
   
   // Transparent DiagScatterer?
 
   if ( (wg1 == wg2) && (!dynamic_cast<MonoWaveguide*>(wg1)) )
   {
     sc = new TransparentScatterer(*wg1);
-    cache.store(std::pair<Waveguide*, Waveguide*>(wg1, wg2), sc);
+    store(Key(wg1, wg2), sc);
     return sc;
   }
  
@@ -66,7 +83,7 @@ Scatterer* InterfaceCache::get_interface(Waveguide* wg1, Waveguide* wg2)
   else
     sc = new DenseInterface(*wg1, *wg2);
   
-  cache.store(std::pair<Waveguide*, Waveguide*>(wg1, wg2), sc);
+  store(Key(wg1, wg2), sc);
 
   if (wg1 != wg2)
   {
@@ -90,7 +107,7 @@ Scatterer* InterfaceCache::get_interface(Waveguide* wg1, Waveguide* wg2)
         sc_flip = new FlippedScatterer(*dynamic_cast<MultiScatterer*>(sc));
     }
 
-    cache.store(std::pair<Waveguide*, Waveguide*>(wg2, wg1), sc_flip);
+    store(Key(wg2, wg1), sc_flip);
   }
 
   return sc;
@@ -98,6 +115,50 @@ Scatterer* InterfaceCache::get_interface(Waveguide* wg1, Waveguide* wg2)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// InterfaceCache::store
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void InterfaceCache::store(const Key& key, Scatterer* sc)
+{
+  Entry entry;
+  
+  entry.sc      = sc;
+  entry.lru     = lru.insert(lru.end(), key);
+  entry.evicted  = false;
+  entry.eviction = 0;
+  
+  cache.store(key, entry);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// InterfaceCache::erase
+//
+//   Removes entries from the cache. The scatterers should already
+//   have been deleted.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void InterfaceCache::erase(const std::vector<Key>& keys)
+{
+  for (unsigned int i=0; i<keys.size(); i++)
+  {
+    Entry* entry = cache.find(keys[i]);
+    if (entry)
+    {
+      lru.erase(entry->lru);
+      cache.erase(keys[i]);
+    }
+  }
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // InterfaceCache::~InterfaceCache
@@ -106,9 +167,8 @@ Scatterer* InterfaceCache::get_interface(Waveguide* wg1, Waveguide* wg2)
 
 InterfaceCache::~InterfaceCache()
 {  
-  for (Cache<std::pair<Waveguide*, Waveguide*>, Scatterer*>::iter
-         i=cache.begin(); i!=cache.end(); ++i)
-    delete i->second;
+  for (Cache<Key, Entry>::iter i=cache.begin(); i!=cache.end(); ++i)
+    delete i->second.sc;
 }
 
 
@@ -121,18 +181,16 @@ InterfaceCache::~InterfaceCache()
 
 void InterfaceCache::deregister(Waveguide* wg)
 {
-  std::vector<std::pair<Waveguide*,Waveguide*> > to_wipe;
+  std::vector<Key> to_wipe;
 
-  for (Cache<std::pair<Waveguide*, Waveguide*>, Scatterer*>::iter
-         i=cache.begin(); i!=cache.end(); ++i)
+  for (Cache<Key, Entry>::iter i=cache.begin(); i!=cache.end(); ++i)
     if ( (i->first.first == wg) || (i->first.second == wg) )
     {
-      delete i->second;
+      delete i->second.sc;
       to_wipe.push_back(i->first);
     }
 
-  for (int i=0; i<to_wipe.size(); i++)
-    cache.erase(to_wipe[i]);
+  erase(to_wipe);
 }
 
 
@@ -145,18 +203,16 @@ void InterfaceCache::deregister(Waveguide* wg)
 
 void InterfaceCache::deregister(Waveguide* wg1, Waveguide* wg2)
 {  
-  std::vector<std::pair<Waveguide*,Waveguide*> > to_wipe;
+  std::vector<Key> to_wipe;
 
-  for (Cache<std::pair<Waveguide*, Waveguide*>, Scatterer*>::iter
-         i=cache.begin(); i!=cache.end(); ++i)
+  for (Cache<Key, Entry>::iter i=cache.begin(); i!=cache.end(); ++i)
     if ( (i->first.first == wg1) && (i->first.second == wg2) )
     {
-      delete i->second;      
+      delete i->second.sc;      
       to_wipe.push_back(i->first);
     }  
 
-  for (int i=0; i<to_wipe.size(); i++)
-    cache.erase(to_wipe[i]);
+  erase(to_wipe);
 }
 
 
@@ -169,11 +225,86 @@ void InterfaceCache::deregister(Waveguide* wg1, Waveguide* wg2)
 
 void InterfaceCache::clear()
 { 
-  for (Cache<std::pair<Waveguide*, Waveguide*>, Scatterer*>::iter
-         i=cache.begin(); i!=cache.end(); ++i)
-    delete i->second;
+  for (Cache<Key, Entry>::iter i=cache.begin(); i!=cache.end(); ++i)
+    delete i->second.sc;
 
   cache.clear();
+  lru.clear();
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// InterfaceCache::get_bytes
+//
+/////////////////////////////////////////////////////////////////////////////
+
+std::size_t InterfaceCache::get_bytes() const
+{
+  std::size_t bytes = 0;
+  
+  for (Cache<Key, Entry>::const_iter i=cache.begin(); i!=cache.end(); ++i)
+    bytes += i->second.sc->memory();
+
+  return bytes;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// InterfaceCache::trim
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void InterfaceCache::trim()
+{
+  if (budget == 0)
+    return;
+
+  std::size_t bytes = get_bytes();
+
+  if (bytes <= budget)
+    return;
+
+  // Free matrices, starting from the least recently used interface.
+
+  generation++;
+
+  for (std::list<Key>::iterator i=lru.begin(); 
+       (i!=lru.end()) && (bytes>budget); ++i)
+  {
+    Entry* entry = cache.find(*i);
+
+    const std::size_t m = entry->sc->memory();
+
+    if (m == 0)
+      continue;
+
+    entry->sc->freeRT();
+    entry->evicted  = true;
+    entry->eviction = generation;
+
+    bytes -= m;
+    evictions++;
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// InterfaceCache::get_eviction
+//
+/////////////////////////////////////////////////////////////////////////////
+
+unsigned long InterfaceCache::get_eviction(Waveguide* wg1,
+                                           Waveguide* wg2) const
+{
+  const Entry* entry = cache.find(Key(wg1, wg2));
+
+  return entry ? entry->eviction : 0;
 }
 
 
@@ -184,7 +315,7 @@ void InterfaceCache::clear()
 //
 /////////////////////////////////////////////////////////////////////////////
 
-InterfaceCache interface_cache;
+thread_local InterfaceCache interface_cache;
 
 
 
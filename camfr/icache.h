@@ -13,6 +13,7 @@
 #ifndef ICACHE_H
 #define ICACHE_H
 
+#include <list>
 #include "util/storage.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -21,6 +22,20 @@
 //
 //   Cache for previously created Interfaces.
 //
+//   If a memory budget (in bytes) is set, the R and T matrices of the
+//   least recently used interfaces are freed when the cache grows beyond
+//   it. The Interface objects themselves are kept, since Stacks hold
+//   pointers to them, and are recalculated when needed again.
+//
+//   Like the cache itself, the budget is per thread: each thread that
+//   calculates stacks holds its own interfaces within its own budget.
+//
+//   Freeing only happens in 'trim', which is called at the start of
+//   a top level Stack calculation. Every trim that frees matrices
+//   increases the generation, and the freed interfaces remember the
+//   generation in which that happened. That way, a Stack can find out
+//   which of its own interfaces need to be recalculated.
+//
 /////////////////////////////////////////////////////////////////////////////
 
 class Waveguide; // forward declaration - see waveguide.h
@@ -30,7 +45,9 @@ class InterfaceCache
 {
   public:
 
-    InterfaceCache() {}
+    InterfaceCache()
+      : budget(0), hits(0), misses(0), evictions(0), generation(0),
+        depth(0) {}
     ~InterfaceCache();
       
     Scatterer* get_interface(Waveguide* wg1, Waveguide* wg2);
@@ -40,9 +57,59 @@ class InterfaceCache
     
     void clear();
 
+    // Memory budget in bytes. Zero means unlimited.
+
+    void set_budget(std::size_t bytes) {budget = bytes;}
+    std::size_t get_budget() const {return budget;}
+
+    void trim();
+
+    // Calculation nesting, used to trim only at the top level.
+
+    void enter() {if (depth++ == 0) trim();}
+    void leave() {depth--;}
+    
+    unsigned long get_generation() const {return generation;}
+
+    // Generation in which the matrices of this interface were last freed,
+    // or zero if they never were.
+
+    unsigned long get_eviction(Waveguide* wg1, Waveguide* wg2) const;
+
+    // Statistics.
+
+    unsigned long get_hits()      const {return hits;}
+    unsigned long get_misses()    const {return misses;}
+    unsigned long get_evictions() const {return evictions;}
+    unsigned long get_entries()   const {return lru.size();}
+    std::size_t   get_bytes()     const;
+
+    void reset_stats() {hits = misses = evictions = 0;}
+
   protected:
 
-    Cache<std::pair<Waveguide*, Waveguide*>, Scatterer*> cache;
+    typedef std::pair<Waveguide*, Waveguide*> Key;
+
+    struct Entry
+    {
+      Scatterer* sc;
+      std::list<Key>::iterator lru; // Position in LRU list.
+      bool evicted;
+      unsigned long eviction; // Generation of the last eviction.
+    };
+
+    Cache<Key, Entry> cache;
+
+    std::list<Key> lru; // Most recently used at the back.
+
+    void store(const Key& key, Scatterer* sc);
+    void erase(const std::vector<Key>& keys);
+
+    std::size_t budget;
+
+    unsigned long hits, misses, evictions, generation;
+    
+    int depth;
 };
 
 
@@ -53,7 +120,7 @@ class InterfaceCache
 //
 /////////////////////////////////////////////////////////////////////////////
 
-extern InterfaceCache interface_cache;
+extern thread_local InterfaceCache interface_cache;
 
 
 #endif
@@ -114,4 +114,5 @@ void InfStack::calcRT()
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
   last_slab_ky = global.slab_ky;
+  last_materials_version = materials_version(get_materials());
 }
@@ -12,6 +12,7 @@
 
 #include <sstream>
 #include "interface.h"
+#include "diskcache.h"
 #include "bloch.h"
 #include "primitives/blochsection/blochsection.h"
 
@@ -75,12 +76,24 @@ void DenseInterface::calcRT()
   }
   else
   {
-    if (global.orthogonal == false)
-      (global.stability == normal) ? calcRT_non_orth_fast()
-                                   : calcRT_non_orth_safe();
-    else
-      (global.stability == normal) ? calcRT_fast()
-                                   : calcRT_safe();
+    const std::string key = disk_cache.is_open() ? disk_key() : "";
+
+    std::vector<cMatrix*> RT;
+    RT.push_back(&R12); RT.push_back(&R21);
+    RT.push_back(&T12); RT.push_back(&T21);
+
+    if (key.empty() || !disk_cache.load(key, RT))
+    {
+      if (global.orthogonal == false)
+        (global.stability == normal) ? calcRT_non_orth_fast()
+                                     : calcRT_non_orth_safe();
+      else
+        (global.stability == normal) ? calcRT_fast()
+                                     : calcRT_safe();
+
+      if (!key.empty())
+        disk_cache.save(key, RT);
+    }
   }
 
   // Remember wavelength and gain these matrices were calculated for.
@@ -89,6 +102,33 @@ void DenseInterface::calcRT()
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
   last_slab_ky = global.slab_ky;
+  last_materials_version = materials_version(get_materials());
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// DenseInterface::disk_key
+//
+//   Key for the disk cache, empty if one of the media can't be cached.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+std::string DenseInterface::disk_key() const
+{
+  const std::string inc_key = inc->disk_key();
+  const std::string ext_key = ext->disk_key();
+
+  if (inc_key.empty() || ext_key.empty())
+    return "";
+
+  std::ostringstream s;
+  
+  s << "DenseInterface stability=" << global.stability
+    << " inc={" << inc_key << "} ext={" << ext_key << "}";
+
+  return s.str();
 }
 
 
@@ -813,6 +853,7 @@ void DiagInterface::calcRT()
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
 }
 
 
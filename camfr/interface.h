@@ -49,6 +49,8 @@ class DenseInterface : public DenseScatterer
 
   protected:
 
+    std::string disk_key() const;
+
     void calcRT_fast();
     void calcRT_safe();
     void calcRT_non_orth_fast();
@@ -10,6 +10,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
 #include "material.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -47,11 +48,28 @@ void Material::set_epsr_mur(const Complex& epsr_, const Complex& mur_)
     i_n    = sqrt(abs(epsr_)*abs(mur_))*exp(I*(arg(epsr_)+arg(mur_))/2.0);
     i_etar = sqrt(abs(epsr_)/abs(mur_))*exp(I*(arg(epsr_)-arg(mur_))/2.0);
   };
+
+  i_version++;
 }
 
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Material::new_id
+//
+/////////////////////////////////////////////////////////////////////////////
+
+unsigned long Material::new_id()
+{
+  static std::atomic<unsigned long> last_id(0);
+
+  return ++last_id;
+}
+
+
+
 // Note: following is obsolete and will be removed
 
 /////////////////////////////////////////////////////////////////////////////
@@ -14,6 +14,7 @@
 #define MATERIAL_H
 
 #include <sstream>
+#include <vector>
 #include <iostream>
 #include "defs.h"
 
@@ -77,6 +78,11 @@ inline std::ostream& operator<<(std::ostream& s, const BaseMaterial& m)
 //
 //   Note: access the current wavelength through the global variable
 //   'global.lambda' (see defs.h)
+//
+//   The version is increased every time the material is changed, so that
+//   waveguides and scatterers can detect that they need recalculation.
+//   The id is unique for every material object created in this process,
+//   unlike its address, which can be reused after it is deleted.
 //  
 /////////////////////////////////////////////////////////////////////////////
 
@@ -84,8 +90,16 @@ class Material : public BaseMaterial
 {
   public:
     
-    Material(const Complex& n) : i_n(n), i_etar(i_n) {}
-    Material(const Complex& n, const Complex& etar) : i_n(n), i_etar(etar) {}
+    Material(const Complex& n)
+      : i_n(n), i_etar(i_n), i_version(0), i_id(new_id()) {}
+    Material(const Complex& n, const Complex& etar)
+      : i_n(n), i_etar(etar), i_version(0), i_id(new_id()) {}
+    Material(const Material& m)
+      : BaseMaterial(m), i_n(m.i_n), i_etar(m.i_etar),
+        i_version(m.i_version), i_id(new_id()) {}
+
+    Material& operator=(const Material& m)
+      {i_n = m.i_n; i_etar = m.i_etar; i_version++; return *this;}
     
     const Complex   epsr() const {return i_n * i_etar;}
     const Complex    mur() const {return i_n / i_etar;}
@@ -107,10 +121,13 @@ class Material : public BaseMaterial
     void set_mur     (const Complex& mur)  {set_epsr_mur(epsr(), mur);}
 
     void set_n_imag(Real n_imag)
-      {i_n = Complex(real(i_n), n_imag); i_etar = i_n;}
+      {i_n = Complex(real(i_n), n_imag); i_etar = i_n; i_version++;}
+
+    void set_n(Complex n)        {i_n = n;       i_version++;}
+    void set_etar(Complex etar)  {i_etar = etar; i_version++;}
 
-    void set_n(Complex n)        {i_n = n;}
-    void set_etar(Complex etar)  {i_etar = etar;}
+    unsigned long version() const {return i_version;}
+    unsigned long id()      const {return i_id;}
     
     bool no_gain_present() const {return (imag(i_n) < 1e-12);}
     
@@ -127,6 +144,11 @@ class Material : public BaseMaterial
     
     Complex i_n;
     Complex i_etar;
+
+    unsigned long i_version;
+    unsigned long i_id;
+
+    static unsigned long new_id();
 };
 
 inline std::ostream& operator<<(std::ostream& s, const Material& m)
@@ -134,6 +156,27 @@ inline std::ostream& operator<<(std::ostream& s, const Material& m)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// materials_version
+//
+//   Sum of the versions of a set of materials. As versions only increase,
+//   this changes whenever one of the materials is changed.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline unsigned long materials_version(const std::vector<Material*>& m)
+{
+  unsigned long version = 0;
+
+  for (unsigned int i=0; i<m.size(); i++)
+    version += m[i]->version();
+
+  return version;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // CLASS: BiaxialMaterial
@@ -167,25 +167,44 @@ struct Sorter
        {return (real(a) < real(b));}
 };
 
-vector<Complex> allroots_contour(const Contour& c) 
+vector<Complex> allroots_contour(const Contour& c, bool concurrent) 
 { 
+  // Calculate the integrals along all segments.
+
+  c.calc_integrals(concurrent);
+
   // Find roots in contour and subcontours.
-  
-  vector<Complex> roots = roots_contour(c, c.contour_integrals());
+
+  const Contour* cp = &c;
+
+  vector<Complex> roots;
+  vector<vector<Complex> > subroots_i(4);
+
+  #pragma omp task shared(roots) if(concurrent)
+  roots = roots_contour(*cp, cp->contour_integrals());
+
+  for (unsigned int i_=0; i_<4; i_++)
+  {
+    #pragma omp task shared(subroots_i) if(concurrent)
+    {
+      Subcontour i = Subcontour(i_);
+      subroots_i[i_]
+        = roots_contour(cp->subcontour(i), cp->subcontour_integrals(i));
+    }
+  }
+
+  #pragma omp taskwait
 
   bool OK = true;
 
   vector<Complex> subroots;
   for (unsigned int i_=0; i_<4; i_++)
   {
-    Subcontour i = Subcontour(i_);
-    vector<Complex> subroots_i
-      = roots_contour(c.subcontour(i), c.subcontour_integrals(i));
-
-    if (subroots_i.size() > 0.8*N_max)
+    if (subroots_i[i_].size() > 0.8*N_max)
       OK = false;
     
-    subroots.insert(subroots.end(), subroots_i.begin(), subroots_i.end());
+    subroots.insert(subroots.end(),
+                    subroots_i[i_].begin(), subroots_i[i_].end());
   }
 
   // If roots contains the same values as subroots, we are done.
@@ -212,16 +231,22 @@ vector<Complex> allroots_contour(const Contour& c)
   if ((roots.size() == 1) && (subroots.size() == 0))
     return roots;
   
-  // Else, recursively subdivide contour further.
+  // Else, recursively subdivide contour further. The subcontours are
+  // independent, apart from the shared segments in the cache.
   
-  roots.clear();
   for (unsigned int i_=0; i_<4; i_++)
   {
-    Subcontour i = Subcontour(i_);
-    vector<Complex> subroots_i = allroots_contour(c.subcontour(i));
-    roots.insert(roots.end(), subroots_i.begin(), subroots_i.end());
+    #pragma omp task shared(subroots_i) if(concurrent)
+    subroots_i[i_] = allroots_contour(cp->subcontour(Subcontour(i_)),
+                                      concurrent);
   }
 
+  #pragma omp taskwait
+
+  roots.clear();
+  for (unsigned int i_=0; i_<4; i_++)
+    roots.insert(roots.end(), subroots_i[i_].begin(), subroots_i[i_].end());
+
   return roots;
 }
 
@@ -235,10 +260,14 @@ vector<Complex> allroots_contour(const Contour& c)
 
 vector<Complex> allroots
   (ComplexFunction& f, const Complex& bottom_left, const Complex& top_right,
-   Real eps, Real mu, unsigned int max_k)
+   Real eps, Real mu, unsigned int max_k, bool concurrent)
 { 
-  Contour contour(bottom_left, top_right, f, 2*N_max-1, eps, mu, max_k);
-  return allroots_contour(contour);
+  SegmentCache cache;
+
+  Contour contour(bottom_left, top_right, f, 2*N_max-1, eps, mu, max_k,
+                  &cache);
+
+  return allroots_contour(contour, concurrent);
 }
 
 
@@ -252,20 +281,21 @@ vector<Complex> allroots
 vector<Complex> N_roots(ComplexFunction& f, unsigned int N,
                         const Complex& bottom_left, const Complex& top_right,
                         Real eps, Real mu, unsigned int max_k, 
-                        ExpandDirection dir)
+                        ExpandDirection dir, bool concurrent)
 {
   // Enlarge initial contour if needed.
 
   Contour c0(bottom_left, top_right, f, 2*N-1, eps, mu, max_k);
 
   vector<Complex> roots
-    = allroots(f, c0.get_bottom_left(), c0.get_top_right(), eps, mu, max_k);
+    = allroots(f, c0.get_bottom_left(), c0.get_top_right(),
+               eps, mu, max_k, concurrent);
   
   while (roots.size() == 0)
   {    
     Contour c = c0.double_ur();
-    roots 
-      = allroots(f, c.get_bottom_left(), c.get_top_right(), eps, mu, max_k);
+    roots = allroots(f, c.get_bottom_left(), c.get_top_right(),
+                     eps, mu, max_k, concurrent);
    
     c0 = c;
   }
@@ -306,8 +336,9 @@ vector<Complex> N_roots(ComplexFunction& f, unsigned int N,
     Contour c = contour_stack.front();
     contour_stack.erase(contour_stack.begin());
     
-    vector<Complex> roots_c
-      = allroots(f, c.get_bottom_left(), c.get_top_right(), eps, mu, max_k);
+    vector<Complex> roots_c = allroots(f, c.get_bottom_left(),
+                                       c.get_top_right(), eps, mu, max_k,
+                                       concurrent);
 
     ExpandDirection true_dir = r;
     for (unsigned int i=0; i<roots_c.size(); i++)
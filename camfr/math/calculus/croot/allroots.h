@@ -26,11 +26,16 @@
 //   eps, mu and max_k are numeric parameters for the patterson quadrature
 //   formulas.
 //
+//   If concurrent is true, the segment integrals and the subdivision are
+//   spawned as OpenMP tasks, to be picked up by the other threads of the
+//   enclosing parallel region. These threads should have a suitable
+//   thread context, and f should be safe to call concurrently.
+//
 /////////////////////////////////////////////////////////////////////////////
 
 std::vector<Complex> allroots
   (ComplexFunction& f, const Complex& bottom_left, const Complex& top_right,
-   Real eps=1e-4, Real mu=1e-4, unsigned int max_k=4);
+   Real eps=1e-4, Real mu=1e-4, unsigned int max_k=4, bool concurrent=false);
 
 
 
@@ -44,6 +49,8 @@ std::vector<Complex> allroots
 //   If needed, the search region is expanded upwards and to the right or
 //   downwards and to the right..
 //
+//   'concurrent' has the same meaning as for allroots.
+//
 /////////////////////////////////////////////////////////////////////////////
 
 typedef enum {ur, dr, r} ExpandDirection;
@@ -51,7 +58,8 @@ typedef enum {ur, dr, r} ExpandDirection;
 std::vector<Complex> N_roots
   (ComplexFunction& f, unsigned int N,
    const Complex& bottom_left, const Complex& top_right,
-   Real eps=1e-4, Real mu=1e-4, unsigned int max_k=4, ExpandDirection dir=ur);
+   Real eps=1e-4, Real mu=1e-4, unsigned int max_k=4, ExpandDirection dir=ur,
+   bool concurrent=false);
 
 
 #endif
@@ -48,6 +48,71 @@ int     Contour::sub_signs[4][4]    = { {+1,    +1,    +1,    -1},
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// SegmentCache::Key::operator<
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool SegmentCache::Key::operator<(const Key& k) const
+{
+  if (a_re != k.a_re) return a_re < k.a_re;
+  if (a_im != k.a_im) return a_im < k.a_im;
+  if (b_re != k.b_re) return b_re < k.b_re;
+
+  return b_im < k.b_im;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SegmentCache::lookup
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool SegmentCache::lookup(const Complex& a, const Complex& b,
+                          vector<Complex>* ints)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  map<Key, vector<Complex> >::const_iterator i = integrals.find(Key(a,b));
+
+  if (i != integrals.end())
+  {
+    *ints = i->second;
+    return true;
+  }
+
+  i = integrals.find(Key(b,a));
+
+  if (i != integrals.end())
+  {
+    *ints = -i->second;
+    return true;
+  }
+
+  return false;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SegmentCache::store
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void SegmentCache::store(const Complex& a, const Complex& b,
+                         const vector<Complex>& ints)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  integrals[Key(a,b)] = ints;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Contour::Contour
@@ -56,9 +121,10 @@ int     Contour::sub_signs[4][4]    = { {+1,    +1,    +1,    -1},
 
 Contour::Contour(const Complex& bottom_left, const Complex& top_right,
                  ComplexFunction& f_, unsigned int M_,
-                 Real eps_, Real mu_, unsigned int max_k_)
+                 Real eps_, Real mu_, unsigned int max_k_,
+                 SegmentCache* cache_)
   : bl(bottom_left), tr(top_right),
-    f(&f_), M(M_), eps(eps_), mu(mu_), max_k(max_k_)
+    f(&f_), M(M_), eps(eps_), mu(mu_), max_k(max_k_), cache(cache_)
 {
   for (unsigned int i=0; i<12; i++)
     know_integrals[i] = false;
@@ -152,6 +218,7 @@ void Contour::copy_from(const Contour& c)
   eps   = c.eps;
   mu    = c.mu;
   max_k = c.max_k;
+  cache = c.cache;
   
   for (unsigned int i=0; i<12; i++)
   {
@@ -189,16 +256,16 @@ const Contour Contour::subcontour(Subcontour s) const
   switch(s)
   {
     case top_left:
-      return Contour(cl, tc, *f, M, eps, mu, max_k);
+      return Contour(cl, tc, *f, M, eps, mu, max_k, cache);
 
     case top_right:
-      return Contour(cc, tr, *f, M, eps, mu, max_k);
+      return Contour(cc, tr, *f, M, eps, mu, max_k, cache);
 
     case bottom_left:
-      return Contour(bl, cc, *f, M, eps, mu, max_k);
+      return Contour(bl, cc, *f, M, eps, mu, max_k, cache);
 
     case bottom_right:
-      return Contour(bc, cr, *f, M, eps, mu, max_k);
+      return Contour(bc, cr, *f, M, eps, mu, max_k, cache);
   }
 }
 
@@ -215,8 +282,17 @@ vector<Complex> Contour::get_integrals(Segment segment) const
   if (know_integrals[segment] == true)
     return integrals[segment];
 
-  integrals[segment]
-    = patterson_quad_z_n(*f,*begin[segment],*end[segment],M,eps,mu,max_k);
+  const Complex a = *begin[segment];
+  const Complex b =   *end[segment];
+
+  if (!(cache && cache->lookup(a, b, &integrals[segment])))
+  {
+    integrals[segment] = patterson_quad_z_n(*f,a,b,M,eps,mu,max_k);
+
+    if (cache)
+      cache->store(a, b, integrals[segment]);
+  }
+  
   know_integrals[segment] = true;
   
   return integrals[segment];
@@ -224,6 +300,32 @@ vector<Complex> Contour::get_integrals(Segment segment) const
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Contour::calc_integrals
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void Contour::calc_integrals(bool concurrent) const
+{
+  // Each task fills in a different segment.
+
+  for (unsigned int i=0; i<12; i++)
+  {
+    if (know_integrals[i])
+      continue;
+
+    const Segment segment = Segment(i);
+
+    #pragma omp task if(concurrent)
+    get_integrals(segment);
+  }
+
+  #pragma omp taskwait
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Contour::path_integrals
@@ -266,7 +368,7 @@ vector<Complex> Contour::path_integrals
 
 Contour Contour::adjacent_r() const
 {
-  Contour r(br, tr + (tr-tl), *f, M, eps, mu, max_k);
+  Contour r(br, tr + (tr-tl), *f, M, eps, mu, max_k, cache);
 
   r.set_integrals(tl_cl, -get_integrals(cr_tr));
   r.set_integrals(cl_bl, -get_integrals(br_cr));
@@ -293,9 +395,9 @@ vector<Contour> Contour::adjacent_ur() const
 {
   // Create adjacent contours.
 
-  Contour  r(br, tr + (tr-tl), *f, M, eps, mu, max_k);
-  Contour  u(tl, tr + (tr-br), *f, M, eps, mu, max_k);
-  Contour ur(tr, tr + (tr-bl), *f, M, eps, mu, max_k);
+  Contour  r(br, tr + (tr-tl), *f, M, eps, mu, max_k, cache);
+  Contour  u(tl, tr + (tr-br), *f, M, eps, mu, max_k, cache);
+  Contour ur(tr, tr + (tr-bl), *f, M, eps, mu, max_k, cache);
 
   // Precalculate shared line segments.
 
@@ -343,9 +445,9 @@ vector<Contour> Contour::adjacent_dr() const
 {
   // Create adjacent contours.
 
-  Contour  r(br,           tr + (tr-tl), *f, M, eps, mu, max_k);
-  Contour  d(bl - (tl-bl), br,           *f, M, eps, mu, max_k);
-  Contour dr(br - (tr-br), br + (br-bl), *f, M, eps, mu, max_k);
+  Contour  r(br,           tr + (tr-tl), *f, M, eps, mu, max_k, cache);
+  Contour  d(bl - (tl-bl), br,           *f, M, eps, mu, max_k, cache);
+  Contour dr(br - (tr-br), br + (br-bl), *f, M, eps, mu, max_k, cache);
 
   // Precalculate shared line segments.
 
@@ -391,7 +493,7 @@ vector<Contour> Contour::adjacent_dr() const
 
 Contour Contour::double_ur() const
 {
-  Contour ur(bl, tr + (tr-bl), *f, M, eps, mu, max_k);
+  Contour ur(bl, tr + (tr-bl), *f, M, eps, mu, max_k, cache);
 
   ur.set_integrals(cc_bc, -get_integrals(br_cr) - get_integrals(cr_tr));
   ur.set_integrals(cc_cl,  get_integrals(tr_tc) + get_integrals(tc_tl));
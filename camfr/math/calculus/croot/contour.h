@@ -13,8 +13,49 @@
 #ifndef CONTOUR_H
 #define CONTOUR_H
 
+#include <map>
+#include <mutex>
 #include "../function.h"
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: SegmentCache
+//
+//   Thread-safe cache of the integrals z^n / f(z) along line segments,
+//   shared between the contours of a root search. Integrals along a
+//   segment traversed in the opposite direction are reused with a minus
+//   sign.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class SegmentCache
+{
+  public:
+
+    bool lookup(const Complex& a, const Complex& b,
+                std::vector<Complex>* ints);
+
+    void store (const Complex& a, const Complex& b,
+                const std::vector<Complex>& ints);
+
+  protected:
+
+    struct Key
+    {
+        Key(const Complex& a, const Complex& b)
+          : a_re(real(a)), a_im(imag(a)), b_re(real(b)), b_im(imag(b)) {}
+
+        bool operator<(const Key& k) const;
+
+        Real a_re, a_im, b_re, b_im;
+    };
+
+    std::map<Key, std::vector<Complex> > integrals;
+    std::mutex mutex;
+};
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // CLASS: Contour
@@ -46,7 +87,8 @@ class Contour
 
     Contour(const Complex& bottom_left, const Complex& top_right,
             ComplexFunction& f, unsigned int M,
-            Real eps=1e-4, Real mu=1e-4, unsigned int max_k=8);
+            Real eps=1e-4, Real mu=1e-4, unsigned int max_k=8,
+            SegmentCache* cache=NULL);
     Contour(const Contour&);
     Contour& operator=(const Contour&);
     ~Contour() {}
@@ -95,6 +137,12 @@ class Contour
 
     std::vector<Complex> get_integrals(Segment segment) const;
 
+    // Calculates the integrals along all the segments of the contour and
+    // the subcontours. If concurrent is true, the segments are integrated
+    // in OpenMP tasks.
+
+    void calc_integrals(bool concurrent=false) const;
+
     ComplexFunction* get_f()  const {return f;}
     Complex get_bottom_left() const {return bl;}
     Complex get_top_right()   const {return tr;}
@@ -107,6 +155,8 @@ class Contour
     Real eps, mu;
     unsigned int max_k;
 
+    SegmentCache* cache;
+
     Complex tl, tc, tr;
     Complex cl, cc, cr;
     Complex bl, bc, br;
@@ -8,394 +8,395 @@
   // 1 - |abscissa|, the first "node" coefficient for each formula is
   // the smallest.
 
-  static Real p[306]; 
+  static const Real p[306] = {
 
-  p[  0] = 0; // C offset.
+    /*  0 */ 0, // C offset.
 
-  //
-  // 3-point formula.
-  //
+    //
+    // 3-point formula.
+    //
 
-  // Correction for F(1,1).
+    // Correction for F(1,1).
   
-  p[  1] = -.11111111111111111111e+00;
+    /*  1 */ -.11111111111111111111e+00,
   
-  // Node and weight for F(2,1).
+    // Node and weight for F(2,1).
   
-  p[  2] = +.22540333075851662296e+00;
-  p[  3] = +.55555555555555555556e+00;
+    /*  2 */ +.22540333075851662296e+00,
+    /*  3 */ +.55555555555555555556e+00,
 
 
 
   
-  //
-  // 7-point formula.
-  //
+    //
+    // 7-point formula.
+    //
 
-  // Corrections for F(1,1) and F(2,1).
+    // Corrections for F(1,1) and F(2,1).
   
-  p[  4] = +.64720942140296979100e-02;
-  p[  5] = -.92896879094443370500e-02;
+    /*  4 */ +.64720942140296979100e-02,
+    /*  5 */ -.92896879094443370500e-02,
   
-  // Nodes and weights for F(3,1-2)
+    // Nodes and weights for F(3,1-2)
   
-  p[  6] = +.39508731291979716579e-01;
-  p[  7] = +.10465622602646726519e+00;
-  p[  8] = +.56575625065319744200e+00;
-  p[  9] = +.40139741477596222291e+00;
+    /*  6 */ +.39508731291979716579e-01,
+    /*  7 */ +.10465622602646726519e+00,
+    /*  8 */ +.56575625065319744200e+00,
+    /*  9 */ +.40139741477596222291e+00,
 
 
 
-  //
-  // 15-point formula.
-  //
+    //
+    // 15-point formula.
+    //
 
-  // Corrections for F(1,1), F(2,1), F(3,1-2).
+    // Corrections for F(1,1), F(2,1), F(3,1-2).
 
-  p[ 10] = +.52230468969616220000e-04;
-  p[ 11] = +.17121030961750000000e-03;
-  p[ 12] = -.72483001615389289800e-03;
-  p[ 13] = -.70178010992090420000e-04;
+    /* 10 */ +.52230468969616220000e-04,
+    /* 11 */ +.17121030961750000000e-03,
+    /* 12 */ -.72483001615389289800e-03,
+    /* 13 */ -.70178010992090420000e-04,
   
-  // Nodes and weights for F(4,1-4).
+    // Nodes and weights for F(4,1-4).
   
-  p[ 14] = +.61680367872449777899e-02;
-  p[ 15] = +.17001719629940260339e-01;
-  p[ 16] = +.11154076712774300110e+00;
-  p[ 17] = +.92927195315124537686e-01;
-  p[ 18] = +.37889705326277359705e+00;
-  p[ 19] = +.17151190913639138079e+00;
-  p[ 20] = +.77661331357103311837e+00;
-  p[ 21] = +.21915685840158749640e+00;
+    /* 14 */ +.61680367872449777899e-02,
+    /* 15 */ +.17001719629940260339e-01,
+    /* 16 */ +.11154076712774300110e+00,
+    /* 17 */ +.92927195315124537686e-01,
+    /* 18 */ +.37889705326277359705e+00,
+    /* 19 */ +.17151190913639138079e+00,
+    /* 20 */ +.77661331357103311837e+00,
+    /* 21 */ +.21915685840158749640e+00,
 
 
 
-  //
-  // 31-point formula.
-  //
+    //
+    // 31-point formula.
+    //
 
-  // Corrections for F(1,1), F(2,1), F(3,1-2), F(4,1-4).
+    // Corrections for F(1,1), F(2,1), F(3,1-2), F(4,1-4).
   
-  p[ 22] = +.68216653479200000000e-08; 
-  p[ 23] = +.12667409859336000000e-06; 
-  p[ 24] = +.59565976367837165000e-05;  
-  p[ 25] = +.13923301068260000000e-07;  
-  p[ 26] = -.66294075649023920000e-04; 
-  p[ 27] = -.70439580428230200000e-06; 
-  p[ 28] = -.34518205339241000000e-07;  
-  p[ 29] = -.81448691099600000000e-08;
+    /* 22 */ +.68216653479200000000e-08, 
+    /* 23 */ +.12667409859336000000e-06, 
+    /* 24 */ +.59565976367837165000e-05,  
+    /* 25 */ +.13923301068260000000e-07,  
+    /* 26 */ -.66294075649023920000e-04, 
+    /* 27 */ -.70439580428230200000e-06, 
+    /* 28 */ -.34518205339241000000e-07,  
+    /* 29 */ -.81448691099600000000e-08,
   
-  // Nodes and weights for F(5,1-8).
+    // Nodes and weights for F(5,1-8).
   
-  p[ 30] = +.90187503233240234038e-03;
-  p[ 31] = +.25447807915618744154e-02;
-  p[ 32] = +.18468850446259893130e-01;
-  p[ 33] = +.16446049854387810934e-01;
-  p[ 34] = +.70345142570259943330e-01;
-  p[ 35] = +.35957103307129322097e-01;
-  p[ 36] = +.16327406183113126449e+00;
-  p[ 37] = +.56979509494123357412e-01;
-  p[ 38] = +.29750379350847292139e+00;
-  p[ 39] = +.76879620499003531043e-01;
-  p[ 40] = +.46868025635562437602e+00;
-  p[ 41] = +.93627109981264473617e-01;
-  p[ 42] = +.66886460674202316691e+00;
-  p[ 43] = +.10566989358023480974e+00;
-  p[ 44] = +.88751105686681337425e+00;
-  p[ 45] = +.11195687302095345688e+00;
+    /* 30 */ +.90187503233240234038e-03,
+    /* 31 */ +.25447807915618744154e-02,
+    /* 32 */ +.18468850446259893130e-01,
+    /* 33 */ +.16446049854387810934e-01,
+    /* 34 */ +.70345142570259943330e-01,
+    /* 35 */ +.35957103307129322097e-01,
+    /* 36 */ +.16327406183113126449e+00,
+    /* 37 */ +.56979509494123357412e-01,
+    /* 38 */ +.29750379350847292139e+00,
+    /* 39 */ +.76879620499003531043e-01,
+    /* 40 */ +.46868025635562437602e+00,
+    /* 41 */ +.93627109981264473617e-01,
+    /* 42 */ +.66886460674202316691e+00,
+    /* 43 */ +.10566989358023480974e+00,
+    /* 44 */ +.88751105686681337425e+00,
+    /* 45 */ +.11195687302095345688e+00,
 
   
 
-  //
-  // 63-point formula.
-  //
+    //
+    // 63-point formula.
+    //
 
-  // Corrections for F(1,1), F(2,1), F(3,1-2), F(4,1-4), F(5,1-8).
+    // Corrections for F(1,1), F(2,1), F(3,1-2), F(4,1-4), F(5,1-8).
   
-  p[ 46] = +.37158300000000000000e-15; 
-  p[ 47] = +.21237877000000000000e-12; 
-  p[ 48] = +.10522629388435000000e-08; 
-  p[ 49] = +.17480290000000000000e-14; 
-  p[ 50] = +.34757189830171600000e-06;
-  p[ 51] = +.90312761725000000000e-11;
-  p[ 52] = +.12558916000000000000e-13;
-  p[ 53] = +.54591000000000000000e-15;
-  p[ 54] = -.72338395508691963000e-05;
-  p[ 55] = -.16969957975797700000e-07;
-  p[ 56] = -.85436390715500000000e-10;
-  p[ 57] = -.12281300930000000000e-11;
-  p[ 58] = -.46233482500000000000e-13;
-  p[ 59] = -.42244055000000000000e-14;
-  p[ 60] = -.88501000000000000000e-15;
-  p[ 61] = -.40904000000000000000e-15;
+    /* 46 */ +.37158300000000000000e-15, 
+    /* 47 */ +.21237877000000000000e-12, 
+    /* 48 */ +.10522629388435000000e-08, 
+    /* 49 */ +.17480290000000000000e-14, 
+    /* 50 */ +.34757189830171600000e-06,
+    /* 51 */ +.90312761725000000000e-11,
+    /* 52 */ +.12558916000000000000e-13,
+    /* 53 */ +.54591000000000000000e-15,
+    /* 54 */ -.72338395508691963000e-05,
+    /* 55 */ -.16969957975797700000e-07,
+    /* 56 */ -.85436390715500000000e-10,
+    /* 57 */ -.12281300930000000000e-11,
+    /* 58 */ -.46233482500000000000e-13,
+    /* 59 */ -.42244055000000000000e-14,
+    /* 60 */ -.88501000000000000000e-15,
+    /* 61 */ -.40904000000000000000e-15,
   
-  // Nodes and weights for F(6,1-16).
+    // Nodes and weights for F(6,1-16).
 
-  p[ 62] = +.12711187964238806027e-03;
-  p[ 63] = +.36322148184553065969e-03;
-  p[ 64] = +.27937406277780409196e-02;
-  p[ 65] = +.25790497946856882724e-02;
-  p[ 66] = +.11315242452570520059e-01;
-  p[ 67] = +.61155068221172463397e-02;
-  p[ 68] = +.27817125251418203419e-01;
-  p[ 69] = +.10498246909621321898e-01;
-  p[ 70] = +.53657141626597094849e-01;
-  p[ 71] = +.15406750466559497802e-01;
-  p[ 72] = +.89628843042995707499e-01;
-  p[ 73] = +.20594233915912711149e-01;
-  p[ 74] = +.13609206180630952284e+00;
-  p[ 75] = +.25869679327214746911e-01;
-  p[ 76] = +.19305946804978238813e+00;
-  p[ 77] = +.31073551111687964880e-01;
-  p[ 78] = +.26024395564730524132e+00;
-  p[ 79] = +.36064432780782572640e-01;
-  p[ 80] = +.33709033997521940454e+00;
-  p[ 81] = +.40715510116944318934e-01;
-  p[ 82] = +.42280428994795418516e+00;
-  p[ 83] = +.44914531653632197414e-01;
-  p[ 84] = +.51638197305415897244e+00;
-  p[ 85] = +.48564330406673198716e-01;
-  p[ 86] = +.61664067580126965307e+00;
-  p[ 87] = +.51583253952048458777e-01;
-  p[ 88] = +.72225017797817568492e+00;
-  p[ 89] = +.53905499335266063927e-01;
-  p[ 90] = +.83176474844779253501e+00;
-  p[ 91] = +.55481404356559363988e-01;
-  p[ 92] = +.94365568695340721002e+00;
-  p[ 93] = +.56277699831254301273e-01;
+    /* 62 */ +.12711187964238806027e-03,
+    /* 63 */ +.36322148184553065969e-03,
+    /* 64 */ +.27937406277780409196e-02,
+    /* 65 */ +.25790497946856882724e-02,
+    /* 66 */ +.11315242452570520059e-01,
+    /* 67 */ +.61155068221172463397e-02,
+    /* 68 */ +.27817125251418203419e-01,
+    /* 69 */ +.10498246909621321898e-01,
+    /* 70 */ +.53657141626597094849e-01,
+    /* 71 */ +.15406750466559497802e-01,
+    /* 72 */ +.89628843042995707499e-01,
+    /* 73 */ +.20594233915912711149e-01,
+    /* 74 */ +.13609206180630952284e+00,
+    /* 75 */ +.25869679327214746911e-01,
+    /* 76 */ +.19305946804978238813e+00,
+    /* 77 */ +.31073551111687964880e-01,
+    /* 78 */ +.26024395564730524132e+00,
+    /* 79 */ +.36064432780782572640e-01,
+    /* 80 */ +.33709033997521940454e+00,
+    /* 81 */ +.40715510116944318934e-01,
+    /* 82 */ +.42280428994795418516e+00,
+    /* 83 */ +.44914531653632197414e-01,
+    /* 84 */ +.51638197305415897244e+00,
+    /* 85 */ +.48564330406673198716e-01,
+    /* 86 */ +.61664067580126965307e+00,
+    /* 87 */ +.51583253952048458777e-01,
+    /* 88 */ +.72225017797817568492e+00,
+    /* 89 */ +.53905499335266063927e-01,
+    /* 90 */ +.83176474844779253501e+00,
+    /* 91 */ +.55481404356559363988e-01,
+    /* 92 */ +.94365568695340721002e+00,
+    /* 93 */ +.56277699831254301273e-01,
 
 
 
-  //
-  // 127-point formula.
-  //
+    //
+    // 127-point formula.
+    //
 
-  // Corrections for F(3,1), F(4,1-2), F(5,1-3), F(6,1-6).
+    // Corrections for F(3,1), F(4,1-2), F(5,1-3), F(6,1-6).
   
-  p[ 94] = +.10410980000000000000e-15;
-  p[ 95] = +.24947205459800000000e-10;
-  p[ 96] = +.55000000000000000000e-20;
-  p[ 97] = +.29041247599538500000e-07;
-  p[ 98] = +.36728212600000000000e-13;
-  p[ 99] = +.55680000000000000000e-18;
-  p[100] = -.87117647737697202500e-06;
-  p[101] = -.81473242674410000000e-09;
-  p[102] = -.88309203370000000000e-12;
-  p[103] = -.18018239000000000000e-14;
-  p[104] = -.70528000000000000000e-17;
-  p[105] = -.50600000000000000000e-19;
+    /* 94 */ +.10410980000000000000e-15,
+    /* 95 */ +.24947205459800000000e-10,
+    /* 96 */ +.55000000000000000000e-20,
+    /* 97 */ +.29041247599538500000e-07,
+    /* 98 */ +.36728212600000000000e-13,
+    /* 99 */ +.55680000000000000000e-18,
+    /*100 */ -.87117647737697202500e-06,
+    /*101 */ -.81473242674410000000e-09,
+    /*102 */ -.88309203370000000000e-12,
+    /*103 */ -.18018239000000000000e-14,
+    /*104 */ -.70528000000000000000e-17,
+    /*105 */ -.50600000000000000000e-19,
        
-  // Nodes and weights for F(7,1-32).
+    // Nodes and weights for F(7,1-32).
 
-  p[106] = +.17569645108401419961e-04;
-  p[107] = +.50536095207862517625e-04;
-  p[108] = +.40120032808931675009e-03;
-  p[109] = +.37774664632698466027e-03;
-  p[110] = +.16833646815926074696e-02;
-  p[111] = +.93836984854238150079e-03;
-  p[112] = +.42758953015928114900e-02;
-  p[113] = +.16811428654214699063e-02;
-  p[114] = +.85042788218938676006e-02;
-  p[115] = +.25687649437940203731e-02;
-  p[116] = +.14628500401479628890e-01;
-  p[117] = +.35728927835172996494e-02;
-  p[118] = +.22858485360294285840e-01;
-  p[119] = +.46710503721143217474e-02;
-  p[120] = +.33362148441583432910e-01;
-  p[121] = +.58434498758356395076e-02;
-  p[122] = +.46269993574238863589e-01;
-  p[123] = +.70724899954335554680e-02;
-  p[124] = +.61679602220407116350e-01;
-  p[125] = +.83428387539681577056e-02;
-  p[126] = +.79659974529987579270e-01;
-  p[127] = +.96411777297025366953e-02;
-  p[128] = +.10025510022305996335e+00;
-  p[129] = +.10955733387837901648e-01;
-  p[130] = +.12348658551529473026e+00;
-  p[131] = +.12275830560082770087e-01;
-  p[132] = +.14935550523164972024e+00;
-  p[133] = +.13591571009765546790e-01;
-  p[134] = +.17784374563501959262e+00;
-  p[135] = +.14893641664815182035e-01;
-  p[136] = +.20891506620015163857e+00;
-  p[137] = +.16173218729577719942e-01;
-  p[138] = +.24251603361948636206e+00;
-  p[139] = +.17421930159464173747e-01;
-  p[140] = +.27857691462990108452e+00;
-  p[141] = +.18631848256138790186e-01;
-  p[142] = +.31701256890892077191e+00;
-  p[143] = +.19795495048097499488e-01;
-  p[144] = +.35772335749024048622e+00;
-  p[145] = +.20905851445812023852e-01;
-  p[146] = +.40059606975775710702e+00;
-  p[147] = +.21956366305317824939e-01;
-  p[148] = +.44550486736806745112e+00;
-  p[149] = +.22940964229387748761e-01;
-  p[150] = +.49231224246628339785e+00;
-  p[151] = +.23854052106038540080e-01;
-  p[152] = +.54086998801016766712e+00;
-  p[153] = +.24690524744487676909e-01;
-  p[154] = +.59102017877011132759e+00;
-  p[155] = +.25445769965464765813e-01;
-  p[156] = +.64259616216846784762e+00;
-  p[157] = +.26115673376706097680e-01;
-  p[158] = +.69542355844328595666e+00;
-  p[159] = +.26696622927450359906e-01;
-  p[160] = +.74932126969651682339e+00;
-  p[161] = +.27185513229624791819e-01;
-  p[162] = +.80410249728889984607e+00;
-  p[163] = +.27579749566481873035e-01;
-  p[164] = +.85957576684743982540e+00;
-  p[165] = +.27877251476613701609e-01;
-  p[166] = +.91554595991628911629e+00;
-  p[167] = +.28076455793817246607e-01;
-  p[168] = +.97181535105025430566e+00;
-  p[169] = +.28176319033016602131e-01;
+    /*106 */ +.17569645108401419961e-04,
+    /*107 */ +.50536095207862517625e-04,
+    /*108 */ +.40120032808931675009e-03,
+    /*109 */ +.37774664632698466027e-03,
+    /*110 */ +.16833646815926074696e-02,
+    /*111 */ +.93836984854238150079e-03,
+    /*112 */ +.42758953015928114900e-02,
+    /*113 */ +.16811428654214699063e-02,
+    /*114 */ +.85042788218938676006e-02,
+    /*115 */ +.25687649437940203731e-02,
+    /*116 */ +.14628500401479628890e-01,
+    /*117 */ +.35728927835172996494e-02,
+    /*118 */ +.22858485360294285840e-01,
+    /*119 */ +.46710503721143217474e-02,
+    /*120 */ +.33362148441583432910e-01,
+    /*121 */ +.58434498758356395076e-02,
+    /*122 */ +.46269993574238863589e-01,
+    /*123 */ +.70724899954335554680e-02,
+    /*124 */ +.61679602220407116350e-01,
+    /*125 */ +.83428387539681577056e-02,
+    /*126 */ +.79659974529987579270e-01,
+    /*127 */ +.96411777297025366953e-02,
+    /*128 */ +.10025510022305996335e+00,
+    /*129 */ +.10955733387837901648e-01,
+    /*130 */ +.12348658551529473026e+00,
+    /*131 */ +.12275830560082770087e-01,
+    /*132 */ +.14935550523164972024e+00,
+    /*133 */ +.13591571009765546790e-01,
+    /*134 */ +.17784374563501959262e+00,
+    /*135 */ +.14893641664815182035e-01,
+    /*136 */ +.20891506620015163857e+00,
+    /*137 */ +.16173218729577719942e-01,
+    /*138 */ +.24251603361948636206e+00,
+    /*139 */ +.17421930159464173747e-01,
+    /*140 */ +.27857691462990108452e+00,
+    /*141 */ +.18631848256138790186e-01,
+    /*142 */ +.31701256890892077191e+00,
+    /*143 */ +.19795495048097499488e-01,
+    /*144 */ +.35772335749024048622e+00,
+    /*145 */ +.20905851445812023852e-01,
+    /*146 */ +.40059606975775710702e+00,
+    /*147 */ +.21956366305317824939e-01,
+    /*148 */ +.44550486736806745112e+00,
+    /*149 */ +.22940964229387748761e-01,
+    /*150 */ +.49231224246628339785e+00,
+    /*151 */ +.23854052106038540080e-01,
+    /*152 */ +.54086998801016766712e+00,
+    /*153 */ +.24690524744487676909e-01,
+    /*154 */ +.59102017877011132759e+00,
+    /*155 */ +.25445769965464765813e-01,
+    /*156 */ +.64259616216846784762e+00,
+    /*157 */ +.26115673376706097680e-01,
+    /*158 */ +.69542355844328595666e+00,
+    /*159 */ +.26696622927450359906e-01,
+    /*160 */ +.74932126969651682339e+00,
+    /*161 */ +.27185513229624791819e-01,
+    /*162 */ +.80410249728889984607e+00,
+    /*163 */ +.27579749566481873035e-01,
+    /*164 */ +.85957576684743982540e+00,
+    /*165 */ +.27877251476613701609e-01,
+    /*166 */ +.91554595991628911629e+00,
+    /*167 */ +.28076455793817246607e-01,
+    /*168 */ +.97181535105025430566e+00,
+    /*169 */ +.28176319033016602131e-01,
 
 
 
-  //
-  // 255-point formula.
-  //
+    //
+    // 255-point formula.
+    //
 
-  // Corrections for F(4,1), F(5,1), F(6,1-2), F(7,1-4).
+    // Corrections for F(4,1), F(5,1), F(6,1-2), F(7,1-4).
   
-  p[170] = +.33260000000000000000e-18;
-  p[171] = +.11409477047800000000e-11;
-  p[172] = +.29524360569703510000e-08;
-  p[173] = +.51608328000000000000e-15;
-  p[174] = -.11017721965059732300e-06;
-  p[175] = -.58656987416475000000e-10;
-  p[176] = -.23340340645000000000e-13;
-  p[177] = -.12489500000000000000e-16;
+    /*170 */ +.33260000000000000000e-18,
+    /*171 */ +.11409477047800000000e-11,
+    /*172 */ +.29524360569703510000e-08,
+    /*173 */ +.51608328000000000000e-15,
+    /*174 */ -.11017721965059732300e-06,
+    /*175 */ -.58656987416475000000e-10,
+    /*176 */ -.23340340645000000000e-13,
+    /*177 */ -.12489500000000000000e-16,
   
-  // Nodes and weights for F(8,1-64).
+    // Nodes and weights for F(8,1-64).
   
-  p[178] = +.24036202515353807630e-05;
-  p[179] = +.69379364324108267170e-05;
-  p[180] = +.56003792945624240417e-04;
-  p[181] = +.53275293669780613125e-04;
-  p[182] = +.23950907556795267013e-03;
-  p[183] = +.13575491094922871973e-03;
-  p[184] = +.61966197497641806982e-03;
-  p[185] = +.24921240048299729402e-03;
-  p[186] = +.12543855319048853002e-02;
-  p[187] = +.38974528447328229322e-03;
-  p[188] = +.21946455040427254399e-02;
-  p[189] = +.55429531493037471492e-03;
-  p[190] = +.34858540851097261500e-02;
-  p[191] = +.74028280424450333046e-03;
-  p[192] = +.51684971993789994803e-02;
-  p[193] = +.94536151685852538246e-03;
-  p[194] = +.72786557172113846706e-02;
-  p[195] = +.11674841174299594077e-02;
-  p[196] = +.98486295992298408193e-02;
-  p[197] = +.14049079956551446427e-02;
-  p[198] = +.12907472045965932809e-01;
-  p[199] = +.16561127281544526052e-02;
-  p[200] = +.16481342421367271240e-01;
-  p[201] = +.19197129710138724125e-02;
-  p[202] = +.20593718329137316189e-01;
-  p[203] = +.21944069253638388388e-02;
-  p[204] = +.25265540247597332240e-01;
-  p[205] = +.24789582266575679307e-02;
-  p[206] = +.30515340497540768229e-01;
-  p[207] = +.27721957645934509940e-02;
-  p[208] = +.36359378430187867480e-01;
-  p[209] = +.30730184347025783234e-02;
-  p[210] = +.42811783890139037259e-01;
-  p[211] = +.33803979910869203823e-02;
-  p[212] = +.49884702478705123440e-01;
-  p[213] = +.36933779170256508183e-02;
-  p[214] = +.57588434808916940190e-01;
-  p[215] = +.40110687240750233989e-02;
-  p[216] = +.65931563842274211999e-01;
-  p[217] = +.43326409680929828545e-02;
-  p[218] = +.74921067092924347640e-01;
-  p[219] = +.46573172997568547773e-02;
-  p[220] = +.84562412844234959360e-01;
-  p[221] = +.49843645647655386012e-02;
-  p[222] = +.94859641186738404810e-01;
-  p[223] = +.53130866051870565663e-02;
-  p[224] = +.10581543166444097714e+00;
-  p[225] = +.56428181013844441585e-02;
-  p[226] = +.11743115975265809315e+00;
-  p[227] = +.59729195655081658049e-02;
-  p[228] = +.12970694445188609414e+00;
-  p[229] = +.63027734490857587172e-02;
-  p[230] = +.14264168911376784347e+00;
-  p[231] = +.66317812429018878941e-02;
-  p[232] = +.15623311732729139895e+00;
-  p[233] = +.69593614093904229394e-02;
-  p[234] = +.17047780536259859981e+00;
-  p[235] = +.72849479805538070639e-02;
-  p[236] = +.18537121234486258656e+00;
-  p[237] = +.76079896657190565832e-02;
-  p[238] = +.20090770903915859819e+00;
-  p[239] = +.79279493342948491103e-02;
-  p[240] = +.21708060588171698360e+00;
-  p[241] = +.82443037630328680306e-02;
-  p[242] = +.23388218069623990928e+00;
-  p[243] = +.85565435613076896192e-02;
-  p[244] = +.25130370638306339718e+00;
-  p[245] = +.88641732094824942641e-02;
-  p[246] = +.26933547875781873867e+00;
-  p[247] = +.91667111635607884067e-02;
-  p[248] = +.28796684463774796540e+00;
-  p[249] = +.94636899938300652943e-02;
-  p[250] = +.30718623022088529711e+00;
-  p[251] = +.97546565363174114611e-02;
-  p[252] = +.32698116976958152079e+00;
-  p[253] = +.10039172044056840798e-01;
-  p[254] = +.34733833458998250389e+00;
-  p[255] = +.10316812330947621682e-01;
-  p[256] = +.36824356228880576959e+00;
-  p[257] = +.10587167904885197931e-01;
-  p[258] = +.38968188628481359983e+00;
-  p[259] = +.10849844089337314099e-01;
-  p[260] = +.41163756555233745857e+00;
-  p[261] = +.11104461134006926537e-01;
-  p[262] = +.43409411457634557737e+00;
-  p[263] = +.11350654315980596602e-01;
-  p[264] = +.45703433350168850951e+00;
-  p[265] = +.11588074033043952568e-01;
-  p[266] = +.48044033846254297801e+00;
-  p[267] = +.11816385890830235763e-01;
-  p[268] = +.50429359208123853983e+00;
-  p[269] = +.12035270785279562630e-01;
-  p[270] = +.52857493412834112307e+00;
-  p[271] = +.12244424981611985899e-01;
-  p[272] = +.55326461233797152625e+00;
-  p[273] = +.12443560190714035263e-01;
-  p[274] = +.57834231337383669993e+00;
-  p[275] = +.12632403643542078765e-01;
-  p[276] = +.60378719394238406082e+00;
-  p[277] = +.12810698163877361967e-01;
-  p[278] = +.62957791204992176986e+00;
-  p[279] = +.12978202239537399286e-01;
-  p[280] = +.65569265840056197721e+00;
-  p[281] = +.13134690091960152836e-01;
-  p[282] = +.68210918793152331682e+00;
-  p[283] = +.13279951743930530650e-01;
-  p[284] = +.70880485148175331803e+00;
-  p[285] = +.13413793085110098513e-01;
-  p[286] = +.73575662758907323806e+00;
-  p[287] = +.13536035934956213614e-01;
-  p[288] = +.76294115441017027278e+00;
-  p[289] = +.13646518102571291428e-01;
-  p[290] = +.79033476175681880523e+00;
-  p[291] = +.13745093443001896632e-01;
-  p[292] = +.81791350324074780175e+00;
-  p[293] = +.13831631909506428676e-01;
-  p[294] = +.84565318851862189130e+00;
-  p[295] = +.13906019601325461264e-01;
-  p[296] = +.87352941562769803314e+00;
-  p[297] = +.13968158806516938516e-01;
-  p[298] = +.90151760340188079791e+00;
-  p[299] = +.14017968039456608810e-01;
-  p[300] = +.92959302395714482093e+00;
-  p[301] = +.14055382072649964277e-01;
-  p[302] = +.95773083523463639678e+00;
-  p[303] = +.14080351962553661325e-01;
-  p[304] = +.98590611358921753738e+00;
-  p[305] = +.14092845069160408355e-01;
+    /*178 */ +.24036202515353807630e-05,
+    /*179 */ +.69379364324108267170e-05,
+    /*180 */ +.56003792945624240417e-04,
+    /*181 */ +.53275293669780613125e-04,
+    /*182 */ +.23950907556795267013e-03,
+    /*183 */ +.13575491094922871973e-03,
+    /*184 */ +.61966197497641806982e-03,
+    /*185 */ +.24921240048299729402e-03,
+    /*186 */ +.12543855319048853002e-02,
+    /*187 */ +.38974528447328229322e-03,
+    /*188 */ +.21946455040427254399e-02,
+    /*189 */ +.55429531493037471492e-03,
+    /*190 */ +.34858540851097261500e-02,
+    /*191 */ +.74028280424450333046e-03,
+    /*192 */ +.51684971993789994803e-02,
+    /*193 */ +.94536151685852538246e-03,
+    /*194 */ +.72786557172113846706e-02,
+    /*195 */ +.11674841174299594077e-02,
+    /*196 */ +.98486295992298408193e-02,
+    /*197 */ +.14049079956551446427e-02,
+    /*198 */ +.12907472045965932809e-01,
+    /*199 */ +.16561127281544526052e-02,
+    /*200 */ +.16481342421367271240e-01,
+    /*201 */ +.19197129710138724125e-02,
+    /*202 */ +.20593718329137316189e-01,
+    /*203 */ +.21944069253638388388e-02,
+    /*204 */ +.25265540247597332240e-01,
+    /*205 */ +.24789582266575679307e-02,
+    /*206 */ +.30515340497540768229e-01,
+    /*207 */ +.27721957645934509940e-02,
+    /*208 */ +.36359378430187867480e-01,
+    /*209 */ +.30730184347025783234e-02,
+    /*210 */ +.42811783890139037259e-01,
+    /*211 */ +.33803979910869203823e-02,
+    /*212 */ +.49884702478705123440e-01,
+    /*213 */ +.36933779170256508183e-02,
+    /*214 */ +.57588434808916940190e-01,
+    /*215 */ +.40110687240750233989e-02,
+    /*216 */ +.65931563842274211999e-01,
+    /*217 */ +.43326409680929828545e-02,
+    /*218 */ +.74921067092924347640e-01,
+    /*219 */ +.46573172997568547773e-02,
+    /*220 */ +.84562412844234959360e-01,
+    /*221 */ +.49843645647655386012e-02,
+    /*222 */ +.94859641186738404810e-01,
+    /*223 */ +.53130866051870565663e-02,
+    /*224 */ +.10581543166444097714e+00,
+    /*225 */ +.56428181013844441585e-02,
+    /*226 */ +.11743115975265809315e+00,
+    /*227 */ +.59729195655081658049e-02,
+    /*228 */ +.12970694445188609414e+00,
+    /*229 */ +.63027734490857587172e-02,
+    /*230 */ +.14264168911376784347e+00,
+    /*231 */ +.66317812429018878941e-02,
+    /*232 */ +.15623311732729139895e+00,
+    /*233 */ +.69593614093904229394e-02,
+    /*234 */ +.17047780536259859981e+00,
+    /*235 */ +.72849479805538070639e-02,
+    /*236 */ +.18537121234486258656e+00,
+    /*237 */ +.76079896657190565832e-02,
+    /*238 */ +.20090770903915859819e+00,
+    /*239 */ +.79279493342948491103e-02,
+    /*240 */ +.21708060588171698360e+00,
+    /*241 */ +.82443037630328680306e-02,
+    /*242 */ +.23388218069623990928e+00,
+    /*243 */ +.85565435613076896192e-02,
+    /*244 */ +.25130370638306339718e+00,
+    /*245 */ +.88641732094824942641e-02,
+    /*246 */ +.26933547875781873867e+00,
+    /*247 */ +.91667111635607884067e-02,
+    /*248 */ +.28796684463774796540e+00,
+    /*249 */ +.94636899938300652943e-02,
+    /*250 */ +.30718623022088529711e+00,
+    /*251 */ +.97546565363174114611e-02,
+    /*252 */ +.32698116976958152079e+00,
+    /*253 */ +.10039172044056840798e-01,
+    /*254 */ +.34733833458998250389e+00,
+    /*255 */ +.10316812330947621682e-01,
+    /*256 */ +.36824356228880576959e+00,
+    /*257 */ +.10587167904885197931e-01,
+    /*258 */ +.38968188628481359983e+00,
+    /*259 */ +.10849844089337314099e-01,
+    /*260 */ +.41163756555233745857e+00,
+    /*261 */ +.11104461134006926537e-01,
+    /*262 */ +.43409411457634557737e+00,
+    /*263 */ +.11350654315980596602e-01,
+    /*264 */ +.45703433350168850951e+00,
+    /*265 */ +.11588074033043952568e-01,
+    /*266 */ +.48044033846254297801e+00,
+    /*267 */ +.11816385890830235763e-01,
+    /*268 */ +.50429359208123853983e+00,
+    /*269 */ +.12035270785279562630e-01,
+    /*270 */ +.52857493412834112307e+00,
+    /*271 */ +.12244424981611985899e-01,
+    /*272 */ +.55326461233797152625e+00,
+    /*273 */ +.12443560190714035263e-01,
+    /*274 */ +.57834231337383669993e+00,
+    /*275 */ +.12632403643542078765e-01,
+    /*276 */ +.60378719394238406082e+00,
+    /*277 */ +.12810698163877361967e-01,
+    /*278 */ +.62957791204992176986e+00,
+    /*279 */ +.12978202239537399286e-01,
+    /*280 */ +.65569265840056197721e+00,
+    /*281 */ +.13134690091960152836e-01,
+    /*282 */ +.68210918793152331682e+00,
+    /*283 */ +.13279951743930530650e-01,
+    /*284 */ +.70880485148175331803e+00,
+    /*285 */ +.13413793085110098513e-01,
+    /*286 */ +.73575662758907323806e+00,
+    /*287 */ +.13536035934956213614e-01,
+    /*288 */ +.76294115441017027278e+00,
+    /*289 */ +.13646518102571291428e-01,
+    /*290 */ +.79033476175681880523e+00,
+    /*291 */ +.13745093443001896632e-01,
+    /*292 */ +.81791350324074780175e+00,
+    /*293 */ +.13831631909506428676e-01,
+    /*294 */ +.84565318851862189130e+00,
+    /*295 */ +.13906019601325461264e-01,
+    /*296 */ +.87352941562769803314e+00,
+    /*297 */ +.13968158806516938516e-01,
+    /*298 */ +.90151760340188079791e+00,
+    /*299 */ +.14017968039456608810e-01,
+    /*300 */ +.92959302395714482093e+00,
+    /*301 */ +.14055382072649964277e-01,
+    /*302 */ +.95773083523463639678e+00,
+    /*303 */ +.14080351962553661325e-01,
+    /*304 */ +.98590611358921753738e+00,
+    /*305 */ +.14092845069160408355e-01,
+  };
@@ -149,11 +149,26 @@ vector<Complex> patterson_z_n(ComplexFunction& f,
     int j1=fl[k];
     int j2=fh[k];
 
+    // Evaluate the function in all the new abscissae at once.
+
+    const int n_new = 2*(jh-jl+1);
+
+    vector<Complex> z_new(n_new), f_new(n_new);
+
+    for (int j=jl, ip_j=ip; j<=jh; j++, ip_j+=2)
+    {
+      Complex t = p[ip_j]*0.5;
+      z_new[2*(j-jl)  ] = a +      t *delta;
+      z_new[2*(j-jl)+1] = a + (1.0-t)*delta;
+    }
+
+    f.evaluate(&z_new[0], &f_new[0], n_new);
+
     for (int j=jl; j<=jh; j++)
     {
       Complex t = p[ip++]*0.5;
-      Complex f1 = 1.0 / f(a +      t *delta);
-      Complex f2 = 1.0 / f(a + (1.0-t)*delta);
+      Complex f1 = 1.0 / f_new[2*(j-jl)  ];
+      Complex f2 = 1.0 / f_new[2*(j-jl)+1];
 
       //if (abs(f1) > 1e3)
       //  cout << "Possible zero for " << a+t*delta << endl;
@@ -25,39 +25,73 @@ cVector fourier(const vector<Complex>& f, const vector<Complex>& disc,
   Complex D = d ? *d : disc.back() - disc.front();
   if (extend)
     D *= 2.0;
-  Complex K = 2.*pi/D;
 
   cVector result(2*M+1,fortranArray);
+  result = 0.0;
+
+  if (abs(D) < 1e-12)
+    return result;
+
+  const Complex K = 2.*pi/D;
+
+  // m = 0: average of f.
 
-  for (int m=-M; m<=M; m++)
+  for (unsigned int k=0; k<disc.size()-1; k++)
+    result(M+1) += (disc[k+1]-disc[k]) * f[k] * (extend ? 2.0 : 1.0);
+
+  // m != 0: since f is piecewise constant, the integral is a sum over
+  // the discontinuities x_k of the jump in f times exp(t.x_k)/t, with
+  // t = -j.m.K. The exponentials for successive m are powers of
+  // exp(-j.K.x_k), which we obtain by recurrence, reseeded every so
+  // often to avoid the build up of round off error.
+
+  const int reseed = 32;
+
+  cVector pos(M,fortranArray); pos = 0.0; // Sum of jump.exp(-j.m.K.x)
+  cVector neg(M,fortranArray); neg = 0.0; // Sum of jump.exp(+j.m.K.x)
+
+  for (unsigned int k=0; k<disc.size(); k++)
   {
-    Complex result_m = 0.0;
+    const Complex f_left  = (k > 0)             ? f[k-1] : 0.0;
+    const Complex f_right = (k < disc.size()-1) ? f[k]   : 0.0;
 
-    for (unsigned int k=0; k<int(disc.size()-1); k++)
-    { 
-      Complex factor;
-      if (m==0)
-      { 
-        factor = disc[k+1]-disc[k];
-        if (extend)
-          factor *= 2.0;
+    const Complex jump = f_left - f_right;
+
+    if (abs(jump) == 0.0)
+      continue;
+
+    const Complex z = exp(-I*K*disc[k]);
+    const Complex z_inv = 1.0/z;
+
+    Complex e = 1.0, e_inv = 1.0;
+
+    for (int m=1; m<=M; m++)
+    {
+      if (m % reseed == 0)
+      {
+        e     = exp(-I*Real(m)*K*disc[k]);
+        e_inv = exp( I*Real(m)*K*disc[k]);
       }
       else
       {
-        const Complex t = -I*Real(m)*K;
-        factor = (exp(t*disc[k+1])-exp(t*disc[k])) / t;
-        if (extend)
-          factor += (exp(-t*disc[k])-exp(-t*disc[k+1])) / t;
+        e     *= z;
+        e_inv *= z_inv;
       }
 
-      result_m += factor * f[k];
+      pos(m) += jump * e;
+      neg(m) += jump * e_inv;
     }
-    
-    result(m+M+1) = result_m / D;
   }
 
-  if (abs(D) < 1e-12)
-    result = 0.0;
+  for (int m=1; m<=M; m++)
+  {
+    const Complex t = -I*Real(m)*K;
+
+    result(M+1+m) =  (pos(m) - (extend ? neg(m) : 0.0)) / t;
+    result(M+1-m) = -(neg(m) - (extend ? pos(m) : 0.0)) / t;
+  }
+
+  result /= D;
   
   return result;
 }
@@ -479,12 +513,49 @@ cMatrix fourier_2D_split(const vector<Complex>& disc_x,
 {
   const Complex Lx = disc_x.back() - disc_x.front();
 
+  // Strips with the same y profile share the same inverted Toeplitz
+  // matrix, so we add up their x transforms first.
+
+  vector<unsigned int> profile; // Index of first strip with this profile.
+  vector<cVector> sum_x;        // Sum of x transforms of these strips.
+
+  for (unsigned int i=0; i<disc_x.size()-1; i++)
+  {
+    // Calculate pseudo 1D fourier transform in x direction.
+
+    vector<Complex> disc_i_x;
+    disc_i_x.push_back(disc_x[i]);
+    disc_i_x.push_back(disc_x[i+1]);
+
+    vector<Complex> f_i_x; 
+    f_i_x.push_back(1.0);
+
+    cVector fourier_1D_x(4*M+1,fortranArray);
+    fourier_1D_x = fourier(f_i_x, disc_i_x, 2*M, &Lx, extend);
+
+    unsigned int p = 0;
+    while ( (p < profile.size()) && ( (f[profile[p]] != f[i]) 
+                                   || (disc_y[profile[p]] != disc_y[i]) ) )
+      p++;
+
+    if (p == profile.size())
+    {
+      profile.push_back(i);
+      sum_x.push_back(cVector(4*M+1,fortranArray));
+      sum_x.back() = 0.0;
+    }
+
+    sum_x[p] += fourier_1D_x;
+  }
+
   const int MN = (2*M+1)*(2*N+1); 
   cMatrix result(MN,MN,fortranArray);
   result = 0.0;
 
-  for (int i=0; i<disc_x.size()-1; i++)
+  for (unsigned int p=0; p<profile.size(); p++)
   {
+    const unsigned int i = profile[p];
+
     // Calculate 1D fourier transform of f(y) profile in this strip.
 
     cVector fourier_1D_y(4*N+1,fortranArray);   
@@ -500,33 +571,19 @@ cMatrix fourier_2D_split(const vector<Complex>& disc_x,
     cMatrix inv_f_toep(2*N+1,2*N+1,fortranArray);
     inv_f_toep.reference(invert(f_toep)); // TODO: exploit Toeplitz.
 
-    // Calculate pseudo 1D fourier transform in x direction.
-
-    vector<Complex> disc_i_x;
-    disc_i_x.push_back(disc_x[i]);
-    disc_i_x.push_back(disc_x[i+1]);
-
-    vector<Complex> f_i_x; 
-    f_i_x.push_back(1.0);
-
-    cVector fourier_1D_x(4*M+1,fortranArray);
-    fourier_1D_x = fourier(f_i_x, disc_i_x, 2*M, &Lx, extend);
-
-    // Fill result matrix.
+    // Fill result matrix. Block (m,j) is a multiple of inv_f_toep.
 
     for (int m=-M; m<=M; m++)
-      for (int n=-N; n<=N; n++)
+      for (int j=-M; j<=M; j++)
       {
-        int i1 = (n+N+1) + (m+M)*(2*N+1);
-      
-        for (int j=-M; j<=M; j++)
-          for (int l=-N; l<=N; l++)
-          {
-            int i2 = (l+N+1) + (j+M)*(2*N+1);
+        const Complex c_mj = sum_x[p](m-j + 2*M+1);
 
-            result(i1,i2) += fourier_1D_x(m-j + 2*M+1) *
-                               inv_f_toep(n   + N+1, l + N+1);
-          }
+        const int i1 = (m+M)*(2*N+1);
+        const int i2 = (j+M)*(2*N+1);
+
+        for (int l=1; l<=2*N+1; l++)
+          for (int n=1; n<=2*N+1; n++)
+            result(i1+n,i2+l) += c_mj * inv_f_toep(n,l);
       } 
   }
 
@@ -0,0 +1,270 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     fourier_test.cpp
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include "fourier.h"
+#include "toeplitz.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// fourier_direct
+//
+//   Reference implementation, which evaluates the exponentials of every
+//   order and every layer directly.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cVector fourier_direct(const vector<Complex>& f, const vector<Complex>& disc,
+                       int M, const Complex* d, bool extend)
+{
+  Complex D = d ? *d : disc.back() - disc.front();
+  if (extend)
+    D *= 2.0;
+  Complex K = 2.*pi/D;
+
+  cVector result(2*M+1,fortranArray);
+
+  for (int m=-M; m<=M; m++)
+  {
+    Complex result_m = 0.0;
+
+    for (unsigned int k=0; k<disc.size()-1; k++)
+    {
+      Complex factor;
+      if (m==0)
+      {
+        factor = disc[k+1]-disc[k];
+        if (extend)
+          factor *= 2.0;
+      }
+      else
+      {
+        const Complex t = -I*Real(m)*K;
+        factor = (exp(t*disc[k+1])-exp(t*disc[k])) / t;
+        if (extend)
+          factor += (exp(-t*disc[k])-exp(-t*disc[k+1])) / t;
+      }
+
+      result_m += factor * f[k];
+    }
+
+    result(m+M+1) = result_m / D;
+  }
+
+  return result;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// toeplitz_direct
+//
+//   Reference expansion of 2D coefficients in a convolution matrix, as
+//   previously written out in the section solvers.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cMatrix toeplitz_direct(const cMatrix& c, int M, int N, bool x_fastest)
+{
+  const int MN = (2*M+1)*(2*N+1);
+
+  cMatrix result(MN,MN,fortranArray);
+
+  for (int m=-M; m<=M; m++)
+    for (int n=-N; n<=N; n++)
+    {
+      int i1 = x_fastest ? (m+M+1) + (n+N)*(2*M+1)
+                         : (n+N+1) + (m+M)*(2*N+1);
+
+      for (int j=-M; j<=M; j++)
+        for (int l=-N; l<=N; l++)
+        {
+          int i2 = x_fastest ? (j+M+1) + (l+N)*(2*M+1)
+                             : (l+N+1) + (j+M)*(2*N+1);
+
+          result(i1,i2) = c(m-j + 2*M+1, n-l + 2*N+1);
+        }
+    }
+
+  return result;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// max_rel_error
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Real max_rel_error(const cVector& a, const cVector& b)
+{
+  Real max_b = 0.0;
+  for (int i=1; i<=b.rows(); i++)
+    if (abs(b(i)) > max_b)
+      max_b = abs(b(i));
+
+  Real error = 0.0;
+  for (int i=1; i<=a.rows(); i++)
+    if (abs(a(i)-b(i)) > error)
+      error = abs(a(i)-b(i));
+
+  return (max_b > 0) ? error/max_b : error;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Main driver
+//
+/////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+  const Real tol = 1e-10;
+
+  bool passed = true;
+
+  // Layered profile, with a complex stretched part as in a PML.
+
+  vector<Complex> disc, f;
+
+  disc.push_back(0.0);
+  disc.push_back(0.3);
+  disc.push_back(0.45);
+  disc.push_back(1.2);
+  disc.push_back(1.7);
+  disc.push_back(Complex(2.0,-0.2));
+
+  f.push_back(1.0);
+  f.push_back(12.25);
+  f.push_back(Complex(-20.0,1.5));
+  f.push_back(2.1);
+  f.push_back(1.0);
+
+  const Complex d = 2.5;
+
+  // Cover orders past the reseeding interval of the recurrence.
+
+  for (int M=1; M<=100; M+=33)
+    for (int e=0; e<=1; e++)
+    {
+      const bool extend = e;
+
+      cVector c_new = fourier       (f, disc, M, NULL, extend);
+      cVector c_ref = fourier_direct(f, disc, M, NULL, extend);
+
+      Real error = max_rel_error(c_new, c_ref);
+      cout << "fourier M=" << M << " extend=" << extend
+           << " : " << error << endl;
+      if (error > tol)
+        passed = false;
+
+      c_new.reference(fourier       (f, disc, M, &d, extend));
+      c_ref.reference(fourier_direct(f, disc, M, &d, extend));
+
+      error = max_rel_error(c_new, c_ref);
+      cout << "fourier M=" << M << " extend=" << extend
+           << " d=" << d << " : " << error << endl;
+      if (error > tol)
+        passed = false;
+    }
+
+  // Block Toeplitz matrices for both orderings of the harmonics.
+
+  const int M = 3, N = 2;
+
+  cMatrix c(4*M+1,4*N+1,fortranArray);
+  for (int p=1; p<=4*M+1; p++)
+    for (int q=1; q<=4*N+1; q++)
+      c(p,q) = Complex(sin(1.3*p+0.7*q), cos(0.4*p*q));
+
+  const int MN = (2*M+1)*(2*N+1);
+
+  cVector x(MN,fortranArray);
+  for (int i=1; i<=MN; i++)
+    x(i) = Complex(cos(0.9*i), 1.0/i);
+
+  for (int xf=0; xf<=1; xf++)
+  {
+    const bool x_fastest = xf;
+
+    BlockToeplitz T(c, M, N, x_fastest);
+
+    cMatrix T_dense(T.dense());
+    cMatrix T_ref(toeplitz_direct(c, M, N, x_fastest));
+
+    Real error = 0.0;
+    for (int i1=1; i1<=MN; i1++)
+      for (int i2=1; i2<=MN; i2++)
+      {
+        if (abs(T_dense(i1,i2) - T_ref(i1,i2)) > error)
+          error = abs(T_dense(i1,i2) - T_ref(i1,i2));
+        if (abs(T(i1,i2) - T_ref(i1,i2)) > error)
+          error = abs(T(i1,i2) - T_ref(i1,i2));
+      }
+
+    cout << "dense x_fastest=" << x_fastest << " : " << error << endl;
+    if (error > 0.0)
+      passed = false;
+
+    cVector y_ref(multiply(T_ref, x));
+
+    error = max_rel_error(T.multiply(x), y_ref);
+    cout << "multiply x_fastest=" << x_fastest << " : " << error << endl;
+    if (error > tol)
+      passed = false;
+  }
+
+  // Products with a matrix, for orders below and above the switch from
+  // zgemm to FFTs.
+
+  for (int K=3; K<=12; K+=9)
+  {
+    cMatrix c_K(4*K+1,4*K+1,fortranArray);
+    for (int p=1; p<=4*K+1; p++)
+      for (int q=1; q<=4*K+1; q++)
+        c_K(p,q) = Complex(sin(1.3*p+0.7*q), cos(0.4*p*q));
+
+    const int KK = (2*K+1)*(2*K+1);
+
+    cMatrix X(KK,2,fortranArray);
+    for (int i=1; i<=KK; i++)
+    {
+      X(i,1) = Complex(cos(0.9*i), 1.0/i);
+      X(i,2) = Complex(1.0/i, sin(0.3*i));
+    }
+
+    BlockToeplitz T(c_K, K, K);
+
+    cMatrix Y(T.multiply(X));
+    cMatrix Y_ref(multiply(toeplitz_direct(c_K, K, K, true), X));
+
+    Real max_Y = 0.0, error = 0.0;
+    for (int i=1; i<=KK; i++)
+      for (int k=1; k<=2; k++)
+      {
+        if (abs(Y_ref(i,k)) > max_Y)
+          max_Y = abs(Y_ref(i,k));
+        if (abs(Y(i,k) - Y_ref(i,k)) > error)
+          error = abs(Y(i,k) - Y_ref(i,k));
+      }
+
+    cout << "multiply matrix M=N=" << K << " : " << error/max_Y << endl;
+    if (error/max_Y > tol)
+      passed = false;
+  }
+
+  cout << (passed ? "passed" : "FAILED") << endl;
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,299 @@
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     toeplitz.cpp
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "toeplitz.h"
+
+using std::vector;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// fft
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void fft(vector<Complex>& a, bool inverse)
+{
+  const int n = a.size();
+
+  // Bit reversal permutation.
+
+  for (int i=1, j=0; i<n; i++)
+  {
+    int bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+
+    if (i < j)
+      std::swap(a[i], a[j]);
+  }
+
+  // Butterflies.
+
+  const Real sign = inverse ? 1.0 : -1.0;
+
+  for (int len=2; len<=n; len*=2)
+  {
+    const int half = len/2;
+    
+    for (int j=0; j<half; j++)
+    {
+      const Complex w = exp(I*(sign*2.*pi*j/len));
+
+      for (int i=0; i<n; i+=len)
+      {
+        const Complex u = a[i+j];
+        const Complex v = a[i+j+half] * w;
+
+        a[i+j]      = u + v;
+        a[i+j+half] = u - v;
+      }
+    }
+  }
+
+  if (inverse)
+    for (int i=0; i<n; i++)
+      a[i] /= Real(n);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// fft_2D
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void fft_2D(vector<Complex>& a, int nx, int ny, bool inverse)
+{
+  vector<Complex> line(ny);
+
+  for (int p=0; p<nx; p++)
+  {
+    std::copy(a.begin() + p*ny, a.begin() + (p+1)*ny, line.begin());
+    fft(line, inverse);
+    std::copy(line.begin(), line.end(), a.begin() + p*ny);
+  }
+
+  line.resize(nx);
+
+  for (int q=0; q<ny; q++)
+  {
+    for (int p=0; p<nx; p++)
+      line[p] = a[p*ny+q];
+
+    fft(line, inverse);
+
+    for (int p=0; p<nx; p++)
+      a[p*ny+q] = line[p];
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlockToeplitz::BlockToeplitz
+//
+/////////////////////////////////////////////////////////////////////////////
+
+BlockToeplitz::BlockToeplitz(const cMatrix& coeffs, int M_, int N_, 
+                             bool x_fastest_)
+  : c(4*M_+1,4*N_+1,fortranArray), M(M_), N(N_), x_fastest(x_fastest_)
+{
+  if ( (coeffs.rows() != 4*M+1) || (coeffs.columns() != 4*N+1) )
+  {
+    py_error("Error: wrong size of coefficients in BlockToeplitz.");
+    exit (-1);
+  }
+
+  c = coeffs;
+
+  // Size of a circulant which is large enough to avoid wrap-around in
+  // the convolution.
+
+  for (Px=1; Px<4*M+1; Px*=2) ;
+  for (Py=1; Py<4*N+1; Py*=2) ;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlockToeplitz::calc_c_fft
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void BlockToeplitz::calc_c_fft() const
+{
+  c_fft.assign(Px*Py, 0.0);
+
+  for (int p=-2*M; p<=2*M; p++)
+    for (int q=-2*N; q<=2*N; q++)
+      c_fft[((p+Px)%Px)*Py + (q+Py)%Py] = c(p+2*M+1, q+2*N+1);
+
+  fft_2D(c_fft, Px, Py);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlockToeplitz::convolve
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void BlockToeplitz::convolve(vector<Complex>& a) const
+{
+  fft_2D(a, Px, Py);
+
+  for (int k=0; k<Px*Py; k++)
+    a[k] *= c_fft[k];
+
+  fft_2D(a, Px, Py, true);
+
+  // Harmonic (m,n) ends up where x(m,n) was stored, since the
+  // coefficient c(0,0) is at the origin of the circulant.
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlockToeplitz::operator()
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Complex BlockToeplitz::operator()(int i1, int i2) const
+{
+  int m, n, j, l;
+
+  if (x_fastest)
+  {
+    m = (i1-1) % (2*M+1) - M;  n = (i1-1) / (2*M+1) - N;
+    j = (i2-1) % (2*M+1) - M;  l = (i2-1) / (2*M+1) - N;
+  }
+  else
+  {
+    n = (i1-1) % (2*N+1) - N;  m = (i1-1) / (2*N+1) - M;
+    l = (i2-1) % (2*N+1) - N;  j = (i2-1) / (2*N+1) - M;
+  }
+
+  return c(m-j + 2*M+1, n-l + 2*N+1);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlockToeplitz::dense
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cMatrix BlockToeplitz::dense() const
+{
+  cMatrix result(rows(),rows(),fortranArray);
+
+  for (int j=-M; j<=M; j++)
+    for (int l=-N; l<=N; l++)
+    {
+      const int i2 = index(j,l);
+
+      for (int m=-M; m<=M; m++)
+        for (int n=-N; n<=N; n++)
+          result(index(m,n),i2) = c(m-j + 2*M+1, n-l + 2*N+1);
+    }
+
+  return result;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlockToeplitz::multiply
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cVector BlockToeplitz::multiply(const cVector& x) const
+{
+  if (x.rows() != rows())
+  {
+    py_error("Error: wrong vector size in BlockToeplitz::multiply.");
+    exit (-1);
+  }
+
+  std::call_once(c_fft_done, &BlockToeplitz::calc_c_fft, this);
+
+  vector<Complex> a(Px*Py, 0.0);
+
+  for (int m=-M; m<=M; m++)
+    for (int n=-N; n<=N; n++)
+      a[(m+M)*Py + n+N] = x(index(m,n));
+
+  convolve(a);
+
+  cVector result(rows(),fortranArray);
+  
+  for (int m=-M; m<=M; m++)
+    for (int n=-N; n<=N; n++)
+      result(index(m,n)) = a[(m+M)*Py + n+N];
+
+  return result;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlockToeplitz::multiply
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cMatrix BlockToeplitz::multiply(const cMatrix& X) const
+{
+  if (X.rows() != rows())
+  {
+    py_error("Error: wrong matrix size in BlockToeplitz::multiply.");
+    exit (-1);
+  }
+
+  // Per column, the two FFTs of the circulant take about 2.P.log2(P)
+  // complex operations, P = Px.Py, against rows()^2 for a dense product.
+  // For small orders, zgemm on the dense matrix is faster.
+
+  const Real P = Px*Py;
+
+  if (4*P*log(P)/log(2.0) > Real(rows())*rows())
+    return ::multiply(dense(), X);
+
+  std::call_once(c_fft_done, &BlockToeplitz::calc_c_fft, this);
+
+  cMatrix result(rows(),X.columns(),fortranArray);
+
+  vector<Complex> a(Px*Py);
+
+  for (int k=1; k<=X.columns(); k++)
+  {
+    std::fill(a.begin(), a.end(), 0.0);
+
+    for (int m=-M; m<=M; m++)
+      for (int n=-N; n<=N; n++)
+        a[(m+M)*Py + n+N] = X(index(m,n),k);
+
+    convolve(a);
+
+    for (int m=-M; m<=M; m++)
+      for (int n=-N; n<=N; n++)
+        result(index(m,n),k) = a[(m+M)*Py + n+N];
+  }
+
+  return result;
+}
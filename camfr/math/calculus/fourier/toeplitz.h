@@ -0,0 +1,100 @@
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     toeplitz.h
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef TOEPLITZ_H
+#define TOEPLITZ_H
+
+#include <vector>
+#include <mutex>
+#include "../../linalg/linalg.h"
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// fft
+//
+//  In place radix-2 FFT of a, whose size should be a power of two.
+//  The inverse transform includes the 1/n normalisation.
+//
+//  fft_2D does the same for an nx x ny array stored row by row.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void fft(std::vector<Complex>& a, bool inverse=false);
+
+void fft_2D(std::vector<Complex>& a, int nx, int ny, bool inverse=false);
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: BlockToeplitz
+//
+//  Convolution matrix of a 2D fourier expansion c(p,q) of order 
+//  p = -2M,...,2M and q = -2N,...,2N, as returned by fourier_2D:
+//
+//    T(i(m,n),i(j,l)) = c(m-j,n-l)   with m,j = -M,...,M and n,l = -N,...,N
+//
+//  The harmonic (m,n) has index
+//
+//    i(m,n) = (m+M+1) + (n+N)*(2*M+1)   if x_fastest is true,
+//    i(m,n) = (n+N+1) + (m+M)*(2*N+1)   otherwise.
+//
+//  Rather than storing the (2M+1)(2N+1) square matrix, only the
+//  coefficients are kept. The product with a vector is calculated as a
+//  2D convolution using FFTs, in O(MN.log(MN)) operations, which makes
+//  the matrix usable in iterative solvers without ever forming it.
+//  The FFT of the coefficients is only calculated on the first product.
+//
+//  The product with a matrix is done column by column in the same way,
+//  except for small orders, where a dense zgemm is cheaper.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class BlockToeplitz
+{
+  public:
+
+    BlockToeplitz(const cMatrix& coeffs, int M, int N, bool x_fastest=true);
+
+    int rows() const {return (2*M+1)*(2*N+1);}
+
+    int index(int m, int n) const
+      {return x_fastest ? (m+M+1) + (n+N)*(2*M+1)
+                        : (n+N+1) + (m+M)*(2*N+1);}
+
+    Complex operator()(int i1, int i2) const;
+
+    cMatrix dense() const;
+    
+    cVector multiply(const cVector& x) const;
+
+    cMatrix multiply(const cMatrix& X) const;
+
+  protected:
+
+    cMatrix c;
+
+    int M, N;
+    
+    bool x_fastest;
+
+    // FFT of the coefficients, embedded in a Px x Py circulant.
+
+    void calc_c_fft() const;
+
+    void convolve(std::vector<Complex>& a) const;
+
+    int Px, Py;
+    mutable std::vector<Complex> c_fft;
+    mutable std::once_flag c_fft_done;
+};
+
+
+
+#endif
@@ -14,6 +14,7 @@
 #define FUNCTION_H
 
 #include <vector>
+#include <atomic>
 #include "../../defs.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -28,21 +29,45 @@ template<class T> class Function1D
 
     Function1D<T>()                        {counter=0;}
     Function1D<T>(const std::vector<T>& p) {counter=0; set_params(p);}
+    Function1D<T>(const Function1D<T>& f)  {counter=f.counter.load();}
     virtual ~Function1D<T>()          {}
+
+    Function1D<T>& operator=(const Function1D<T>& f)
+      {counter=f.counter.load(); return *this;}
     
     virtual T operator()(const T& t) = 0; // should contain 'counter++'
-    int times_called() {return counter;}
+    unsigned long times_called() {return counter;}
+
+    // Batched evaluation: result[i] = f(t[i]) for 0 <= i < n.
+    // Can be overridden to do work independent of t only once.
+
+    virtual void evaluate(const T* t, T* result, int n)
+      {for (int i=0; i<n; i++) result[i] = (*this)(t[i]);}
 
     virtual std::vector<T> get_params() const {std::vector<T> t; return t;}
     virtual void           set_params  (const  std::vector<T>&) {}
   
   protected:
 
-    int counter;
+    // Atomic, since the ADR contour integration and the batched
+    // bracketing call the function from concurrent OpenMP tasks.
+
+    std::atomic<unsigned long> counter;
 };
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Number of points the bracketing routines in root and minimum pass to
+// Function1D::evaluate at once.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+const int bracket_batch_size = 16;
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Some typedefs to hide the templates from SWIG.
@@ -54,6 +79,30 @@ typedef Function1D<Complex> ComplexFunction;
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// evaluate_on_axis
+//
+//   Batched evaluation of f on the real (or imaginary) axis.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline std::vector<Complex> evaluate_on_axis
+  (ComplexFunction* f, const Real* x, int n, bool imag_axis)
+{
+  std::vector<Complex> z(n), fz(n);
+
+  for (int i=0; i<n; i++)
+    z[i] = imag_axis ? Complex(0.0,x[i]) : Complex(x[i],0.0);
+
+  if (n > 0)
+    f->evaluate(&z[0], &fz[0], n);
+
+  return fz;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Wrapper routines for partially converting complex functions to real
@@ -85,6 +134,13 @@ class Wrap_real_to_real : public RealFunction
 
     Real operator()(const Real& x) {return real((*general)(Complex(x,0.0)));}
 
+    void evaluate(const Real* x, Real* result, int n)
+    {
+      std::vector<Complex> fz = evaluate_on_axis(general, x, n, false);
+      for (int i=0; i<n; i++)
+        result[i] = real(fz[i]);
+    }
+
   protected:
 
     ComplexFunction* general;
@@ -107,6 +163,13 @@ class Wrap_real_to_imag : public RealFunction
    
     Real operator()(const Real& x) {return imag((*general)(Complex(x,0.0)));}
 
+    void evaluate(const Real* x, Real* result, int n)
+    {
+      std::vector<Complex> fz = evaluate_on_axis(general, x, n, false);
+      for (int i=0; i<n; i++)
+        result[i] = imag(fz[i]);
+    }
+
   protected:
 
     ComplexFunction* general;       
@@ -129,6 +192,13 @@ class Wrap_imag_to_real : public RealFunction
    
     Real operator()(const Real& x) {return real((*general)(Complex(0.0,x)));}
 
+    void evaluate(const Real* x, Real* result, int n)
+    {
+      std::vector<Complex> fz = evaluate_on_axis(general, x, n, true);
+      for (int i=0; i<n; i++)
+        result[i] = real(fz[i]);
+    }
+
   protected:
 
     ComplexFunction* general;      
@@ -151,6 +221,13 @@ class Wrap_imag_to_imag : public RealFunction
    
     Real operator()(const Real& x) {return imag((*general)(Complex(0.0,x)));}
 
+    void evaluate(const Real* x, Real* result, int n)
+    {
+      std::vector<Complex> fz = evaluate_on_axis(general, x, n, true);
+      for (int i=0; i<n; i++)
+        result[i] = imag(fz[i]);
+    }
+
   protected:
 
     ComplexFunction* general;   
@@ -173,6 +250,13 @@ class Wrap_real_to_abs : public RealFunction
    
     Real operator()(const Real& x) {return abs((*general)(Complex(x,0.0)));}
 
+    void evaluate(const Real* x, Real* result, int n)
+    {
+      std::vector<Complex> fz = evaluate_on_axis(general, x, n, false);
+      for (int i=0; i<n; i++)
+        result[i] = abs(fz[i]);
+    }
+
   protected:
 
     ComplexFunction* general;       
@@ -195,6 +279,13 @@ class Wrap_imag_to_abs : public RealFunction
    
     Real operator()(const Real& x) {return abs((*general)(Complex(0.0,x)));}
 
+    void evaluate(const Real* x, Real* result, int n)
+    {
+      std::vector<Complex> fz = evaluate_on_axis(general, x, n, true);
+      for (int i=0; i<n; i++)
+        result[i] = abs(fz[i]);
+    }
+
   protected:
 
     ComplexFunction* general;      
@@ -218,6 +309,13 @@ class Wrap_real_to_arg : public RealFunction
     Real operator()(const Real& x) 
       {return std::arg((*general)(Complex(x,0.0)));}
 
+    void evaluate(const Real* x, Real* result, int n)
+    {
+      std::vector<Complex> fz = evaluate_on_axis(general, x, n, false);
+      for (int i=0; i<n; i++)
+        result[i] = std::arg(fz[i]);
+    }
+
   protected:
 
     ComplexFunction* general;       
@@ -241,6 +339,13 @@ class Wrap_imag_to_arg : public RealFunction
     Real operator()(const Real& x) 
       {return std::arg((*general)(Complex(0.0,x)));}
 
+    void evaluate(const Real* x, Real* result, int n)
+    {
+      std::vector<Complex> fz = evaluate_on_axis(general, x, n, true);
+      for (int i=0; i<n; i++)
+        result[i] = std::arg(fz[i]);
+    }
+
   protected:
 
     ComplexFunction* general;      
@@ -234,31 +234,48 @@ void bracket_all_minima(Function1D<Real>& f, Real ax, Real bx,
 
   long int iters = 0;
   int coarse_minima = 0;
+
+  // Sample the function in batches.
+
+  vector<Real> x_batch(bracket_batch_size), fx_batch(bracket_batch_size);
+
+  Real x_next = ax+dx;
   
-  for (Real x=ax+dx; x<=bx; x+=dx)
+  while (x_next <= bx)
   {
-    fx = f(x);
-    
-    if ( decreasing && (fx > previous_fx) )
+    int n = 0;
+    for (; (n < bracket_batch_size) && (x_next <= bx); n++, x_next+=dx)
+      x_batch[n] = x_next;
+
+    f.evaluate(&x_batch[0], &fx_batch[0], n);
+
+    for (int i=0; i<n; i++)
     {
-      Ax.push_back(x-2*dx);
-      Bx.push_back(x+2*dx);
-    }
+      const Real x = x_batch[i];
+
+      fx = fx_batch[i];
     
-    decreasing = (fx < previous_fx);    
-    previous_fx = fx;
+      if ( decreasing && (fx > previous_fx) )
+      {
+        Ax.push_back(x-2*dx);
+        Bx.push_back(x+2*dx);
+      }
+    
+      decreasing = (fx < previous_fx);    
+      previous_fx = fx;
 
-    if (sec_level > 0)
-    {
-      if ( ((iters % int(pow(2.0,sec_level)))==0) || (x+dx>bx) )
+      if (sec_level > 0)
       {
-        fx_coarse = fx;
+        if ( ((iters % int(pow(2.0,sec_level)))==0) || (x+dx>bx) )
+        {
+          fx_coarse = fx;
         
-        if ( decreasing_coarse && (fx_coarse > previous_fx_coarse) )
-          coarse_minima++;
+          if ( decreasing_coarse && (fx_coarse > previous_fx_coarse) )
+            coarse_minima++;
 
-        decreasing_coarse = (fx_coarse < previous_fx_coarse);
-        previous_fx_coarse = fx_coarse;
+          decreasing_coarse = (fx_coarse < previous_fx_coarse);
+          previous_fx_coarse = fx_coarse;
+        }
       }
     }
   }
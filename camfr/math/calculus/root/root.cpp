@@ -218,29 +218,45 @@ void bracket_all_roots(Function1D<Real>& f, Real ax, Real bx,
 
   long int iters = 0;
   int coarse_zeros = 0;
+
+  // Sample the function in batches.
+
+  vector<Real> x_batch(bracket_batch_size), fx_batch(bracket_batch_size);
+
+  Real x_next = ax+dx;
   
-  for (Real x=ax+dx; x<=bx; x+=dx, iters++)
+  while (x_next <= bx)
   {
-    fx = f(x);
+    int n = 0;
+    for (; (n < bracket_batch_size) && (x_next <= bx); n++, x_next+=dx)
+      x_batch[n] = x_next;
 
-    if (fx * previous_fx <= 0)
-    {
-      Ax.push_back(x-dx);
-      Bx.push_back(x);
-    }
-    previous_fx = fx;
+    f.evaluate(&x_batch[0], &fx_batch[0], n);
 
-    if (sec_level > 0)
+    for (int i=0; i<n; i++, iters++)
     {
-      if ( ((iters % int(pow(2.0,sec_level)))==0) || (x+dx>bx) )
+      const Real x = x_batch[i];
+
+      fx = fx_batch[i];
+
+      if (fx * previous_fx <= 0)
       {
-        fx_coarse = fx;
-        if (fx_coarse * previous_fx_coarse <= 0)
-          coarse_zeros++;
-        previous_fx_coarse = fx_coarse;
+        Ax.push_back(x-dx);
+        Bx.push_back(x);
+      }
+      previous_fx = fx;
+
+      if (sec_level > 0)
+      {
+        if ( ((iters % int(pow(2.0,sec_level)))==0) || (x+dx>bx) )
+        {
+          fx_coarse = fx;
+          if (fx_coarse * previous_fx_coarse <= 0)
+            coarse_zeros++;
+          previous_fx_coarse = fx_coarse;
+        }
       }
     }
-    
   }
 
   if ( (sec_level > 0) && (int(Ax.size()) != coarse_zeros) )
@@ -280,32 +296,48 @@ void bracket_N_roots(Function1D<Real>& f, Real ax, int N,
        int fine_zeros    = 0;
        int coarse_zeros  = 0;       
   
-  for (Real x=ax+dx; fine_zeros<N; x+=dx, iters++)
-  { 
-    fx = f(x);
+  // Sample the function in batches. The last batch can evaluate the
+  // function in up to bracket_batch_size-1 points past the last zero.
+
+  vector<Real> x_batch(bracket_batch_size), fx_batch(bracket_batch_size);
+
+  Real x_next = ax+dx;
+
+  while (fine_zeros<N)
+  {
+    for (int n=0; n<bracket_batch_size; n++, x_next+=dx)
+      x_batch[n] = x_next;
+
+    f.evaluate(&x_batch[0], &fx_batch[0], bracket_batch_size);
+
+    for (int i=0; (i<bracket_batch_size) && (fine_zeros<N); i++, iters++)
+    { 
+      const Real x = x_batch[i];
+
+      fx = fx_batch[i];
     
-    if (fx * previous_fx <= 0)
-    {      
-      Ax.push_back(x-dx);
-      Bx.push_back(x);
-      fine_zeros++;
-    }
+      if (fx * previous_fx <= 0)
+      {      
+        Ax.push_back(x-dx);
+        Bx.push_back(x);
+        fine_zeros++;
+      }
     
-    previous_fx = fx;
+      previous_fx = fx;
 
-    if (sec_level > 0)
-    {
-      if (fine_zeros==N)
-        coarse_zeros++; // Avoid problems at the end of the interval.
-      else if ( (iters % int(pow(2.0,sec_level)))==0 )
+      if (sec_level > 0)
       {
-        fx_coarse = fx;
-        if (fx_coarse * previous_fx_coarse <= 0)
-          coarse_zeros++;
-        previous_fx_coarse = fx_coarse;
+        if (fine_zeros==N)
+          coarse_zeros++; // Avoid problems at the end of the interval.
+        else if ( (iters % int(pow(2.0,sec_level)))==0 )
+        {
+          fx_coarse = fx;
+          if (fx_coarse * previous_fx_coarse <= 0)
+            coarse_zeros++;
+          previous_fx_coarse = fx_coarse;
+        }
       }
     }
-    
   }
 
   if (iters >= MAXITER-1)
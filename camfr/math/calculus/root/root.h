@@ -67,6 +67,8 @@ void bracket_all_roots(Function1D<Real>& f, Real ax, Real bx,
 //   function f larger than ax.
 //   The region x>ax is scanned in steps with size dx. It is checked if the
 //   same number of zeros is found using the larger step dx.2^sec_level.
+//   The scan evaluates f in batches of bracket_batch_size points, so f is
+//   called in up to bracket_batch_size-1 points past the last root.
 //
 /////////////////////////////////////////////////////////////////////////////
 
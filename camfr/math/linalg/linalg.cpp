@@ -13,6 +13,8 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>
 #include "linalg.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -230,6 +232,117 @@ cMatrix multiply(const cMatrix& A, const cMatrix& B, Op a, Op b)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// lapack_layout
+//
+//   True if A can be passed to BLAS/LAPACK as it is, i.e. column-major
+//   with a leading dimension equal to its number of rows. This is not the
+//   case for slices, transposed views or C ordered arrays.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline bool lapack_layout(const cMatrix& A)
+{
+  return (A.stride(0) == 1) 
+    && ( (A.columns() <= 1) || (A.stride(1) == A.rows()) );
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// lapack_copy
+//
+//   Returns A if it has the layout LAPACK expects, otherwise a column-major
+//   copy of A, stored in 'copy'.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline const cMatrix& lapack_copy(const cMatrix& A, cMatrix* copy)
+{
+  if (lapack_layout(A))
+    return A;
+
+  copy->resize(A.rows(),A.columns());
+  *copy = A;
+
+  return *copy;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// multiply(A,B,&C,alpha,beta)
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void multiply(const cMatrix& A, const cMatrix& B, cMatrix* C,
+              const Complex& alpha, const Complex& beta, Op a, Op b)
+{
+  // Set dimensions.
+
+  const int A_rows = A.rows();
+  const int A_cols = A.columns();
+  const int B_rows = B.rows();
+  const int B_cols = B.columns();
+
+  const int C_rows = (a == nrml) ? A_rows : A_cols;
+  const int C_cols = (b == nrml) ? B_cols : B_rows;
+  const int K      = (a == nrml) ? A_cols : A_rows;
+
+  if (    ( K != ((b == nrml) ? B_rows : B_cols) )
+       || ( C->rows() != C_rows ) || ( C->columns() != C_cols ) )
+  {
+    std::ostringstream s;
+    s << "Error: dimensions for matrix multiplication don't match : ";
+    s << "[" << A_rows << "," << A_cols << "]*["
+      << B_rows << "," << B_cols << "] -> ["
+      << C->rows() << "," << C->columns() << "].";
+    py_error(s.str());
+    exit (-1);
+  }
+
+  // Prepare op strings.
+
+  char op_a[] = "N";
+  if (a == transp)
+    op_a[0] = 'T';
+  if (a == herm)
+    op_a[0] = 'C';
+
+  char op_b[] = "N";
+  if (b == transp)
+    op_b[0] = 'T';
+  if (b == herm)
+    op_b[0] = 'C';
+
+  // Views that zgemm can't handle are copied, in which case C is only
+  // written back at the end.
+
+  cMatrix A_copy(fortranArray), B_copy(fortranArray), C_copy(fortranArray);
+
+  const cMatrix& A_ = lapack_copy(A, &A_copy);
+  const cMatrix& B_ = lapack_copy(B, &B_copy);
+
+  const bool C_in_place = lapack_layout(*C);
+  if (!C_in_place)
+    lapack_copy(*C, &C_copy);
+
+  cMatrix* C_ = C_in_place ? C : &C_copy;
+
+  // Calculate product.
+  
+  F77NAME(zgemm)(op_a,op_b,C_rows,C_cols,K,alpha,A_.data(),A_rows,
+                 B_.data(),B_rows,beta,C_->data(),C_rows);
+
+  if (!C_in_place)
+    *C = C_copy;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // solve(A,B)
@@ -298,6 +411,83 @@ cMatrix solve(const cMatrix& A, const cMatrix& B)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// solve_in_place(&A,&B,&P)
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void solve_in_place(cMatrix* A, cMatrix* B, iVector* P)
+{
+  // Check dimensions.
+
+  const int A_rows = A->rows();
+
+  if (A_rows != A->columns())
+  {
+    py_error("Error: system matrix is not square.");
+    exit (-1);
+  }
+
+  if ( (A_rows != B->rows()) || (A_rows != P->rows()) )
+  {
+    py_error("Error: dimension of rhs matrix or pivots does not match.");
+    exit (-1);
+  }
+
+  // Views that zgesv can't handle are solved in a copy, which is written
+  // back afterwards.
+
+  cMatrix A_copy(fortranArray), B_copy(fortranArray);
+  iVector P_copy(fortranArray);
+
+  const bool A_in_place = lapack_layout(*A);
+  const bool B_in_place = lapack_layout(*B);
+  const bool P_in_place = (P->stride(0) == 1);
+
+  if (!A_in_place)
+    lapack_copy(*A, &A_copy);
+  if (!B_in_place)
+    lapack_copy(*B, &B_copy);
+  if (!P_in_place)
+    P_copy.resize(A_rows);
+
+  cMatrix* A_ = A_in_place ? A : &A_copy;
+  cMatrix* B_ = B_in_place ? B : &B_copy;
+  iVector* P_ = P_in_place ? P : &P_copy;
+
+  // Solve system.
+  
+  int info;
+  
+  F77NAME(zgesv)(A_rows,B_->columns(),A_->data(),A_rows,
+                 P_->data(),B_->data(),A_rows,info);
+
+  if (!A_in_place)
+    *A = A_copy;
+  if (!B_in_place)
+    *B = B_copy;
+  if (!P_in_place)
+    *P = P_copy;
+
+  if (info < 0)
+  {
+    std::ostringstream s;
+    s << "Error: bad value for argument " << -info;
+    py_error(s.str());
+    exit (-1);
+  }
+
+  if (info > 0)
+  {
+    std::ostringstream s;
+    s << "Warning: singular system: U(" << info << "," << info << ") is zero.";
+    py_error(s.str());
+  }
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // solve_x(A,B)
@@ -1361,6 +1551,477 @@ cMatrix LU_solve(const cMatrix& LU, const iVector& P,
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Helper functions for the shift-invert Arnoldi iteration.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// 2-norm of the first column of x.
+
+Real column_norm(const cMatrix& x)
+{
+  Real sum = 0.0;
+  for (int i=1; i<=x.rows(); i++)
+    sum += std::norm(x(i,1));
+
+  return sqrt(sum);
+}
+
+// Deterministic start vector, different for different seeds.
+
+void start_vector(cMatrix* v, int seed)
+{
+  for (int i=1; i<=v->rows(); i++)
+    (*v)(i,1) = Complex(1.0 + Real((i*7919 + seed*104729) % 1009)/1009.,
+                              Real((i*6151 + seed* 15485) % 1013)/1013.);
+}
+
+// Orthogonalises w against the first j columns of V, using classical
+// Gram-Schmidt with one step of reorthogonalisation. Returns the
+// projection coefficients.
+
+cMatrix orthogonalise(const cMatrix& V, int j, cMatrix* w)
+{
+  cMatrix Vj(V(blitz::Range::all(), blitz::Range(1,j)));
+
+  cMatrix h(j,1,fortranArray);
+  multiply(Vj, *w, &h, 1.0, 0.0, herm);
+  multiply(Vj, h, w, -1.0, 1.0);
+
+  cMatrix h2(j,1,fortranArray);
+  multiply(Vj, *w, &h2, 1.0, 0.0, herm);
+  multiply(Vj, h2, w, -1.0, 1.0);
+
+  h += h2;
+  
+  return h;
+}
+
+// Extends the Arnoldi factorisation Op*V_j = V_j*H_j + f*e_j^T of the
+// operator Op = (A-sigma)^-1, given by the LU decomposition of A-sigma,
+// from j = start-1 to j = m steps.
+//
+// V has m+1 columns and H is (m+1)xm. On entry, the first 'start' columns
+// of V and the leading start x (start-1) block of H are valid. On exit,
+// column m+1 of V contains f/|f| and H(m+1,m) = |f|.
+
+void arnoldi_extend(const cMatrix& LU_A, const iVector& P,
+                    cMatrix* V, cMatrix* H, int start, int m)
+{
+  const int n = V->rows();
+
+  cMatrix w(n,1,fortranArray);
+  
+  for (int j=start; j<=m; j++)
+  {
+    w.reference(LU_solve(LU_A, P,
+      (*V)(blitz::Range::all(), blitz::Range(j,j))));
+
+    const Real w_norm = column_norm(w);
+    
+    cMatrix h(orthogonalise(*V, j, &w));
+    for (int i=1; i<=j; i++)
+      (*H)(i,j) = h(i,1);
+
+    Real beta = column_norm(w);
+
+    // Invariant subspace found: continue with a new random vector.
+
+    if (beta < 1e-14*w_norm)
+    {
+      (*H)(j+1,j) = 0.0;
+
+      if (j == n)
+      {
+        (*V)(blitz::Range::all(), j+1) = 0.0;
+        continue;
+      }
+
+      start_vector(&w, j);
+      orthogonalise(*V, j, &w);
+      beta = column_norm(w);
+    }
+    else
+      (*H)(j+1,j) = beta;
+
+    for (int i=1; i<=n; i++)
+      (*V)(i,j+1) = w(i,1) / beta;
+  }
+}
+
+// Performs one shifted QR step on the upper Hessenberg matrix H, i.e.
+// H = Q^H.H.Q with H-mu = Q.R, using Givens rotations. Q is accumulated
+// in U.
+
+void shifted_qr_step(cMatrix* H, cMatrix* U, const Complex& mu)
+{
+  const int m = H->rows();
+
+  std::vector<Real>    c(m);
+  std::vector<Complex> s(m);
+
+  for (int i=1; i<=m; i++)
+    (*H)(i,i) -= mu;
+
+  // H-mu = Q.R
+
+  for (int j=1; j<m; j++)
+  {
+    const Complex a = (*H)(j,j);
+    const Complex b = (*H)(j+1,j);
+
+    const Real r = sqrt(std::norm(a) + std::norm(b));
+
+    if (r == 0.0)
+      {c[j] = 1.0; s[j] = 0.0;}
+    else if (abs(a) == 0.0)
+      {c[j] = 0.0; s[j] = 1.0;}
+    else
+      {c[j] = abs(a)/r; s[j] = a/abs(a) * conj(b)/r;}
+
+    for (int k=j; k<=m; k++)
+    {
+      const Complex x = (*H)(j,  k);
+      const Complex y = (*H)(j+1,k);
+
+      (*H)(j,  k) =          c[j] *x + s[j]*y;
+      (*H)(j+1,k) = -conj(s[j])*x    + c[j]*y;
+    }
+  }
+
+  // R.Q + mu
+
+  for (int j=1; j<m; j++)
+  {
+    for (int i=1; i<=j+1; i++)
+    {
+      const Complex x = (*H)(i,j);
+      const Complex y = (*H)(i,j+1);
+
+      (*H)(i,j)   = c[j]*x + conj(s[j])*y;
+      (*H)(i,j+1) = -s[j]*x +     c[j] *y;
+    }
+
+    for (int i=1; i<=U->rows(); i++)
+    {
+      const Complex x = (*U)(i,j);
+      const Complex y = (*U)(i,j+1);
+
+      (*U)(i,j)   = c[j]*x + conj(s[j])*y;
+      (*U)(i,j+1) = -s[j]*x +     c[j] *y;
+    }
+  }
+
+  for (int i=1; i<=m; i++)
+    (*H)(i,i) += mu;
+}
+
+// Sorts indices on decreasing magnitude of the corresponding values.
+
+struct magnitude_sorter
+{
+    magnitude_sorter(const cVector& v_) : v(v_) {}
+
+    bool operator()(int a, int b) {return abs(v(a)) > abs(v(b));}
+
+    const cVector& v;
+};
+
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Computes the k eigenvalues of A closest to sigma using shift-invert
+// Arnoldi.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cVector eigenvalues_shift_invert(const cMatrix& A, const Complex& sigma, 
+                                 int k, cMatrix* eigenvectors,
+                                 Real eps, int max_restarts)
+{
+  // Check dimensions.
+
+  const int n = A.rows();
+
+  if (n != A.columns())
+  {
+    py_error("Error: A matrix is not square.");
+    exit (-1);
+  }
+
+  if ( (k < 1) || (k > n) )
+  {
+    py_error("Error: invalid number of eigenvalues requested.");
+    exit (-1);
+  }
+
+  // For small problems, a dense eigensolver is cheaper.
+
+  if (2*k >= n)
+  {
+    cMatrix eig(n,n,fortranArray);
+    cVector E_all(eigenvalues(A, eigenvectors ? &eig : NULL));
+
+    cVector theta(n,fortranArray);
+    for (int i=1; i<=n; i++)
+      theta(i) = 1.0/(E_all(i) - sigma);
+
+    std::vector<int> index;
+    for (int i=1; i<=n; i++)
+      index.push_back(i);
+    std::sort(index.begin(), index.end(), magnitude_sorter(theta));
+
+    cVector E(k,fortranArray);
+    for (int i=1; i<=k; i++)
+      E(i) = E_all(index[i-1]);
+
+    if (eigenvectors)
+    {
+      eigenvectors->resize(n,k);
+      for (int i=1; i<=k; i++)
+        (*eigenvectors)(blitz::Range::all(), i) 
+          = eig(blitz::Range::all(), index[i-1]);
+    }
+
+    return E;
+  }
+
+  // LU decomposition of A-sigma.
+
+  cMatrix A_sigma(n,n,fortranArray);
+  A_sigma = A;
+  for (int i=1; i<=n; i++)
+    A_sigma(i,i) -= sigma;
+
+  cMatrix LU_A(n,n,fortranArray);
+  iVector P(n,fortranArray);
+  
+  LU(A_sigma, &LU_A, &P);
+
+  // Initial Arnoldi factorisation.
+
+  int m = (2*k > k+16) ? 2*k : k+16;
+  if (m > n)
+    m = n;
+
+  cMatrix V(n,m+1,fortranArray);
+  cMatrix H(m+1,m,fortranArray);
+  H = 0.0;
+
+  cMatrix v(n,1,fortranArray);
+  start_vector(&v, 0);
+  const Real v_norm = column_norm(v);
+  for (int i=1; i<=n; i++)
+    V(i,1) = v(i,1) / v_norm;
+
+  arnoldi_extend(LU_A, P, &V, &H, 1, m);
+
+  // Restart loop.
+
+  cVector theta(m,fortranArray);
+  cMatrix Y(m,m,fortranArray);
+  std::vector<int> index;
+
+  for (int restart=0; restart<=max_restarts; restart++)
+  {
+    cMatrix H_m(m,m,fortranArray);
+    H_m = H(blitz::Range(1,m), blitz::Range(1,m));
+
+    theta.reference(eigenvalues(H_m, &Y));
+
+    index.clear();
+    for (int i=1; i<=m; i++)
+      index.push_back(i);
+    std::sort(index.begin(), index.end(), magnitude_sorter(theta));
+
+    // Check convergence of the wanted Ritz values.
+
+    const Real beta = abs(H(m+1,m));
+
+    bool converged = true;
+    for (int i=0; i<k; i++)
+      if (beta * abs(Y(m,index[i])) > eps * abs(theta(index[i])))
+        converged = false;
+
+    if (converged)
+      break;
+
+    if (restart == max_restarts)
+    {
+      py_error("Warning: shift-invert Arnoldi did not converge.");
+      break;
+    }
+
+    // Filter out unwanted Ritz values using them as shifts.
+
+    cMatrix U(m,m,fortranArray);
+    U = 0.0;
+    for (int i=1; i<=m; i++)
+      U(i,i) = 1.0;
+
+    for (int i=k; i<m; i++)
+      shifted_qr_step(&H_m, &U, theta(index[i]));
+
+    // Compress factorisation to k steps.
+
+    cMatrix Vm(V(blitz::Range::all(), blitz::Range(1,m)));
+
+    cMatrix V_k(n,k+1,fortranArray);
+    V_k.reference(multiply(Vm, U(blitz::Range::all(), blitz::Range(1,k+1))));
+
+    cMatrix f(n,1,fortranArray);
+    for (int i=1; i<=n; i++)
+      f(i,1) = V_k(i,k+1) * H_m(k+1,k) + V(i,m+1) * beta * U(m,k);
+    
+    V(blitz::Range::all(), blitz::Range(1,k)) 
+      = V_k(blitz::Range::all(), blitz::Range(1,k));
+
+    H = 0.0;
+    H(blitz::Range(1,k), blitz::Range(1,k)) 
+      = H_m(blitz::Range(1,k), blitz::Range(1,k));
+
+    const Real beta_k = column_norm(f);
+    H(k+1,k) = beta_k;
+    for (int i=1; i<=n; i++)
+      V(i,k+1) = f(i,1) / beta_k;
+
+    // Extend it again to m steps.
+
+    arnoldi_extend(LU_A, P, &V, &H, k+1, m);
+  }
+
+  // Transform Ritz values back.
+
+  cVector E(k,fortranArray);
+  for (int i=1; i<=k; i++)
+    E(i) = sigma + 1.0/theta(index[i-1]);
+
+  if (eigenvectors)
+  {
+    cMatrix Y_k(m,k,fortranArray);
+    for (int i=1; i<=k; i++)
+      Y_k(blitz::Range::all(), i) = Y(blitz::Range::all(), index[i-1]);
+
+    cMatrix Vm(V(blitz::Range::all(), blitz::Range(1,m)));
+
+    eigenvectors->resize(n,k);
+    multiply(Vm, Y_k, eigenvectors);
+
+    for (int i=1; i<=k; i++)
+    {
+      Real sum = 0.0;
+      for (int j=1; j<=n; j++)
+        sum += std::norm((*eigenvectors)(j,i));
+
+      (*eigenvectors)(blitz::Range::all(), i) /= sqrt(sum);
+    }
+  }
+
+  return E;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Computes the smallest singular value of A using inverse iteration.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Real smallest_singular_value(const cMatrix& A, cVector* v, bool* converged,
+                             Real eps, int max_iter)
+{
+  // Check dimensions.
+
+  const int n = A.rows();
+
+  if (n != A.columns())
+  {
+    py_error("Error: A matrix is not square.");
+    exit (-1);
+  }
+
+  // LU decomposition of A, used for both A and A^H.
+
+  cMatrix LU_A(n,n,fortranArray);
+  iVector P(n,fortranArray);
+  
+  LU(A, &LU_A, &P);
+
+  // Start vector.
+
+  cMatrix x(n,1,fortranArray);
+  
+  if (v->rows() == n)
+    for (int i=1; i<=n; i++)
+      x(i,1) = (*v)(i);
+  else
+    start_vector(&x, 0);
+
+  Real x_norm = column_norm(x);
+  if (x_norm == 0.0)
+  {
+    start_vector(&x, 0);
+    x_norm = column_norm(x);
+  }
+
+  for (int i=1; i<=n; i++)
+    x(i,1) /= x_norm;
+
+  // Iterate x <- (A^H.A)^-1 x. The estimate |A.x| is an upper bound for
+  // the singular value, with an error quadratic in that of x.
+
+  cMatrix y(n,1,fortranArray), Ax(n,1,fortranArray);
+
+  Real sigma = 0.0, last_sigma = -1.0;
+  bool done = false;
+  
+  for (int iter=1; iter<=max_iter; iter++)
+  {
+    y.reference(LU_solve(LU_A, P, x, herm));
+    x.reference(LU_solve(LU_A, P, y));
+
+    x_norm = column_norm(x);
+    if ( !(x_norm > 0.0) || (x_norm - x_norm != 0.0) ) // Exactly singular.
+    {
+      if (converged)
+        *converged = false;
+      return 0.0;
+    }
+
+    for (int i=1; i<=n; i++)
+      x(i,1) /= x_norm;
+
+    multiply(A, x, &Ax);
+    sigma = column_norm(Ax);
+
+    if (abs(sigma - last_sigma) <= eps * sigma)
+    {
+      done = true;
+      break;
+    }
+
+    last_sigma = sigma;
+  }
+
+  if (converged)
+    *converged = done;
+  
+  v->resize(n);
+  for (int i=1; i<=n; i++)
+    (*v)(i) = x(i,1);
+
+  return sigma;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Write cMatrix to a text file that cab be read in by Matlab.
@@ -114,6 +114,26 @@ inline cVector multiply(const cMatrix& A, const cMatrix& B, const cVector& x)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// In-place matrix multiplication: multiply(A,B,&C,alpha,beta)
+//
+//   C = alpha*op(A)*op(B) + beta*C
+//
+//   Writes into the existing storage of C, which should have the correct
+//   dimensions and should not overlap with A or B. Used in inner loops
+//   to avoid allocating temporaries. Only matrices that are not stored
+//   column-major with contiguous columns, like slices and transposed views,
+//   are copied to a temporary.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void multiply(const cMatrix& A, const cMatrix& B, cMatrix* C,
+              const Complex& alpha=1.0, const Complex& beta=0.0,
+              Op a=nrml, Op b=nrml);
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Returns solution X of system of linear equations A*X=B.
@@ -136,6 +156,21 @@ cMatrix solve_sym_x(const cMatrix& A, const cMatrix& B);
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// In-place solution of system of linear equations A*X=B.
+//
+//   On return, B contains X, A its LU decomposition and P the pivot
+//   indices. No copies are made, so the caller can reuse the storage,
+//   unless one of them is a slice or another view that LAPACK can't use
+//   directly. Such a view is solved in a copy, which is written back.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void solve_in_place(cMatrix* A, cMatrix* B, iVector* P);
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Computes eigenvalues and/or eigenvectors of matrix A.
@@ -152,6 +187,26 @@ cVector eigenvalues_x(const cMatrix& A, cMatrix* eigenvectors=NULL);
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Computes the k eigenvalues of matrix A closest to sigma and optionally
+// the corresponding eigenvectors.
+//
+//   Uses an implicitly restarted Arnoldi iteration on (A-sigma)^-1. This
+//   only needs a single LU decomposition, so for k << N it is much cheaper
+//   than a full eigendecomposition. The eigenvalues are sorted on
+//   increasing distance to sigma.
+//
+//   'eps' is the relative tolerance on the Ritz values.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cVector eigenvalues_shift_invert(const cMatrix& A, const Complex& sigma,
+                                 int k, cMatrix* eigenvectors=NULL,
+                                 Real eps=1e-12, int max_restarts=300);
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Computes eigenvalues and/or eigenvectors of the generalized 
@@ -175,6 +230,27 @@ rVector svd(const cMatrix& A, cMatrix* Vh=NULL, cMatrix* U=NULL);
 
 
      
+/////////////////////////////////////////////////////////////////////////////
+//
+// Computes the smallest singular value of a square matrix A, and the
+// corresponding right singular vector v.
+//
+//   Uses inverse iteration on A^H.A, which only needs a single LU
+//   decomposition of A. If v has the right size on entry, it is used as
+//   the start vector, which makes it cheap to track the singular value
+//   of a slowly varying matrix.
+//
+//   'converged' is set to false if the singular value did not settle to
+//   a relative precision 'eps' within 'max_iter' iterations.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Real smallest_singular_value(const cMatrix& A, cVector* v,
+                             bool* converged=NULL,
+                             Real eps=1e-10, int max_iter=30);
+
+
+     
 /////////////////////////////////////////////////////////////////////////////
 //
 // Inverts a matrix.
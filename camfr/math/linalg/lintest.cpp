@@ -56,6 +56,18 @@ int main()
 
   cout << "C=A*B: " << C << endl;
 
+  multiply(A,B,&C,2.0,1.0);
+
+  cout << "C=2*A*B+C: " << C << endl;
+
+  cMatrix E(4,3,fortranArray);
+  E = 0.0;
+
+  cMatrix E_rows(E(blitz::Range(1,3),blitz::Range::all()));
+  multiply(A,B,&E_rows);
+
+  cout << "C=A*B in a slice: " << E_rows << endl;
+
   //
   // linear systems
   //
@@ -81,6 +93,23 @@ int main()
 
   cout << LU_solve(lu,p,A,transp) << endl;
 
+  cMatrix D_LU(3,3,fortranArray); D_LU = D;
+  cMatrix X(3,2,fortranArray);    X = A;
+
+  solve_in_place(&D_LU,&X,&p);
+
+  cout << "solve in place: " << X << endl;
+
+  D_LU = D;
+
+  cMatrix Y(4,2,fortranArray);
+  cMatrix Y_rows(Y(blitz::Range(2,4),blitz::Range::all()));
+  Y_rows = A;
+
+  solve_in_place(&D_LU,&Y_rows,&p);
+
+  cout << "solve in place in a slice: " << Y_rows << endl;
+
   //
   // eigenvalues
   //
@@ -98,6 +127,9 @@ int main()
   cout << "eigenvalues of D (again): " << endl;
   cout << eigenvalues(D) << endl;
 
+  cout << "eigenvalue of D closest to 8 (shift-invert): "
+       << real(eigenvalues_shift_invert(D,8.0,1)(1)) << endl;
+
   //
   // SVD
   //
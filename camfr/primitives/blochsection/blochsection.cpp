@@ -19,6 +19,8 @@
 #include "../slab/isoslab/slab.h"
 #include "../section/section.h"
 #include "../../math/calculus/fourier/fourier.h"
+#include "../../math/calculus/fourier/toeplitz.h"
+#include "../../context.h"
 
 using std::vector;
 using std::cout;
@@ -33,7 +35,71 @@ using std::endl;
 //
 /////////////////////////////////////////////////////////////////////////////
 
-BlochSectionGlobal global_blochsection = {0,0,0.0,0.0,0.0,0.0,0.5};
+thread_local BlochSectionGlobal global_blochsection
+  = {0,0,0.0,0.0,0.0,0.0,0.5};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// kzSorter
+//
+//   Same order as modesorter for modes without a definite polarisation.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+struct kzSorter
+{
+    bool operator()(const Complex& a, const Complex& b)
+    {
+      return ( real(a*a) > real(b*b) );
+    }
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlochSectionImpl::band_structure()
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void BlochSectionImpl::band_structure(const vector<Complex>& kx0,
+                                      const vector<Complex>& ky0,
+                                      cMatrix* kz, int threads)
+{
+  if (kx0.size() != ky0.size())
+  {
+    py_error("Error: kx0 and ky0 have different lengths.");
+    return;
+  }
+
+  const Complex alpha0 = global_blochsection.alpha0;
+  const Complex  beta0 = global_blochsection.beta0;
+
+  for (unsigned int k=0; k<kx0.size(); k++)
+  {
+    global_blochsection.alpha0 = kx0[k];
+    global_blochsection.beta0  = ky0[k];
+
+    find_modes();
+
+    if (k == 0)
+      kz->resize(kx0.size(), N());
+
+    vector<Complex> kz_k;
+    for (int i=1; i<=N(); i++)
+      kz_k.push_back(get_mode(i)->get_kz());
+
+    std::sort(kz_k.begin(), kz_k.end(), kzSorter());
+
+    for (int i=1; i<=N(); i++)
+      (*kz)(k+1,i) = kz_k[i-1];
+  }
+
+  global_blochsection.alpha0 = alpha0;
+  global_blochsection.beta0  =  beta0;
+}
 
 
 
@@ -193,7 +259,8 @@ BlochSection::BlochSection(Expression& expression)
 
 BlochSection2D::BlochSection2D(Expression& ex) 
   : st(ex), inv_eps_2(fortranArray), 
-    eps_x_y(fortranArray), eps_y_x(fortranArray)
+    eps_x_y(fortranArray), eps_y_x(fortranArray),
+    fourier_materials_version(0), fourier_stability(normal)
 {
   // Determine core.
 
@@ -235,6 +302,7 @@ BlochSection2D::BlochSection2D(Expression& ex)
 /////////////////////////////////////////////////////////////////////////////
 
 BlochSection2D::BlochSection2D(const BlochSection2D& section)
+  : fourier_materials_version(0), fourier_stability(normal)
 {
   st        = section.st;
   core      = section.core;
@@ -438,20 +506,8 @@ void BlochSection2D::create_FG_NT(cMatrix* F, cMatrix* G, int M, int N,
   cMatrix eps(MN,MN,fortranArray);
   cMatrix inv_eps(MN,MN,fortranArray);
 
-  for (int m=-M; m<=M; m++)
-    for (int n=-N; n<=N; n++)
-    {
-      int i1 = (m+M+1) + (n+N)*(2*M+1);
-     
-      for (int j=-M; j<=M; j++)
-        for (int l=-N; l<=N; l++)
-        {
-          int i2 = (j+M+1) + (l+N)*(2*M+1);
-
-              eps(i1,i2) = eps_(m-j + 2*M+1, n-l + 2*N+1);
-          inv_eps(i1,i2) = inv_eps_(m-j + 2*M+1, n-l + 2*N+1);
-        }
-    }
+  eps.    reference(BlockToeplitz(eps_, M, N).dense());
+  inv_eps.reference(BlockToeplitz(inv_eps_, M, N).dense());
 
   // Calculate alpha and beta vector.
 
@@ -509,119 +565,134 @@ void BlochSection2D::create_FG_NT(cMatrix* F, cMatrix* G, int M, int N,
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// BlochSection2D::create_FG_li
+// BlochSection2D::calc_fourier_li
 //
-//  Li formulation
+//  Fourier matrices for the Li formulation. These only depend on the
+//  geometry, the materials and the stability setting, so they are kept
+//  between calls until one of these changes.
 //
 /////////////////////////////////////////////////////////////////////////////
 
-void BlochSection2D::create_FG_li(cMatrix* F, cMatrix* G, int M, int N,
-                                  const Complex& alpha0, const Complex& beta0)
+void BlochSection2D::calc_fourier_li(int M, int N)
 {
   int m_ = 2*M+1;  
   int n_ = 2*N+1;
 
   const int MN = m_*n_;
 
-  if (MN != inv_eps_2.rows())
-  {    
-    inv_eps_2.resize(MN,MN);
-    eps_x_y  .resize(MN,MN);
-    eps_y_x  .resize(MN,MN);
+  const unsigned long version = materials_version(get_materials());
 
-    // Construct data structures for fourier analysis.
+  if (    (MN == inv_eps_2.rows())
+       && (version == fourier_materials_version)
+       && (global.stability == fourier_stability) )
+    return;
 
-    vector<Complex> disc_x(discontinuities);
-    disc_x.insert(disc_x.begin(), 0.0);
+  fourier_materials_version = version;
+  fourier_stability         = global.stability;
 
-    vector<vector<Complex> > disc_y, f_eps;
+  inv_eps_2.resize(MN,MN);
+  eps_x_y  .resize(MN,MN);
+  eps_y_x  .resize(MN,MN);
 
-    for (int i=0; i<disc_x.size()-1; i++)
-    {
-      vector<Complex> disc_y_i(slabs[i]->get_discontinuities());
-      disc_y_i.insert(disc_y_i.begin(), 0.0);
+  // Construct data structures for fourier analysis.
 
-      vector<Complex> f_eps_i;
-      for (int j=0; j<disc_y_i.size()-1; j++)
-      {
-        Coord coord(disc_y_i[j],0,0,Plus);
-      
-        f_eps_i.push_back(slabs[i]->eps_at(coord)/eps0);
-      }
+  vector<Complex> disc_x(discontinuities);
+  disc_x.insert(disc_x.begin(), 0.0);
 
-      disc_y.push_back(disc_y_i);
-      f_eps.push_back(f_eps_i);
-    }
+  vector<vector<Complex> > disc_y, f_eps;
 
-    vector<Slab*> slabs_rot;
-    vector<Complex> disc_x_rot;
-    rotate_slabs_(slabs, disc_x, &slabs_rot, &disc_x_rot);
+  for (int i=0; i<disc_x.size()-1; i++)
+  {
+    vector<Complex> disc_y_i(slabs[i]->get_discontinuities());
+    disc_y_i.insert(disc_y_i.begin(), 0.0);
 
-    vector<vector<Complex> > disc_y_rot, f_eps_rot, f_inv_eps_rot;
-    for (int i=0; i<disc_x_rot.size()-1; i++)
+    vector<Complex> f_eps_i;
+    for (int j=0; j<disc_y_i.size()-1; j++)
     {
-      vector<Complex> disc_y_rot_i(slabs_rot[i]->get_discontinuities());
-      disc_y_rot_i.insert(disc_y_rot_i.begin(), 0.0);
+      Coord coord(disc_y_i[j],0,0,Plus);
+    
+      f_eps_i.push_back(slabs[i]->eps_at(coord)/eps0);
+    }
 
-      vector<Complex> f_eps_rot_i, f_inv_eps_rot_i;
-      for (int j=0; j<disc_y_rot_i.size()-1; j++)
-      {
-        Coord coord(disc_y_rot_i[j],0,0,Plus);
+    disc_y.push_back(disc_y_i);
+    f_eps.push_back(f_eps_i);
+  }
 
-        f_eps_rot_i.    push_back(slabs_rot[i]->eps_at(coord)/eps0);
-        f_inv_eps_rot_i.push_back(eps0/slabs_rot[i]->eps_at(coord));
-      }
+  vector<Slab*> slabs_rot;
+  vector<Complex> disc_x_rot;
+  rotate_slabs_(slabs, disc_x, &slabs_rot, &disc_x_rot);
+
+  vector<vector<Complex> > disc_y_rot, f_eps_rot, f_inv_eps_rot;
+  for (int i=0; i<disc_x_rot.size()-1; i++)
+  {
+    vector<Complex> disc_y_rot_i(slabs_rot[i]->get_discontinuities());
+    disc_y_rot_i.insert(disc_y_rot_i.begin(), 0.0);
 
-      disc_y_rot.push_back(disc_y_rot_i);
-      f_eps_rot.push_back(f_eps_rot_i);
-      f_inv_eps_rot.push_back(f_inv_eps_rot_i);
+    vector<Complex> f_eps_rot_i, f_inv_eps_rot_i;
+    for (int j=0; j<disc_y_rot_i.size()-1; j++)
+    {
+      Coord coord(disc_y_rot_i[j],0,0,Plus);
+
+      f_eps_rot_i.    push_back(slabs_rot[i]->eps_at(coord)/eps0);
+      f_inv_eps_rot_i.push_back(eps0/slabs_rot[i]->eps_at(coord));
     }
 
-    // Construct fourier matrices.
+    disc_y_rot.push_back(disc_y_rot_i);
+    f_eps_rot.push_back(f_eps_rot_i);
+    f_inv_eps_rot.push_back(f_inv_eps_rot_i);
+  }
 
-    cMatrix eps_(4*M+1,4*N+1,fortranArray);
+  // Construct fourier matrices.
 
-    eps_ = fourier_2D(disc_x, disc_y, f_eps, 2*M, 2*N);
-  
-    cMatrix eps(MN,MN,fortranArray);
+  cMatrix eps_(4*M+1,4*N+1,fortranArray);
 
-    for (int m=-M; m<=M; m++)
-      for (int n=-N; n<=N; n++)
-      {
-        int i1 = (m+M+1) + (n+N)*(2*M+1);
-     
-        for (int j=-M; j<=M; j++)
-          for (int l=-N; l<=N; l++)
-          {
-            int i2 = (j+M+1) + (l+N)*(2*M+1);
-
-            eps(i1,i2) = eps_(m-j + 2*M+1, n-l + 2*N+1); 
-          }
-      }
+  eps_ = fourier_2D(disc_x, disc_y, f_eps, 2*M, 2*N);
 
-    if (global.stability != SVD)
-      inv_eps_2.reference(invert(eps));
-    else
-      inv_eps_2.reference(invert_svd(eps));
+  cMatrix eps(MN,MN,fortranArray);
 
-    // Calculate split fourier transforms.
+  eps.reference(BlockToeplitz(eps_, M, N).dense());
 
-    cMatrix t(MN,MN,fortranArray);
-    t.reference(fourier_2D_split(disc_x_rot,disc_y_rot,f_eps_rot,N,M));
-    if (global.stability != SVD)
-      eps_y_x.reference(invert(t));
-    else
-      eps_y_x.reference(invert_svd(t));
+  if (global.stability != SVD)
+    inv_eps_2.reference(invert(eps));
+  else
+    inv_eps_2.reference(invert_svd(eps));
 
-    eps_x_y.reference(fourier_2D_split(disc_x_rot,disc_y_rot,
-                                       f_inv_eps_rot,N,M));
+  // Calculate split fourier transforms.
 
-    // Free rotated slabs.
+  cMatrix t(MN,MN,fortranArray);
+  t.reference(fourier_2D_split(disc_x_rot,disc_y_rot,f_eps_rot,N,M));
+  if (global.stability != SVD)
+    eps_y_x.reference(invert(t));
+  else
+    eps_y_x.reference(invert_svd(t));
 
-    for (int i=0; i<slabs_rot.size(); i++)
-      delete slabs_rot[i];
-  
-  } // End of calculation which only depends on the geometry.
+  eps_x_y.reference(fourier_2D_split(disc_x_rot,disc_y_rot,
+                                     f_inv_eps_rot,N,M));
+
+  // Free rotated slabs.
+
+  for (int i=0; i<slabs_rot.size(); i++)
+    delete slabs_rot[i];
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlochSection2D::create_FG_li
+//
+//  Li formulation. Assumes the Fourier matrices have been calculated.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void BlochSection2D::create_FG_li(cMatrix* F, cMatrix* G, int M, int N,
+                                  const Complex& alpha0,
+                                  const Complex& beta0) const
+{
+  int m_ = 2*M+1;  
+  int n_ = 2*N+1;
+
+  const int MN = m_*n_;
 
   // Calculate alpha and beta vector.
 
@@ -679,19 +750,15 @@ void BlochSection2D::create_FG_li(cMatrix* F, cMatrix* G, int M, int N,
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// BlochSection2D::create_FG_li_biaxial
+// BlochSection2D::calc_fourier_biaxial
 //
-//  Li formulation for biaxial media
+//  Fourier matrices for the Li formulation for biaxial media.
 //
 /////////////////////////////////////////////////////////////////////////////
 
-void BlochSection2D::create_FG_li_biaxial(cMatrix* F, cMatrix* G, 
-                                          int M, int N,
-                                          const Complex& alpha0, 
-                                          const Complex& beta0)
+void BlochSection2D::calc_fourier_biaxial(int M, int N,
+                                          BiaxialFourier* f) const
 {
-  const Complex k0 = 2.*pi/global.lambda;
-
   const Real p = global_section.PML_fraction;
   Complex p_d = 0.3; // TMP
 
@@ -872,20 +939,8 @@ void BlochSection2D::create_FG_li_biaxial(cMatrix* F, cMatrix* G,
 
   cMatrix eps_3_(MN,MN,fortranArray), mu_3_(MN,MN,fortranArray);
 
-  for (int m=-M; m<=M; m++)
-    for (int n=-N; n<=N; n++)
-    {
-      int i1 = (n+N+1) + (m+M)*(2*N+1);
-     
-      for (int j=-M; j<=M; j++)
-        for (int l=-N; l<=N; l++)
-        {
-          int i2 = (l+N+1) + (j+M)*(2*N+1);
-
-          eps_3_(i1,i2) = eps_3_f(m-j + 2*M+1, n-l + 2*N+1);          
-           mu_3_(i1,i2) =  mu_3_f(m-j + 2*M+1, n-l + 2*N+1);
-        }
-    }
+  eps_3_.reference(BlockToeplitz(eps_3_f, M, N, false).dense());
+   mu_3_.reference(BlockToeplitz( mu_3_f, M, N, false).dense());
 
   cMatrix eps_2(MN,MN,fortranArray), mu_2(MN,MN,fortranArray); 
   cMatrix eps_3(MN,MN,fortranArray), mu_3(MN,MN,fortranArray);
@@ -907,6 +962,43 @@ void BlochSection2D::create_FG_li_biaxial(cMatrix* F, cMatrix* G,
     mu_3. reference(invert_svd(mu_3_));
   }
 
+  f->eps_1.reference(eps_1); f->eps_2.reference(eps_2);
+  f->eps_3.reference(eps_3);
+
+  f->mu_1.reference(mu_1); f->mu_2.reference(mu_2); f->mu_3.reference(mu_3);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlochSection2D::create_FG_li_biaxial
+//
+//  Li formulation for biaxial media.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void BlochSection2D::create_FG_li_biaxial(cMatrix* F, cMatrix* G, 
+                                          int M, int N,
+                                          const Complex& alpha0, 
+                                          const Complex& beta0,
+                                          const BiaxialFourier& f) const
+{
+  const Complex k0 = 2.*pi/global.lambda;
+
+  int m_ = 2*M+1;  
+  int n_ = 2*N+1;
+
+  const int MN = m_*n_;
+
+  const cMatrix& eps_1 = f.eps_1;
+  const cMatrix& eps_2 = f.eps_2;
+  const cMatrix& eps_3 = f.eps_3;
+
+  const cMatrix& mu_1 = f.mu_1;
+  const cMatrix& mu_2 = f.mu_2;
+  const cMatrix& mu_3 = f.mu_3;
+
   // Calculate alpha and beta vector.
 
   cVector alpha(MN,fortranArray);
@@ -969,6 +1061,95 @@ struct IndexConvertor
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// kz_from_eigenvalue
+//
+//  Propagation constant corresponding to an eigenvalue of FG.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline Complex kz_from_eigenvalue(const Complex& E, const Complex& k0)
+{
+  Complex kz = sqrt(E/k0/k0);
+
+  if (imag(kz) > 0)
+    kz = -kz;
+
+  if (abs(imag(kz)) < abs(real(kz)))
+    if (real(kz) < 0)
+      kz = -kz;
+
+  return kz;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// biaxial_formulation
+//
+//  True if the eigenproblem should be set up using the Li formulation for
+//  biaxial media.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline bool biaxial_formulation()
+{
+  const bool PML_present 
+    =  (    (abs(global_slab.lower_PML)         > 1e-12)
+         || (abs(global_slab.upper_PML)         > 1e-12)
+         || (abs(global_blochsection.left_PML)  > 1e-12)
+         || (abs(global_blochsection.right_PML) > 1e-12) );
+
+  return (global_section.section_solver == L_anis) || PML_present;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// partial_eigenproblem
+//
+//  True if only global.N eigenvalues of the n x n eigenproblem should be
+//  calculated, namely those closest to the target index.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline bool partial_eigenproblem(int n)
+{
+  return    (abs(global.n_eff_target) > 0)
+         && (global.N > 0) && (int(global.N) < n);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// solve_FG
+//
+//  Eigenvalues and optionally eigenvectors of FG.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cVector solve_FG(const cMatrix& FG, cMatrix* eig=NULL)
+{
+  if (partial_eigenproblem(FG.rows()))
+  {
+    const Complex k0 = 2*pi/global.lambda;
+    const Complex sigma = pow(k0*k0*global.n_eff_target, 2);
+
+    return eigenvalues_shift_invert(FG, sigma, global.N, eig);
+  }
+
+  if (global.stability == normal)
+    return eigenvalues(FG, eig);
+  else
+    return eigenvalues_x(FG, eig);
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // BlochSection2D::find_modes
@@ -1007,31 +1188,30 @@ void BlochSection2D::find_modes()
 
   // Create eigenproblem.
 
-  bool PML_present =  (    (abs(global_slab.lower_PML)         > 1e-12)
-                        || (abs(global_slab.upper_PML)         > 1e-12)
-                        || (abs(global_blochsection.left_PML)  > 1e-12)
-                        || (abs(global_blochsection.right_PML) > 1e-12) );
-
   cMatrix F(2*MN,2*MN,fortranArray);
   cMatrix G(2*MN,2*MN,fortranArray);
 
-  if ( (global_section.section_solver == L_anis) || (PML_present) )
-    create_FG_li_biaxial(&F, & G, M, N, real(alpha0), real(beta0));
+  if (biaxial_formulation())
+  {
+    BiaxialFourier f;
+    calc_fourier_biaxial(M, N, &f);
+    create_FG_li_biaxial(&F, & G, M, N, real(alpha0), real(beta0), f);
+  }
   else
+  {
+    calc_fourier_li(M, N);
     create_FG_li(&F, & G, M, N, alpha0, beta0);
+  }
 
   //create_FG_NT(&F, & G, M, N, alpha0, beta0);
 
   cMatrix FG(2*MN,2*MN,fortranArray);  
   FG.reference(multiply(F,G));
 
-  cVector E(2*MN,fortranArray); 
-  cMatrix eig(2*MN,2*MN,fortranArray); 
+  cVector E(fortranArray); 
+  cMatrix eig(fortranArray); 
 
-  if (global.stability == normal)
-    E = eigenvalues(FG, &eig);
-  else
-    E = eigenvalues_x(FG, &eig);
+  E.reference(solve_FG(FG, &eig));
 
   //vector<Complex> neff;
   //for (int i=1; i<= E.rows(); i++)
@@ -1045,7 +1225,7 @@ void BlochSection2D::find_modes()
 
   // Calculate H fields from E fields.
 
-  cMatrix eig_H(2*MN,2*MN,fortranArray);
+  cMatrix eig_H(2*MN,eig.columns(),fortranArray);
   eig_H.reference(multiply(G,eig));
 
   // Clear modeset.
@@ -1062,15 +1242,7 @@ void BlochSection2D::find_modes()
 
   for (int i=1; i<=E.rows(); i++)
   {
-    Complex kz2 = E(i)/k0/k0;
-    Complex kz = sqrt(kz2);
-
-    if (imag(kz) > 0)
-      kz = -kz;
-
-    if (abs(imag(kz)) < abs(real(kz)))
-      if (real(kz) < 0)
-        kz = -kz;
+    const Complex kz = kz_from_eigenvalue(E(i), k0);
 
     cVector Ex(MN,fortranArray);
     cVector Ey(MN,fortranArray);
@@ -1096,6 +1268,91 @@ void BlochSection2D::find_modes()
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// BlochSection2D::band_structure
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void BlochSection2D::band_structure(const vector<Complex>& kx0,
+                                    const vector<Complex>& ky0,
+                                    cMatrix* kz, int threads)
+{
+  // Check values.
+
+  if (real(global.lambda) == 0)
+  {
+    py_error("Error: wavelength not set.");
+    return;
+  }
+
+  if (kx0.size() != ky0.size())
+  {
+    py_error("Error: kx0 and ky0 have different lengths.");
+    return;
+  }
+
+  const Complex k0 = 2*pi/global.lambda;
+  
+  const int M = global_blochsection.Mx;
+  const int N = global_blochsection.My;
+
+  const int MN = (2*M+1)*(2*N+1);
+
+  const int K = kx0.size();
+
+  kz->resize(K, partial_eigenproblem(2*MN) ? global.N : 2*MN);
+
+  // Calculate the Fourier matrices once, in the calling thread.
+
+  const bool biaxial = biaxial_formulation();
+
+  BiaxialFourier f;
+  
+  if (biaxial)
+    calc_fourier_biaxial(M, N, &f);
+  else
+    calc_fourier_li(M, N);
+
+  // Loop over k-points. Only the eigenvalues are needed, and all the
+  // state is local, so the points are independent.
+
+  const ThreadContext context = get_thread_context();
+
+  #pragma omp parallel num_threads((threads < 1) ? 1 : threads)
+  {
+    ContextSwitch context_switch(context);
+
+    cMatrix F(2*MN,2*MN,fortranArray);
+    cMatrix G(2*MN,2*MN,fortranArray);
+
+    cVector E(fortranArray);
+    
+    #pragma omp for schedule(dynamic)
+    for (int k=0; k<K; k++)
+    {
+      if (biaxial)
+        create_FG_li_biaxial(&F, &G, M, N, real(kx0[k]), real(ky0[k]), f);
+      else
+        create_FG_li(&F, &G, M, N, kx0[k], ky0[k]);
+
+      E.reference(solve_FG(multiply(F,G)));
+
+      vector<Complex> kz_k;
+      for (int i=1; i<=E.rows(); i++)
+        kz_k.push_back(kz_from_eigenvalue(E(i), k0));
+
+      std::sort(kz_k.begin(), kz_k.end(), kzSorter());
+
+      for (int i=1; i<=E.rows(); i++)
+        (*kz)(k+1,i) = kz_k[i-1];
+    }
+  }
 }
 
 
@@ -1265,6 +1522,7 @@ void UniformBlochSection::find_modes()
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
 }
 
 
@@ -40,7 +40,29 @@ struct BlochSectionGlobal
     Real PML_fraction;
 };
 
-extern BlochSectionGlobal global_blochsection;
+extern thread_local BlochSectionGlobal global_blochsection;
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// STRUCT: BiaxialFourier
+//
+//   Fourier matrices of the material tensors used in the Li formulation
+//   for biaxial media. They depend on the geometry and the PML settings,
+//   but not on the Bloch wavevector.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+struct BiaxialFourier
+{
+    BiaxialFourier()
+      : eps_1(fortranArray), eps_2(fortranArray), eps_3(fortranArray),
+         mu_1(fortranArray),  mu_2(fortranArray),  mu_3(fortranArray) {}
+
+    cMatrix eps_1, eps_2, eps_3;
+    cMatrix  mu_1,  mu_2,  mu_3;
+};
 
 
 
@@ -81,6 +103,15 @@ class BlochSectionImpl : public MultiWaveguide
     Complex get_kx0() const {return global_blochsection.alpha0;}
     Complex get_ky0() const {return global_blochsection.beta0;}    
 
+    // Propagation constants for a list of Bloch wavevectors (kx0, ky0).
+    // Row k of 'kz' contains the sorted kz values of all the modes at
+    // the k'th point. The Bloch wavevector of the calling thread is left
+    // untouched. This default implementation solves the points one by one.
+
+    virtual void band_structure(const std::vector<Complex>& kx0,
+                                const std::vector<Complex>& ky0,
+                                cMatrix* kz, int threads);
+
     void calc_overlap_matrices
       (MultiWaveguide*, cMatrix*, cMatrix*,
        cMatrix* O_I_I=NULL, cMatrix* O_II_II=NULL);
@@ -158,6 +189,11 @@ class BlochSection : public MultiWaveguide
 
     Complex get_kx0() const {return s->get_kx0();}
     Complex get_ky0() const {return s->get_ky0();}
+
+    void band_structure(const std::vector<Complex>& kx0,
+                        const std::vector<Complex>& ky0,
+                        cMatrix* kz, int threads)
+      {s->band_structure(kx0, ky0, kz, threads);}
    
     std::string repr() const {return s->repr();}
     
@@ -217,6 +253,13 @@ class BlochSection2D : public BlochSectionImpl
 
     void set_theta_phi(Real theta, Real phi) const;
 
+    // Solves the k-points in parallel on 'threads' threads, reusing the
+    // Fourier matrices, which don't depend on the Bloch wavevector.
+
+    void band_structure(const std::vector<Complex>& kx0,
+                        const std::vector<Complex>& ky0,
+                        cMatrix* kz, int threads);
+
   protected:
 
     // TODO: see if we can remove st.
@@ -226,16 +269,31 @@ class BlochSection2D : public BlochSectionImpl
     void create_FG_NT(cMatrix* F, cMatrix* G, int M, int N,
                       const Complex& alpha0, const Complex& beta0);  
 
+    // The Fourier matrices don't depend on alpha0 and beta0, so they are
+    // calculated separately. create_FG_li and create_FG_li_biaxial are
+    // const, so that several k-points can be set up concurrently.
+
+    void calc_fourier_li(int M, int N);
+
     void create_FG_li(cMatrix* F, cMatrix* G, int M, int N,
-                      const Complex& alpha0, const Complex& beta0);    
+                      const Complex& alpha0, const Complex& beta0) const;
+
+    void calc_fourier_biaxial(int M, int N, BiaxialFourier* f) const;
 
     void create_FG_li_biaxial(cMatrix* F, cMatrix* G, int M, int N,
-                      const Complex& alpha0, const Complex& beta0);
+                      const Complex& alpha0, const Complex& beta0,
+                      const BiaxialFourier& f) const;
 
     std::vector<Material*> materials;
 
     cMatrix inv_eps_2, eps_x_y, eps_y_x; // Cache these.
 
+    // Material versions and stability setting the cached matrices were
+    // calculated for.
+
+    unsigned long fourier_materials_version;
+    Stability     fourier_stability;
+
     friend class BlochSectionMode;
 };
 
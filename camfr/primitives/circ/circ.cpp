@@ -13,10 +13,12 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <typeinfo>
 #include "circ.h"
 #include "circdisp.h"
 #include "circmode.h"
 #include "circoverlap.h"
+#include "../../diskcache.h"
 
 using std::vector;
 
@@ -30,7 +32,7 @@ using std::vector;
 //
 /////////////////////////////////////////////////////////////////////////////
 
-CircGlobal global_circ = {0.0, 1, cos_type};
+thread_local CircGlobal global_circ = {0.0, 1, cos_type};
 
 
 
@@ -132,6 +134,32 @@ bool Circ_M::operator==(const Waveguide& w_) const
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Circ_M::disk_key
+//
+/////////////////////////////////////////////////////////////////////////////
+
+std::string Circ_M::disk_key() const
+{
+  std::ostringstream s;
+
+  s << typeid(*this).name() << " " << solver_key()
+    << " PML=" << key_number(global_circ.PML)
+    << " order=" << global_circ.order
+    << " fieldtype=" << global_circ.fieldtype;
+
+  s << " rings=";
+  for (unsigned int i=0; i<radius.size(); i++)
+    s << key_number(radius[i]) << ";"
+      << key_number(material[i]->n()) << ";"
+      << key_number(material[i]->mur()) << ";";
+
+  return s.str();
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Circ_M::contains
@@ -284,6 +312,7 @@ void Circ_M::find_modes()
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
 }
 
 
@@ -778,19 +807,97 @@ void Circ_2::find_modes()
   // combination, use these as an initial estimate, else find them
   // from scratch.
   
-  if (global.sweep_from_previous && lossy && (modeset.size() == global.N))
-    find_modes_by_sweep();
-  else
-    if (global.solver == ADR)
-      find_modes_from_scratch_by_ADR();
+  // Modes in disk cache? Not used when sweeping, since sweeps depend on
+  // the state left by the previous calculation.
+
+  const std::string key = (disk_cache.is_open() && !global.sweep_from_previous)
+    ? disk_key() : "";
+
+  const bool cached = !key.empty() && load_modes(key);
+
+  if (!cached)
+  {
+    if (global.sweep_from_previous && lossy && (modeset.size() == global.N))
+      find_modes_by_sweep();
     else
-      find_modes_from_scratch_by_track();
+      if (global.solver == ADR)
+        find_modes_from_scratch_by_ADR();
+      else
+        find_modes_from_scratch_by_track();
+
+    if (!key.empty())
+      save_modes(key);
+  }
 
   // Remember wavelength and gain these modes were calculated for.
 
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Circ_2::load_modes
+//
+//   Rebuilds the modeset from kz, kr1 and kr2 stored in the disk cache.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool Circ_2::load_modes(const std::string& key)
+{
+  vector<Complex> data;
+
+  if (!disk_cache.load(key, &data) || (data.size() % 3))
+    return false;
+
+  for (unsigned int i=0; i<modeset.size(); i++)
+    delete modeset[i];
+  modeset.clear();
+
+  no_of_guided_modes = 0;
+
+  for (unsigned int i=0; i<data.size(); i+=3)
+  {
+    Circ_2_Mode *newmode = new Circ_2_Mode
+      (Polarisation(unknown), data[i], data[i+1], data[i+2], this);
+
+    newmode->normalise();
+
+    modeset.push_back(newmode);
+
+    if (abs(real(data[i])) > abs(imag(data[i])))
+      no_of_guided_modes++;
+  }
+
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Circ_2::save_modes
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void Circ_2::save_modes(const std::string& key)
+{
+  vector<Complex> data;
+
+  for (unsigned int i=0; i<modeset.size(); i++)
+  {
+    CircMode* mode = dynamic_cast<CircMode*>(modeset[i]);
+
+    data.push_back(mode->get_kz());
+    data.push_back(mode->get_kr()[0]);
+    data.push_back(mode->get_kr()[1]);
+  }
+
+  disk_cache.save(key, data);
 }
 
 
@@ -1489,6 +1596,7 @@ void Circ_1::find_modes()
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
 }
 
 
@@ -38,7 +38,7 @@ struct CircGlobal
     Fieldtype fieldtype;
 };
 
-extern CircGlobal global_circ;
+extern thread_local CircGlobal global_circ;
 
 
 
@@ -100,6 +100,8 @@ class Circ_M : public MultiWaveguide
     void calc_overlap_matrices
       (MultiWaveguide* w, cMatrix* O_I_II, cMatrix* O_II_I,
        cMatrix* O_I_I=NULL, cMatrix* O_II_II=NULL);
+
+    std::string disk_key() const;
     
     // Create uniform stretching, starting halfway in outer region
     // and giving this particular complex R.
@@ -154,6 +156,9 @@ class Circ_2 : public Circ_M
     void find_modes_from_scratch_by_ADR();
     void find_modes_from_scratch_by_track();
     void find_modes_by_sweep();
+
+    bool load_modes(const std::string& key);
+    void save_modes(const std::string& key);
     
     std::vector<Complex> kr2_backward;
     std::vector<Complex> guided_disp_params;
@@ -234,6 +239,8 @@ class Circ : public MultiWaveguide
                                        O_I_II,O_II_I,O_I_I,O_II_II);}
 
     std::string repr() const {return c->repr();}
+
+    std::string disk_key() const {return c->disk_key();}
     
   protected:
 
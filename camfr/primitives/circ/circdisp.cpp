@@ -311,10 +311,70 @@ void Circ_2_closed::ab_TE_TM(Complex* a_TE, Complex* b_TE,
 //
 /////////////////////////////////////////////////////////////////////////////
 
-Complex Circ_2_closed::operator()(const Complex& kr2_)
+Complex Circ_2_closed::operator()(const Complex& kr2)
 {
   counter++;
 
+  return dispersion(kr2, constants());
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Circ_2_closed::evaluate
+//
+//   Batched version of operator(), which only calculates the material
+//   constants once.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void Circ_2_closed::evaluate(const Complex* kr2, Complex* result, int n)
+{
+  counter += n;
+
+  const DispConstants c = constants();
+
+  for (int i=0; i<n; i++)
+    result[i] = dispersion(kr2[i], c);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Circ_2_closed::constants
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Circ_2_closed::DispConstants Circ_2_closed::constants() const
+{
+  DispConstants c;
+
+  c.epsr1 =     core.epsr();
+  c.epsr2 = cladding.epsr();
+  c.mur1  =     core.mur();
+  c.mur2  = cladding.mur();
+
+  c.k0 = 2*pi/lambda;
+
+  c.k0_2_epsr1_mur1 = c.k0*c.k0*c.epsr1*c.mur1;
+  c.k0_2_epsr2_mur2 = c.k0*c.k0*c.epsr2*c.mur2;
+
+  return c;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Circ_2_closed::dispersion
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Complex Circ_2_closed::dispersion(const Complex& kr2_,
+                                  const DispConstants& c) const
+{
   // This function is mathematically even in kr2. However, it is only
   // numerically stable in one half plane.
 
@@ -328,14 +388,14 @@ Complex Circ_2_closed::operator()(const Complex& kr2_)
 
   const Real    eps   = 1e-15;
   
-  const Complex epsr1 =     core.epsr();
-  const Complex epsr2 = cladding.epsr();
-  const Complex mur1  =     core.mur();
-  const Complex mur2  = cladding.mur();
+  const Complex& epsr1 = c.epsr1;
+  const Complex& epsr2 = c.epsr2;
+  const Complex& mur1  = c.mur1;
+  const Complex& mur2  = c.mur2;
   
-  const Complex k0    = 2*pi/lambda;
-  const Complex beta2 = k0*k0*epsr2*mur2 - kr2*kr2;
-  const Complex kr1   = signedsqrt(k0*k0*epsr1*mur1 - beta2, core);
+  const Complex& k0    = c.k0;
+  const Complex  beta2 = c.k0_2_epsr2_mur2 - kr2*kr2;
+  const Complex  kr1   = signedsqrt(c.k0_2_epsr1_mur1 - beta2, core);
 
   // Limit for kr2=0.
 
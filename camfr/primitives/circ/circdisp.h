@@ -153,12 +153,22 @@ class Circ_2_closed : public ComplexFunction
                   const Complex& kr2) const;
 
     Complex operator()(const Complex& kr2);
+    void evaluate(const Complex* kr2, Complex* result, int n);
 
     std::vector<Complex> get_params() const;
     void set_params(const std::vector<Complex>&);
         
   protected:
 
+    struct DispConstants
+    {
+        Complex epsr1, epsr2, mur1, mur2, k0;
+        Complex k0_2_epsr1_mur1, k0_2_epsr2_mur2;
+    };
+
+    DispConstants constants() const;
+    Complex dispersion(const Complex& kr2, const DispConstants& c) const;
+
           Complex      r;         // core radius
           Complex      R;         // metal cylinder radius
           Material     core;
@@ -200,6 +210,9 @@ class Circ_2_closed_cutoff : public Circ_2_closed
                       rad,hankel,pol_0,scale_always) {}
 
     Complex operator()(const Complex& kr2);
+
+    void evaluate(const Complex* kr2, Complex* result, int n)
+      {ComplexFunction::evaluate(kr2, result, n);}
 };
 
 
@@ -228,6 +241,9 @@ class Circ_2_closed_rad_lossless : public Circ_2_closed
                       rad,hankel,pol_0,scale_always) {}
 
     Complex operator()(const Complex& kr2);
+
+    void evaluate(const Complex* kr2, Complex* result, int n)
+      {ComplexFunction::evaluate(kr2, result, n);}
 };
 
 
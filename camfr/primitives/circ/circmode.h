@@ -42,6 +42,8 @@ class CircMode : public Mode
     
     Complex kr_at(const Coord& coord) const
       {return kr[index_lookup(coord.c1, coord.c1_limit, geom->radius)];}
+
+    const std::vector<Complex>& get_kr() const {return kr;}
     
     Field field_at(const Coord& coord, Complex* dEzdr=0,
                    Complex* dHzdr=0, bool ang_dep=true) const
@@ -18,7 +18,7 @@
 //
 /////////////////////////////////////////////////////////////////////////////
 
-Complex Planar::kt = 0.0;
+thread_local Complex Planar::kt = 0.0;
 
 
 
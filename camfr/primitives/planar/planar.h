@@ -60,7 +60,7 @@ class Planar : public MonoWaveguide
     // Transverse component of wavevector is same for all layers in stack
     // because of Snell's law.
     
-    static Complex kt;
+    static thread_local Complex kt;
 
     Complex calc_kz() const;
 
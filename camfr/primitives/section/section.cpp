@@ -22,6 +22,8 @@
 #include "../slab/isoslab/slabmode.h"
 #include "../slab/isoslab/slaboverlap.h"
 #include "../../math/calculus/fourier/fourier.h"
+#include "../../math/calculus/fourier/toeplitz.h"
+#include "../../context.h"
 
 using std::vector;
 using std::cout;
@@ -36,8 +38,9 @@ using std::endl;
 //
 /////////////////////////////////////////////////////////////////////////////
 
-SectionGlobal global_section = {0.0,0.0,E_wall,E_wall,L,none,0,0,2.0,
-   false,0.5,1.0,false,true,false,true,true,false,10.,50,0.0,0.0,1.0,false};
+thread_local SectionGlobal global_section
+  = {0.0,0.0,E_wall,E_wall,L,none,0,0,2.0,false,0.5,1.0,false,true,false,
+     true,true,false,10.,50,0.0,0.0,1.0,false};
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -531,6 +534,9 @@ Section2D::Section2D
 
   sort = highest_index;
 
+  mirror_x = false;
+  mirror_y = false;
+
   uniform = false;
 
   symmetric =     (&left_ex == &right_ex) 
@@ -601,6 +607,8 @@ Section2D::Section2D(const Section2D& section)
   right     = section.right;
   core      = section.core;
   sort      = section.sort;
+  mirror_x  = section.mirror_x;
+  mirror_y  = section.mirror_y;
   uniform   = section.uniform;
   symmetric = section.symmetric;
 }
@@ -623,6 +631,8 @@ Section2D& Section2D::operator=(const Section2D& section)
   right     = section.right;
   core      = section.core;
   sort      = section.sort;
+  mirror_x  = section.mirror_x;
+  mirror_y  = section.mirror_y;
   uniform   = section.uniform;
   symmetric = section.symmetric;
   
@@ -711,6 +721,7 @@ void Section2D::find_modes()
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
 }
 
 
@@ -951,9 +962,16 @@ void rebuild_slabs(const vector<Slab*>& slabs, const vector<Complex>& disc,
 //
 //   Noponen/Turunen formulation
 //
+//   Returns the product FG directly, rather than F. F is
+//   [alpha; beta].inv_eps.[beta, -alpha] plus k0^2 times a block
+//   permutation, with inv_eps the Toeplitz matrix of 1/eps. The diagonal
+//   terms cancel in F.G, which then only needs inv_eps.[alpha.eps, beta.eps].
+//   BlockToeplitz::multiply evaluates that with FFTs, rather than forming
+//   F and doing a dense 2MN x 2MN product.
+//
 /////////////////////////////////////////////////////////////////////////////
 
-void Section2D::create_FG_NT(cMatrix* F, cMatrix* G, int M, int N,
+void Section2D::create_FG_NT(cMatrix* FG, cMatrix* G, int M, int N,
                              const Complex& alpha0, const Complex& beta0)
 {
   const Complex k0 = 2*pi/global.lambda;
@@ -998,22 +1016,7 @@ void Section2D::create_FG_NT(cMatrix* F, cMatrix* G, int M, int N,
   const int MN = m_*n_;
   
   cMatrix eps(MN,MN,fortranArray);
-  cMatrix inv_eps(MN,MN,fortranArray);
-
-  for (int m=-M; m<=M; m++)
-    for (int n=-N; n<=N; n++)
-    {
-      int i1 = (m+M+1) + (n+N)*(2*M+1);
-     
-      for (int j=-M; j<=M; j++)
-        for (int l=-N; l<=N; l++)
-        {
-          int i2 = (j+M+1) + (l+N)*(2*M+1);
-
-              eps(i1,i2) = eps_(m-j + 2*M+1, n-l + 2*N+1);
-          inv_eps(i1,i2) = inv_eps_(m-j + 2*M+1, n-l + 2*N+1);
-        }
-    }
+  eps.reference(BlockToeplitz(eps_, M, N).dense());
 
   // Calculate alpha and beta vector.
 
@@ -1029,38 +1032,51 @@ void Section2D::create_FG_NT(cMatrix* F, cMatrix* G, int M, int N,
        beta(i) =  beta0 + n*2.*pi/get_height()/2.;
     }
 
-  // Constuct F matrix.
+  // Construct G matrix.
 
   for (int i1=1; i1<=MN; i1++)
     for (int i2=1; i2<=MN; i2++)
     {
-      (*F)(i1,   i2)    =  alpha(i1) * inv_eps(i1,i2) *  beta(i2);
-      (*F)(i1,   i2+MN) = -alpha(i1) * inv_eps(i1,i2) * alpha(i2);
-      (*F)(i1+MN,i2)    =   beta(i1) * inv_eps(i1,i2) *  beta(i2);
-      (*F)(i1+MN,i2+MN) =  -beta(i1) * inv_eps(i1,i2) * alpha(i2);
+
+      (*G)(i1,   i2)    = (i1==i2) ? -alpha(i1)*beta(i2) : 0.0;
+      (*G)(i1,   i2+MN) = -k0*k0 * eps(i1,i2);
+      (*G)(i1+MN,i2)    =  k0*k0 * eps(i1,i2);
+      (*G)(i1+MN,i2+MN) = (i1==i2) ?  alpha(i1)*beta(i2) : 0.0;
 
       if (i1==i2)
       {
-        (*F)(i1,   i2+MN) += k0*k0;
-        (*F)(i1+MN,i2)    -= k0*k0;
+        (*G)(i1,   i2+MN) += alpha(i1)*alpha(i1);
+        (*G)(i1+MN,i2)    -=  beta(i2)*beta(i2);
       }
     }
 
-  // Construct G matrix.
+  // Construct FG matrix.
 
+  cMatrix eps_ab(MN,2*MN,fortranArray);
   for (int i1=1; i1<=MN; i1++)
     for (int i2=1; i2<=MN; i2++)
     {
+      eps_ab(i1,i2)    = alpha(i1) * eps(i1,i2);
+      eps_ab(i1,i2+MN) =  beta(i1) * eps(i1,i2);
+    }
 
-      (*G)(i1,   i2)    = (i1==i2) ? -alpha(i1)*beta(i2) : 0.0;
-      (*G)(i1,   i2+MN) = -k0*k0 * eps(i1,i2);
-      (*G)(i1+MN,i2)    =  k0*k0 * eps(i1,i2);
-      (*G)(i1+MN,i2+MN) = (i1==i2) ?  alpha(i1)*beta(i2) : 0.0;
+  cMatrix Y(MN,2*MN,fortranArray);
+  Y.reference(BlockToeplitz(inv_eps_, M, N).multiply(eps_ab));
+
+  for (int i1=1; i1<=MN; i1++)
+    for (int i2=1; i2<=MN; i2++)
+    {
+      (*FG)(i1,   i2)    = k0*k0 * (k0*k0*eps(i1,i2) - alpha(i1)*Y(i1,i2));
+      (*FG)(i1,   i2+MN) = -k0*k0 * alpha(i1)*Y(i1,i2+MN);
+      (*FG)(i1+MN,i2)    = -k0*k0 *  beta(i1)*Y(i1,i2);
+      (*FG)(i1+MN,i2+MN) = k0*k0 * (k0*k0*eps(i1,i2) - beta(i1)*Y(i1,i2+MN));
 
       if (i1==i2)
       {
-        (*G)(i1,   i2+MN) += alpha(i1)*alpha(i1);
-        (*G)(i1+MN,i2)    -=  beta(i2)*beta(i2);
+        (*FG)(i1,   i2)    -= k0*k0 *  beta(i1)*beta(i1);
+        (*FG)(i1,   i2+MN) += k0*k0 * alpha(i1)*beta(i1);
+        (*FG)(i1+MN,i2)    += k0*k0 * alpha(i1)*beta(i1);
+        (*FG)(i1+MN,i2+MN) -= k0*k0 * alpha(i1)*alpha(i1);
       }
     }
 
@@ -1143,19 +1159,7 @@ void Section2D::create_FG_li(cMatrix* F, cMatrix* G, int M, int N,
   
   cMatrix eps(MN,MN,fortranArray);
 
-  for (int m=-M; m<=M; m++)
-    for (int n=-N; n<=N; n++)
-    {
-      int i1 = (m+M+1) + (n+N)*(2*M+1);
-     
-      for (int j=-M; j<=M; j++)
-        for (int l=-N; l<=N; l++)
-        {
-          int i2 = (j+M+1) + (l+N)*(2*M+1);
-
-          eps(i1,i2) = eps_(m-j + 2*M+1, n-l + 2*N+1);
-        }
-    }
+  eps.reference(BlockToeplitz(eps_, M, N).dense());
 
   cMatrix inv_eps_2(MN,MN,fortranArray);
   if (global.stability != SVD)
@@ -1431,20 +1435,8 @@ void Section2D::create_FG_li_biaxial(cMatrix* F, cMatrix* G, int M, int N,
 
   cMatrix eps_3_(MN,MN,fortranArray), mu_3_(MN,MN,fortranArray);
 
-  for (int m=-M; m<=M; m++)
-    for (int n=-N; n<=N; n++)
-    {
-      int i1 = (n+N+1) + (m+M)*(2*N+1);
-     
-      for (int j=-M; j<=M; j++)
-        for (int l=-N; l<=N; l++)
-        {
-          int i2 = (l+N+1) + (j+M)*(2*N+1);
-
-          eps_3_(i1,i2) = eps_3_f(m-j + 2*M+1, n-l + 2*N+1);          
-           mu_3_(i1,i2) =  mu_3_f(m-j + 2*M+1, n-l + 2*N+1);
-        }
-    }
+  eps_3_.reference(BlockToeplitz(eps_3_f, M, N, false).dense());
+   mu_3_.reference(BlockToeplitz( mu_3_f, M, N, false).dense());
 
   cMatrix eps_2(MN,MN,fortranArray), mu_2(MN,MN,fortranArray); 
   cMatrix eps_3(MN,MN,fortranArray), mu_3(MN,MN,fortranArray);
@@ -1927,20 +1919,8 @@ void Section2D::create_FG_ASR(cMatrix* F, cMatrix* G, int M, int N,
   cMatrix eps_f_g(MN,MN,fortranArray);
   cMatrix f_g(MN,MN,fortranArray);
 
-  for (int m=-M; m<=M; m++)
-    for (int n=-N; n<=N; n++)
-    {
-      int i1 = (m+M+1) + (n+N)*(2*M+1);
-     
-      for (int j=-M; j<=M; j++)
-        for (int l=-N; l<=N; l++)
-        {
-          int i2 = (j+M+1) + (l+N)*(2*M+1);
-
-          eps_f_g(i1,i2) = eps_f_g_(m-j + 2*M+1, n-l + 2*N+1);
-          f_g(i1,i2) = f_g_(m-j + 2*M+1, n-l + 2*N+1);
-        }
-    }
+  eps_f_g.reference(BlockToeplitz(eps_f_g_, M, N).dense());
+  f_g.    reference(BlockToeplitz(f_g_, M, N).dense());
 
   // Inverse (double) Toeplitz matrices.
 
@@ -2265,6 +2245,192 @@ struct IndexConvertor
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// solve_reduced
+//
+//   Solves the reduced eigenproblem A, or only the n_wanted eigenvalues
+//   closest to the target index if one was set.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cVector solve_reduced(const cMatrix& A, int n_wanted, cMatrix* eig,
+                      bool* partial)
+{
+  const Complex k0 = 2*pi/global.lambda;
+
+  *partial = (abs(global.n_eff_target) > 0) && (n_wanted < A.rows());
+
+  if (*partial)
+  {
+    const Complex sigma = pow(k0*k0*global.n_eff_target, 2);
+    return eigenvalues_shift_invert(A, sigma, n_wanted, eig);
+  }
+
+  if (global.stability == normal)
+    return eigenvalues(A, eig);
+  else
+    return eigenvalues_x(A, eig);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// symmetry_class
+//
+//   Parity class of row r of the reduced eigenproblem. The cosine/sine
+//   harmonics (j,l) with different parities of j (l) are uncoupled if
+//   the section is mirror symmetric in x (y) w.r.t. its centre.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline int symmetry_class(int r, int M, int MN_, 
+                          bool mirror_x, bool mirror_y)
+{
+  const int q = (r-1) % MN_;
+  
+  const int j = q % (M+1);
+  const int l = q / (M+1);
+
+  return (mirror_x ? j%2 : 0) + (mirror_y ? 2*(l%2) : 0);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// solve_symmetry_blocks
+//
+//   Splits the reduced eigenproblem FG_ into uncoupled parity blocks,
+//   solves these concurrently and assembles the results in the regular
+//   cosine/sine basis. If the section turns out not to be symmetric,
+//   the full problem is solved instead.
+//
+//   'block_sizes' returns the sizes of the four parity blocks, or is
+//   left empty if the full problem was solved.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+cVector solve_symmetry_blocks(const cMatrix& FG_, int M, int MN_,
+                              bool mirror_x, bool mirror_y, int n_wanted,
+                              cMatrix* eig, bool* partial,
+                              vector<int>* block_sizes)
+{
+  block_sizes->clear();
+
+  // Partition rows.
+
+  vector<vector<int> > rows(4);
+
+  for (int r=1; r<=FG_.rows(); r++)
+    rows[symmetry_class(r, M, MN_, mirror_x, mirror_y)].push_back(r);
+
+  // Check if the section is really symmetric.
+
+  Real max_coupling = 0.0;
+  Real max_element  = 0.0;
+
+  for (int r=1; r<=FG_.rows(); r++)
+  {
+    const int class_r = symmetry_class(r, M, MN_, mirror_x, mirror_y);
+    
+    for (int c=1; c<=FG_.columns(); c++)
+    {
+      const Real a = abs(FG_(r,c));
+
+      if (a > max_element)
+        max_element = a;
+
+      if (    (a > max_coupling)
+           && (symmetry_class(c, M, MN_, mirror_x, mirror_y) != class_r) )
+        max_coupling = a;
+    }
+  }
+
+  if (max_coupling > 1e-6*max_element)
+  {
+    py_error("Warning: section is not symmetric w.r.t. the given planes.");
+    py_error("Solving without symmetry reduction.");
+    return solve_reduced(FG_, n_wanted, eig, partial);
+  }
+
+  // Solve blocks.
+
+  for (int b=0; b<4; b++)
+    block_sizes->push_back(rows[b].size());
+
+  vector<cVector> E_b(4);
+  vector<cMatrix> eig_b(4);
+  vector<int>     partial_b(4, 0);
+
+  const ThreadContext context = get_thread_context();
+
+  const int threads = (global.threads < 1) ? 1 : global.threads;
+
+  #pragma omp parallel for num_threads(threads) schedule(dynamic)
+  for (int b=0; b<4; b++)
+  {
+    ContextSwitch context_switch(context);
+
+    const int n = rows[b].size();
+
+    if (n == 0)
+      continue;
+
+    cMatrix A(n,n,fortranArray);
+
+    for (int i=1; i<=n; i++)
+      for (int j=1; j<=n; j++)
+        A(i,j) = FG_(rows[b][i-1], rows[b][j-1]);
+
+    bool partial_block;
+
+    eig_b[b].reference(cMatrix(fortranArray));
+    E_b[b].reference(solve_reduced(A, n_wanted, &eig_b[b], &partial_block));
+
+    partial_b[b] = partial_block;
+  }
+
+  // Assemble eigenvalues and eigenvectors.
+
+  int columns = 0;
+  for (int b=0; b<4; b++)
+    if (rows[b].size())
+      columns += E_b[b].rows();
+
+  cVector E(columns,fortranArray);
+
+  eig->resize(FG_.rows(), columns);
+  *eig = 0.0;
+
+  *partial = false;
+
+  int c = 0;
+  for (int b=0; b<4; b++)
+  {
+    if (rows[b].size() == 0)
+      continue;
+
+    if (partial_b[b])
+      *partial = true;
+
+    for (int i=1; i<=E_b[b].rows(); i++)
+    {
+      c++;
+
+      E(c) = E_b[b](i);
+
+      for (int r=1; r<=int(rows[b].size()); r++)
+        (*eig)(rows[b][r-1],c) = eig_b[b](r,i);
+    }
+  }
+
+  return E;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Section2D::estimate_kz2_fourier
@@ -2338,22 +2504,26 @@ vector<ModeEstimate*> Section2D::estimate_kz2_fourier()
                         || (abs(global_section.left_PML)  > 1e-12)
                         || (abs(global_section.right_PML) > 1e-12) );
 
-  cMatrix F(2*MN,2*MN,fortranArray);
-  cMatrix G(2*MN,2*MN,fortranArray);
+  cMatrix  G(2*MN,2*MN,fortranArray);
+  cMatrix FG(2*MN,2*MN,fortranArray);
 
   if (global_section.section_solver == NT)
-    create_FG_NT(&F, & G, M, N, alpha0, beta0);
-  else if (     (global_section.section_solver == L_anis) 
-            || ((global_section.section_solver == L) && PML_present) )
-    create_FG_li_biaxial(&F, & G, M, N, real(alpha0), real(beta0));
-  else if (global_section.section_solver == L)
-    create_FG_li(&F, & G, M, N, alpha0, beta0);
-   else if (global_section.section_solver == ASR_2D 
-         || global_section.section_solver == ASR_2D_stretched)
-  	create_FG_ASR(&F, & G, M, N, alpha0, beta0);
-
-  cMatrix FG(2*MN,2*MN,fortranArray);  
-  FG.reference(multiply(F,G));
+    create_FG_NT(&FG, & G, M, N, alpha0, beta0);
+  else
+  {
+    cMatrix F(2*MN,2*MN,fortranArray);
+
+    if (     (global_section.section_solver == L_anis) 
+         || ((global_section.section_solver == L) && PML_present) )
+      create_FG_li_biaxial(&F, & G, M, N, real(alpha0), real(beta0));
+    else if (global_section.section_solver == L)
+      create_FG_li(&F, & G, M, N, alpha0, beta0);
+    else if (global_section.section_solver == ASR_2D 
+          || global_section.section_solver == ASR_2D_stretched)
+      create_FG_ASR(&F, & G, M, N, alpha0, beta0);
+
+    FG.reference(multiply(F,G));
+  }
 
   bool reduced = global_section.reduced_eigenmatrix;
   
@@ -2550,15 +2720,26 @@ vector<ModeEstimate*> Section2D::estimate_kz2_fourier()
     }
   }
 
-  // Solve reduced eigenvalue problem.
+  // Solve reduced eigenvalue problem. If a target index is given, only
+  // calculate the eigenvalues closest to it, with a few spare ones to
+  // replace spurious solutions. If symmetry planes were given, the 
+  // uncoupled parity blocks are solved separately.
+
+  const int n_wanted = global.N + 4;
 
-  cVector E_(2*M_*N_,fortranArray);
-  cMatrix eig_(2*M_*N_,2*M_*N_,fortranArray); 
+  bool partial;
+
+  cVector E_(fortranArray);
+  cMatrix eig_(fortranArray); 
   
-  if (global.stability == normal)
-    E_ = eigenvalues(FG_, &eig_);
+  symmetry_blocks.clear();
+  
+  if (mirror_x || mirror_y)
+    E_.reference(solve_symmetry_blocks(FG_, M, MN_, mirror_x, mirror_y,
+                                       n_wanted, &eig_, &partial,
+                                       &symmetry_blocks));
   else
-    E_ = eigenvalues_x(FG_, &eig_);
+    E_.reference(solve_reduced(FG_, n_wanted, &eig_, &partial));
 
   // The following code is only used to generate output.
 
@@ -2627,9 +2808,9 @@ vector<ModeEstimate*> Section2D::estimate_kz2_fourier()
   // TODO: try to do this using reduced matrices, or at least return
   // a reduced vector.
  
-  cMatrix eig_big(2*MN,2*MN_,fortranArray); 
+  cMatrix eig_big(2*MN,eig_.columns(),fortranArray); 
 
-  for (int i1=1; i1<=2*MN_; i1++)
+  for (int i1=1; i1<=eig_.columns(); i1++)
   {
     // j == 0, l == 0
 
@@ -2697,7 +2878,7 @@ vector<ModeEstimate*> Section2D::estimate_kz2_fourier()
 
   // Calculate H fields from E fields.
 
-  cMatrix eig_big_H(2*MN,2*MN_,fortranArray);
+  cMatrix eig_big_H(2*MN,eig_big.columns(),fortranArray);
   eig_big_H.reference(multiply(G,eig_big));
 
   // Return estimates.
@@ -2769,7 +2950,10 @@ vector<ModeEstimate*> Section2D::estimate_kz2_fourier()
   //  std::cout << "sorted " << i << " " << sqrt(estimates[i]->kz2)/k0 
   //            << std::endl;
 
-  if (estimates.size() > 4)
+  // Drop the lowest solutions of the full eigenproblem. These are not
+  // calculated in the partial case.
+
+  if (!partial && (estimates.size() > 4))
     for (int i=0; i<(TEM ? 3 : 4); i++)
     {
       delete estimates.back();
@@ -3195,5 +3379,6 @@ void Section1D::find_modes()
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
 }
 
@@ -63,7 +63,7 @@ struct SectionGlobal
     bool extended_output;
 };
 
-extern SectionGlobal global_section;
+extern thread_local SectionGlobal global_section;
 
 
 
@@ -94,6 +94,8 @@ class SectionImpl : public MultiWaveguide
 
     virtual void set_sorting(Sort_type s) {}
     virtual void set_estimate(const Complex& c) {}
+    virtual void set_symmetry(bool x, bool y) {}
+    virtual int symmetry_block_size(int b) const {return 0;}
 
     int get_M1() const {return M1;}
     int get_M2() const {return M2;}
@@ -163,6 +165,8 @@ class Section : public MultiWaveguide
 
     void set_sorting(Sort_type sort)    {s->set_sorting(sort);}
     void set_estimate(const Complex& c) {s->set_estimate(c);}
+    void set_symmetry(bool x, bool y)   {s->set_symmetry(x, y);}
+    int symmetry_block_size(int b) const {return s->symmetry_block_size(b);}
 
     void find_modes() {return s->find_modes();}
     
@@ -278,6 +282,18 @@ class Section2D : public SectionImpl
     void set_sorting (Sort_type sort_)  {sort = sort_;}
     void set_estimate(const Complex& c) {user_estimates.push_back(c);}
 
+    // Declare mirror planes through the centre of the section, normal
+    // to x and/or y. These are used to split the Fourier eigenproblem.
+
+    void set_symmetry(bool x, bool y) {mirror_x = x; mirror_y = y;}
+
+    // Size of parity block b (0..3) in the last Fourier eigenproblem, or
+    // zero if it was solved without symmetry reduction.
+
+    int symmetry_block_size(int b) const
+      {return ((b>=0) && (b<int(symmetry_blocks.size())))
+                ? symmetry_blocks[b] : 0;}
+
     void find_modes();
 
   protected:
@@ -287,6 +303,11 @@ class Section2D : public SectionImpl
 
     bool symmetric;
 
+    bool mirror_x;
+    bool mirror_y;
+
+    std::vector<int> symmetry_blocks;
+
     Sort_type sort;
 
     void find_modes_from_estimates();
@@ -296,7 +317,7 @@ class Section2D : public SectionImpl
     std::vector<ModeEstimate*> estimate_kz2_omar_schuenemann();
     std::vector<ModeEstimate*> estimate_kz2_fourier();    
 
-    void create_FG_NT(cMatrix* F, cMatrix* G, int M, int N,
+    void create_FG_NT(cMatrix* FG, cMatrix* G, int M, int N,
                       const Complex& alpha0, const Complex& beta0);
 
     void create_FG_li(cMatrix* F, cMatrix* G, int M, int N,
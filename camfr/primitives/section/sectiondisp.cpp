@@ -175,6 +175,57 @@ Complex SectionDisp::operator()(const Complex& kt2)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// SectionDisp::evaluate
+//
+//   Batched version of operator(), which only saves and restores the
+//   global settings once.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void SectionDisp::evaluate(const Complex* kt2, Complex* result, int n)
+{
+  counter += n;
+
+  global.lambda = lambda;
+  global.polarisation = TE_TM;
+
+  bool old_orthogonal = global.orthogonal;
+  global.orthogonal = false;
+
+  Complex old_beta = global.slab_ky;
+
+  int old_N = global.N;
+  global.N = M;
+
+  const Complex C = pow(2*pi/lambda, 2) / (eps0 * mu0);
+
+  const bool split = (global.eigen_calc == lapack);
+
+  for (int i=0; i<n; i++)
+  {
+    Complex beta = sqrt(C*kt_eps_mu - kt2[i]);
+
+    if (real(beta) < 0)
+      beta = -beta;
+  
+    if (abs(imag(beta)) < 1e-12)
+      if (imag(beta) > 0)
+        beta = -beta;
+
+    global.slab_ky = beta;
+
+    result[i] = split ? calc_split() : calc_global();
+  }
+
+  global.N = old_N;
+  global.slab_ky = old_beta;
+  global.orthogonal = old_orthogonal;
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Index mapping into dense (ku=-1) or band (ku=upper diagonals) storage.
@@ -33,6 +33,7 @@ class SectionDisp : public ComplexFunction
                 bool symmetric = false);
 
     Complex operator()(const Complex& kt2);
+    void evaluate(const Complex* kt2, Complex* result, int n);
 
     std::vector<Complex> get_params() const;
     void set_params(const std::vector<Complex>&);
@@ -10,9 +10,12 @@
 //
 /////////////////////////////////////////////////////////////////////////////
 
+#include <sstream>
+#include <typeinfo>
 #include "generalslab.h"
 #include "slabmatrixcache.h"
 #include "isoslab/slabwall.h"
+#include "../../diskcache.h"
 #include "../../math/calculus/quadrature/patterson_quad.h"
 
 using std::vector;
@@ -25,7 +28,7 @@ using std::vector;
 //
 /////////////////////////////////////////////////////////////////////////////
 
-SlabGlobal global_slab = {0.0, 0.0, NULL, NULL, 1.0, 1.2, false};
+thread_local SlabGlobal global_slab = {0.0, 0.0, NULL, NULL, 1.0, 1.2, false};
 
 
 
@@ -97,6 +100,47 @@ Complex SlabImpl::R_upper() const
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// SlabImpl::disk_key()
+//
+//   Only walls with a fixed reflection coefficient can be described.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+std::string SlabImpl::disk_key() const
+{
+  SlabWall* l_wall = lowerwall ? lowerwall : global_slab.lowerwall;
+  SlabWall* u_wall = upperwall ? upperwall : global_slab.upperwall;
+
+  if (    (l_wall && !dynamic_cast<SlabWallMixed*>(l_wall))
+       || (u_wall && !dynamic_cast<SlabWallMixed*>(u_wall)) )
+    return "";
+
+  std::ostringstream s;
+
+  s << typeid(*this).name() << " " << solver_key()
+    << " walls=" << key_number(R_lower()) << ";" << key_number(R_upper())
+    << " PML=" << key_number(global_slab.lower_PML)
+    << ";"     << key_number(global_slab.upper_PML)
+    << " ASR=" << key_number(global_slab.eta_ASR)
+    << " cutoff=" << key_number(global_slab.estimate_cutoff)
+    << " low_index_core=" << global_slab.low_index_core;
+
+  s << " params=";
+  vector<Complex> params = get_params();
+  for (unsigned int i=0; i<params.size(); i++)
+    s << key_number(params[i]) << ";";
+
+  s << " estimates=";
+  for (unsigned int i=0; i<user_kz2_estimates.size(); i++)
+    s << key_number(user_kz2_estimates[i]) << ";";
+
+  return s.str();
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // SlabImpl::S_flux()
@@ -215,29 +259,16 @@ void SlabImpl::calc_overlap_matrices
   
   if (global.polarisation != TE_TM)
   {
-    for (int i=1; i<=int(N); i++)
-      for (int j=1; j<=int(N); j++)
-      {        
-        (*O_I_II)(i,j) = overlap
-          (dynamic_cast<const SlabMode*>(medium_I ->get_mode(i)),
-           dynamic_cast<const SlabMode*>(medium_II->get_mode(j)),
-           &cache, &disc, i, j, 1, 2, mirrored);
-      
-        (*O_II_I)(i,j) = overlap
-          (dynamic_cast<const SlabMode*>(medium_II->get_mode(i)),
-           dynamic_cast<const SlabMode*>(medium_I ->get_mode(j)),
-           &cache, &disc, i, j, 2, 1, mirrored);
-
-        if (O_I_I) (*O_I_I)(i,j) = overlap
-          (dynamic_cast<const SlabMode*>(medium_I ->get_mode(i)),
-           dynamic_cast<const SlabMode*>(medium_I ->get_mode(j)),
-           &cache, &disc, i, j, 1, 1, mirrored);
-
-        if (O_II_II) (*O_II_II)(i,j) = overlap
-          (dynamic_cast<const SlabMode*>(medium_II->get_mode(i)),
-           dynamic_cast<const SlabMode*>(medium_II->get_mode(j)),
-           &cache, &disc, i, j, 2, 2, mirrored);
-      }
+    const int threads = global.threads;
+
+    overlap_matrix(medium_I,  medium_II, cache, disc, 1, 2, O_I_II, threads);
+    overlap_matrix(medium_II, medium_I,  cache, disc, 2, 1, O_II_I, threads);
+
+    if (O_I_I)
+      overlap_matrix(medium_I,  medium_I,  cache, disc, 1, 1, O_I_I, threads);
+
+    if (O_II_II)
+      overlap_matrix(medium_II, medium_II, cache, disc, 2, 2, O_II_II,threads);
 
     return;
   }
@@ -37,7 +37,7 @@ struct SlabGlobal
     bool      low_index_core;
 };
 
-extern SlabGlobal global_slab;
+extern thread_local SlabGlobal global_slab;
 
 
 
@@ -81,6 +81,8 @@ class SlabImpl : public MultiWaveguide
     virtual std::vector<Complex> get_params() const = 0;
     virtual void set_params(const std::vector<Complex>&) = 0;
 
+    std::string disk_key() const;
+
     cVector expand_field(ComplexFunction* f, Real eps);
 
     std::vector<Complex> disc_intersect(const SlabImpl* medium_II) const;
@@ -208,6 +210,8 @@ class Slab : public MultiWaveguide
     
     std::string repr() const {return s->repr();}
 
+    std::string disk_key() const {return s->disk_key();}
+
     void set_dummy(bool b) {s->set_dummy(b);}
     bool is_dummy() const {return s->is_dummy();}
 
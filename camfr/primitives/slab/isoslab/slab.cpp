@@ -18,6 +18,8 @@
 #include "slabmode.h"
 #include "slaboverlap.h"
 #include "../slabmatrixcache.h"
+#include "../../../diskcache.h"
+#include "../../../context.h"
 #include "../../planar/planar.h"
 #include "../../../math/calculus/calculus.h"
 #include "../../../math/calculus/fourier/fourier.h"
@@ -274,6 +276,26 @@ void Slab_M::find_modes()
   if (!recalc_needed())
     return;
 
+  // Propagation constants in disk cache?
+
+  const std::string key = disk_cache.is_open() ? disk_key() : "";
+  const int old_N = global.N;
+  
+  vector<Complex> cached_kt;
+  if (!key.empty() && disk_cache.load(key, &cached_kt))
+  {
+    // Update dispersion relation parameters for later sweeps.
+
+    SlabWall* l_wall = lowerwall ? lowerwall : global_slab.lowerwall;
+    SlabWall* u_wall = upperwall ? upperwall : global_slab.upperwall;
+
+    SlabDisp disp(materials, thicknesses, global.lambda, l_wall, u_wall);
+    params = disp.get_params();
+
+    build_modeset(cached_kt);
+    return;
+  }
+
   // Only TE or TM modes needed.
 
   if ((global.polarisation == TE) || (global.polarisation == TM))
@@ -282,7 +304,11 @@ void Slab_M::find_modes()
     for (unsigned int i=0; i<modeset.size(); i++)
       old_kt.push_back(dynamic_cast<Slab_M_Mode*>(modeset[i])->get_kt());
 
-    vector<Complex> kt(find_kt(old_kt));
+    vector<Complex> kt(find_kt(old_kt, params));
+
+    if (!key.empty())
+      disk_cache.save(key, kt);
+    
     build_modeset(kt);
   }
 
@@ -290,69 +316,111 @@ void Slab_M::find_modes()
 
   if (global.polarisation == TE_TM)
   {
-    // Cheat on global variables.
-
     const int n = int(global.N/2);
     if (2*n != global.N)
       py_print("Warning: changing N to even number.");
-    global.N = n;
-
-    const Complex old_beta = global.slab_ky;
-    global.slab_ky = 0.0;
-
-    vector<Complex> old_params = params;
-
-    // Find TE modes.
-
-    global.polarisation = TE;
 
-    vector<Complex> old_kt_TE;
+    vector<Complex> old_kt_TE, old_kt_TM;
     if (    modeset.size()
          && (modeset.front()->pol == TE)
          && (modeset.back() ->pol == TM) )
+    {
       for (unsigned int i=0; i<n; i++)
         old_kt_TE.push_back(dynamic_cast<Slab_M_Mode*>(modeset[i])->get_kt());
+      for (unsigned int i=n; i<2*n; i++)
+        old_kt_TM.push_back(dynamic_cast<Slab_M_Mode*>(modeset[i])->get_kt());
+    }
 
-    vector<Complex> kt(find_kt(old_kt_TE));
-    kt.erase(kt.begin()+n, kt.end());
+    // The TE and TM searches are independent, so give each one its own
+    // settings and dispersion relation parameters, and run them
+    // concurrently if possible.
 
-    // Find TM modes
+    ThreadContext context_TE = get_thread_context();
+    context_TE.global.N = n;
+    context_TE.global.slab_ky = 0.0;
+    context_TE.global.polarisation = TE;
+
+    ThreadContext context_TM = context_TE;
+    context_TM.global.polarisation = TM;
 
-    params = old_params;
+    vector<Complex> params_TE = params;
+    vector<Complex> params_TM = params;
 
     last_lambda = 0.0; // Force a recalc.
 
-    global.polarisation = TM;
+    vector<Complex> kt, kt_TM;
 
-    vector<Complex> old_kt_TM;
-    if (    modeset.size()
-         && (modeset.front()->pol == TE)
-         && (modeset.back() ->pol == TM) )
-      for (unsigned int i=n; i<2*n; i++)
-        old_kt_TM.push_back(dynamic_cast<Slab_M_Mode*>(modeset[i])->get_kt());
+    const int threads 
+      = ( (global.threads > 1) && concurrent_TE_TM_possible() ) ? 2 : 1;
 
-    vector<Complex> kt_TM(find_kt(old_kt_TM));
+    #pragma omp parallel sections num_threads(threads)
+    {
+      #pragma omp section
+      {
+        ContextSwitch context_switch(context_TE);
+        kt = find_kt(old_kt_TE, params_TE);
+      }
 
-    // Restore global variables and build modeset.
+      #pragma omp section
+      {
+        ContextSwitch context_switch(context_TM);
+        kt_TM = find_kt(old_kt_TM, params_TM);
+      }
+    }
+
+    kt.erase(kt.begin()+n, kt.end());
+
+    // Build modeset.
 
     global.N = 2*n;
-    global.slab_ky = old_beta;
-    global.polarisation = TE_TM;
+    params = params_TM;
 
     kt.insert(kt.end(), kt_TM.begin(), kt_TM.end());
+
+    if (!key.empty() && (global.N == old_N))
+      disk_cache.save(key, kt);
+    
     build_modeset(kt);
   }
 }
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Slab_M::concurrent_TE_TM_possible
+//
+//   The series and ASR solvers build auxiliary reference slabs, and
+//   SlabWall_PC walls contain a stack that is recalculated for each kt,
+//   so these rule out concurrent TE and TM searches.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool Slab_M::concurrent_TE_TM_possible() const
+{
+  if (    (global.solver == series)
+       || (global.solver == ASR)
+       || (global.solver == stretched_ASR) )
+    return false;
+
+  SlabWall* l_wall = lowerwall ? lowerwall : global_slab.lowerwall;
+  SlabWall* u_wall = upperwall ? upperwall : global_slab.upperwall;
+
+  SlabDisp disp(materials, thicknesses, global.lambda, l_wall, u_wall);
+
+  return disp.thread_safe();
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Slab_M::find_kt
 //
 /////////////////////////////////////////////////////////////////////////////
 
-vector<Complex> Slab_M::find_kt(vector<Complex>& old_kt)
+vector<Complex> Slab_M::find_kt(vector<Complex>& old_kt,
+                                vector<Complex>& params)
 {
   // If we already calculated modes for a different wavelength/gain
   // combination, use these as an initial estimate, else find them
@@ -366,15 +434,58 @@ vector<Complex> Slab_M::find_kt(vector<Complex>& old_kt)
 
   if (     (global.solver == ASR            && global.polarisation == TE)
         || (global.solver == stretched_ASR  && global.polarisation == TE) )
-      return find_kt_from_scratch_by_track();
+      return find_kt_from_scratch_by_track(params);
 
   if (global.sweep_from_previous && (modeset.size() >= global.N))
-      return find_kt_by_sweep(old_kt);
+      return find_kt_by_sweep(old_kt, params);
 
   if (global.solver == ADR)
     return find_kt_from_scratch_by_ADR();
 
-  return find_kt_from_scratch_by_track();
+  return find_kt_from_scratch_by_track(params);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// find_roots_ADR
+//
+//   Returns at least N roots of disp, or all the roots in the contour for
+//   N=0. If global.threads > 1, the contour integration is spread over a
+//   team of threads which share the settings of the calling thread.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+vector<Complex> find_roots_ADR(SlabDisp& disp, unsigned int N,
+                               const Complex& lowerleft,
+                               const Complex& upperright,
+                               ExpandDirection dir=ur)
+{
+  const int threads = disp.thread_safe() ? int(global.threads) : 1;
+
+  if (threads <= 1)
+    return N ? N_roots(disp, N, lowerleft, upperright, 1e-4, 1e-4, 4, dir)
+             : allroots(disp, lowerleft, upperright);
+
+  vector<Complex> roots;
+
+  const ThreadContext context = get_thread_context();
+
+  // The calling thread generates the tasks, the others pick them up
+  // at the barrier at the end of the region.
+
+  #pragma omp parallel num_threads(threads)
+  {
+    ContextSwitch context_switch(context);
+
+    #pragma omp master
+    roots = N ? N_roots(disp, N, lowerleft, upperright, 1e-4, 1e-4, 4, dir,
+                        true)
+              : allroots(disp, lowerleft, upperright, 1e-4, 1e-4, 4, true);
+  }
+
+  return roots;
 }
 
 
@@ -437,8 +548,7 @@ vector<Complex> Slab_M::find_kt_from_scratch_by_ADR()
 
   SlabDisp disp(materials,thicknesses,global.lambda,l_wall,u_wall);
   unsigned int zeros = global.N + 2 + materials.size();
-  vector<Complex> kt = N_roots(disp, zeros, lowerleft, upperright,
-                               1e-4, 1e-4, 4, dir);
+  vector<Complex> kt = find_roots_ADR(disp, zeros, lowerleft, upperright, dir);
 
   //cout << "Calls to slab dispersion relation : "<<disp.times_called()<<endl;
 
@@ -475,7 +585,8 @@ vector<Complex> Slab_M::find_kt_from_scratch_by_ADR()
 //
 /////////////////////////////////////////////////////////////////////////////
 
-vector<Complex> Slab_M::find_kt_from_scratch_by_track()
+vector<Complex> Slab_M::find_kt_from_scratch_by_track
+  (vector<Complex>& params)
 {
   // Set constants.
 
@@ -757,7 +868,8 @@ vector<Complex> Slab_M::find_kt_from_scratch_by_track()
 
     const int sections = int(global.C_steps);
 
-    vector<Complex> kt_complex = allroots(disp, lowerleft, upperright);
+    vector<Complex> kt_complex
+      = find_roots_ADR(disp, 0, lowerleft, upperright);
 
     disp.set_params(params);
 
@@ -808,7 +920,8 @@ vector<Complex> Slab_M::find_kt_from_scratch_by_track()
 //
 /////////////////////////////////////////////////////////////////////////////
 
-vector<Complex> Slab_M::find_kt_by_sweep(vector<Complex>& old_kt)
+vector<Complex> Slab_M::find_kt_by_sweep(vector<Complex>& old_kt,
+                                         vector<Complex>& params)
 {
   // Set constants.
 
@@ -1721,6 +1834,7 @@ void Slab_M::build_modeset(vector<Complex>& kt)
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
 }
 
 
@@ -1747,6 +1861,27 @@ vector<Complex> Slab_M::get_params() const
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Slab_M::disk_key
+//
+/////////////////////////////////////////////////////////////////////////////
+
+std::string Slab_M::disk_key() const
+{
+  std::string key = SlabImpl::disk_key();
+
+  if (key.empty())
+    return key;
+
+  std::ostringstream s;
+  s << key << " M_series=" << M_series;
+
+  return s.str();
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Slab_M::set_params
@@ -1902,7 +2037,7 @@ vector<Complex> UniformSlab::find_kt()
       tmp.set_upper_wall(*u_wall);
 
     vector<Complex> old_kt; // Sweep not implemented for this case.
-    return tmp.find_kt(old_kt);
+    return tmp.find_kt(old_kt, tmp.params);
   }
 
   // Use analytical solution if available.
@@ -1976,6 +2111,7 @@ void UniformSlab::build_modeset(vector<Complex>& kt)
   last_lambda = global.lambda;
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
+  last_materials_version = materials_version(get_materials());
 }
 
 
@@ -68,14 +68,23 @@ class Slab_M : public SlabImpl
     std::vector<Complex> get_params() const;
     void set_params(const std::vector<Complex>&);
 
+    std::string disk_key() const;
+
     bool is_mirror_image_of(const SlabImpl* medium_II) const;
 
   protected:
 
-    std::vector<Complex> find_kt(std::vector<Complex>& old_kt);
+    // These update 'params' rather than the member of the same name,
+    // such that the TE and TM modes can be found concurrently.
+
+    std::vector<Complex> find_kt(std::vector<Complex>& old_kt,
+                                 std::vector<Complex>& params);
     std::vector<Complex> find_kt_from_scratch_by_ADR();
-    std::vector<Complex> find_kt_from_scratch_by_track();
-    std::vector<Complex> find_kt_by_sweep(std::vector<Complex>& old_kt);
+    std::vector<Complex> find_kt_from_scratch_by_track
+      (std::vector<Complex>& params);
+    std::vector<Complex> find_kt_by_sweep(std::vector<Complex>& old_kt,
+                                          std::vector<Complex>& params);
+    bool concurrent_TE_TM_possible() const;
     std::vector<Complex> find_kt_from_estimates();
 
     std::vector<Complex> estimate_kz2_from_RCWA();
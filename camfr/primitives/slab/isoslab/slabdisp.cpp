@@ -245,6 +245,138 @@ Complex SlabDisp::operator()(const Complex& kt)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// SlabDisp::evaluate
+//
+//   Batched version of operator(). The layers are traversed once for all
+//   kt values, with the fields of all points stored in separate arrays.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void SlabDisp::evaluate(const Complex* kt, Complex* result, int n)
+{
+  // Walls can depend on Planar::kt, so these need to be handled
+  // point by point.
+
+  SlabWall* l_wall = lowerwall ? lowerwall : global_slab.lowerwall;
+  SlabWall* u_wall = upperwall ? upperwall : global_slab.upperwall;
+
+  if (l_wall || u_wall)
+  {
+    ComplexFunction::evaluate(kt, result, n);
+    return;
+  }
+
+  if (n <= 0)
+    return;
+
+  counter += n;
+
+  global.lambda = lambda;
+
+  const Complex C = pow(2*pi/lambda, 2) / (eps0 * mu0);
+
+  const bool TE_pol = (global.polarisation == TE);
+  const Real sign   = TE_pol ? 1 : -1;
+
+  const bool analytic =    (global.solver == ADR)
+                        || (global.solver == series)
+                        || (global.solver == ASR)
+                        || (global.solver == stretched_ASR);
+
+  // Set seed field for electric walls.
+
+  vector<Complex> kt2(n), kx(n), kx_prev(n);
+  vector<Complex> fw(n, 1.0), bw(n, -1.0);
+
+  for (int i=0; i<n; i++)
+    kt2[i] = kt[i]*kt[i];
+
+  // Loop through chunks.
+
+  for (unsigned int k=0; k<eps.size(); k++)
+  {
+    unsigned int i1 = (k==0) ? 0 : k-1; // Index incidence medium.
+    unsigned int i2 = k;                // Index exit medium.
+
+    const Complex C_k = C*(eps[k]*mu[k] - kt_eps_mu);
+
+    const Complex ratio = TE_pol ? mu[i2] / mu[i1] : eps[i2] / eps[i1];
+
+    const Complex I_d = I * thicknesses[k];
+
+    for (int i=0; i<n; i++)
+      kx[i] = sqrt_45(C_k + kt2[i]);
+
+    if (k == 0)
+      kx_prev = kx;
+
+    for (int i=0; i<n; i++)
+    {
+      const Complex a = kx_prev[i] / kx[i] * ratio;
+
+      // Cross the interface.
+
+      const Complex fw_end =        (1.0+a)*0.5 * fw[i] +
+                             sign * (1.0-a)*0.5 * bw[i];
+
+      const Complex bw_end = sign * (1.0-a)*0.5 * fw[i] +
+                                    (1.0+a)*0.5 * bw[i];
+
+      // Propagate in medium.
+
+      const Complex I_kx_d = I_d * kx[i];
+
+      if (analytic)
+      {
+        fw[i] = fw_end * exp(-I_kx_d);
+        bw[i] = bw_end * exp(+I_kx_d);
+      }
+      else if (real(I_kx_d) > 0)
+      {
+        fw[i] = fw_end * exp(-2.0*I_kx_d);
+        bw[i] = bw_end;
+      }
+      else
+      {
+        fw[i] = fw_end;
+        bw[i] = bw_end * exp(+2.0*I_kx_d);
+      }
+    }
+
+    kx_prev.swap(kx);
+  }
+
+  for (int i=0; i<n; i++)
+    result[i] = fw[i] + bw[i];
+
+  // Leave Planar::kt in the same state as the scalar version.
+
+  Planar::set_kt(sqrt_45(C*kt_eps_mu - kt2[n-1]));
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SlabDisp::thread_safe
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool SlabDisp::thread_safe() const
+{
+  SlabWall* l_wall = lowerwall ? lowerwall : global_slab.lowerwall;
+  SlabWall* u_wall = upperwall ? upperwall : global_slab.upperwall;
+
+  // SlabWall_PC contains a stack that is recalculated for each kt.
+
+  return    !dynamic_cast<SlabWall_PC*>(l_wall)
+         && !dynamic_cast<SlabWall_PC*>(u_wall);
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // SlabDisp::get_params
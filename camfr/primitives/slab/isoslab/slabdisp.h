@@ -41,9 +41,15 @@ class SlabDisp : public Function1D<Complex>
     ~SlabDisp() {}
     
     Complex operator()(const Complex& kt);
+    void evaluate(const Complex* kt, Complex* result, int n);
 
     Complex get_kt_eps_mu() const {return kt_eps_mu;}
 
+    // True if the function can be evaluated from several threads at once,
+    // i.e. if the walls don't have internal state.
+
+    bool thread_safe() const;
+
     std::vector<Complex> get_params() const;
     
     void set_params(const std::vector<Complex>& params);
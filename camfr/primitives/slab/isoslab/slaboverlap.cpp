@@ -221,6 +221,202 @@ Complex overlap(const SlabMode* mode_I,
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// ModeTable
+//
+//   Mode data of one medium, taken from a SlabCache and tabulated
+//   layer-major: the entry for layer k and mode i is stored at k*N+i-1.
+//   This way, the overlap kernel below runs over contiguous arrays and
+//   needs no virtual calls or global settings.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+struct ModeTable
+{
+    ModeTable(const SlabImpl* medium, const SlabCache& cache, int index,
+              const vector<Complex>& disc);
+
+    int N, K;
+
+    vector<Polarisation> pol;
+    vector<Complex> kz0;
+
+    vector<Complex> kx, fw_l, bw_l, fw_u, bw_u;
+
+    vector<Complex> inv_eps, inv_mu; // Per layer.
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// ModeTable::ModeTable
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+ModeTable::ModeTable(const SlabImpl* medium, const SlabCache& cache,
+                     int index, const vector<Complex>& disc)
+  : N(cache.fw_l.extent(blitz::secondDim)), K(disc.size()-1),
+    pol(N), kz0(N), kx(N*K), fw_l(N*K), bw_l(N*K), fw_u(N*K), bw_u(N*K),
+    inv_eps(K), inv_mu(K)
+{
+  for (int k=0; k<K; k++)
+  {
+    const Coord lower(disc[k], 0, 0, Plus);
+
+    inv_eps[k] = 1.0 / medium->eps_at(lower);
+    inv_mu [k] = 1.0 / medium->mu_at (lower);
+  }
+  
+  for (int i=1; i<=N; i++)
+  {
+    const SlabMode* mode = dynamic_cast<const SlabMode*>(medium->get_mode(i));
+
+    pol[i-1] = mode->pol;
+    kz0[i-1] = mode->get_kz0();
+
+    for (int k=0; k<K; k++)
+    {
+      const int n = k*N + i-1;
+
+      kx[n] = mode->kx_at(Coord(disc[k], 0, 0, Plus));
+
+      fw_l[n] = cache.fw_l(index,i,k+1);
+      bw_l[n] = cache.bw_l(index,i,k+1);
+      fw_u[n] = cache.fw_u(index,i,k+1);
+      bw_u[n] = cache.bw_u(index,i,k+1);
+    }
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// overlap_matrix
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void overlap_matrix(const SlabImpl* medium_I, const SlabImpl* medium_II,
+                    const SlabCache& cache, const vector<Complex>& disc,
+                    int I_index, int II_index, cMatrix* O, int threads)
+{
+  // Check arguments.
+
+  if ( (I_index < 1) || (I_index > 2) )
+  {
+    py_error("Error: I_index should be 1 or 2.");
+    exit (-1);
+  }
+  if ( (II_index < 1) || (II_index > 2) )
+  {
+    py_error("Error: II_index should be 1 or 2.");
+    exit (-1);
+  }
+
+  // Set variables.
+
+  const Real eps = 1e-6; // Same as in overlap().
+
+  const Complex omega = 2*pi/global.lambda * c;
+
+  // Widths equal?
+  
+  if (abs(medium_I->get_width() - medium_II->get_width()) > eps)
+  {
+    std::ostringstream s;
+    s << "Warning: complex widths don't match: "
+      << medium_I ->get_width() << " and " << medium_II->get_width();
+    py_error(s.str());
+    *O = 0.0;
+    return;
+  }
+
+  // Tabulate mode data.
+
+  const ModeTable a(medium_I,  cache, I_index,  disc);
+  const ModeTable b(medium_II, cache, II_index, disc);
+
+  const int N = a.N;
+  const int K = a.K;
+
+  vector<Complex> d(K);
+  for (int k=0; k<K; k++)
+    d[k] = disc[k+1] - disc[k];
+
+  // Calculate the matrix, with each thread taking a block of rows.
+  // For each row, all columns are updated together one layer at a time.
+
+  #pragma omp parallel num_threads((threads < 1) ? 1 : threads)
+  {
+    vector<Complex> term1(N), term2(N);
+
+    #pragma omp for schedule(static)
+    for (int i=0; i<N; i++)
+    {
+      for (int j=0; j<N; j++)
+        term1[j] = term2[j] = 0.0;
+
+      for (int k=0; k<K; k++)
+      {
+        const int n = k*N + i;
+
+        const Complex kx_I   = a.kx  [n];
+        const Complex fw_I_l = a.fw_l[n];
+        const Complex bw_I_l = a.bw_l[n];
+        const Complex fw_I_u = a.fw_u[n];
+        const Complex bw_I_u = a.bw_u[n];
+
+        const Complex* kx_II   = &b.kx  [k*N];
+        const Complex* fw_II_l = &b.fw_l[k*N];
+        const Complex* bw_II_l = &b.bw_l[k*N];
+        const Complex* fw_II_u = &b.fw_u[k*N];
+        const Complex* bw_II_u = &b.bw_u[k*N];
+
+        const Complex C = (a.pol[i] == TE) ? b.inv_mu[k] : a.inv_eps[k];
+
+        for (int j=0; j<N; j++)
+        {
+          // term 1 : Int(fw_I.fw_II + bw_I.bw_II)
+
+          const Complex sum = kx_I + kx_II[j];
+
+          if (abs(sum) > eps) // normal case
+            term1[j] += C*I / sum
+              * (  fw_I_u * fw_II_u[j] - bw_I_u * bw_II_u[j]
+                 - fw_I_l * fw_II_l[j] + bw_I_l * bw_II_l[j] );
+          else // normalisation integral (same modes) or degenerate case
+            term1[j] += C * d[k] * ( fw_I_l*fw_II_l[j] + bw_I_l*bw_II_l[j] );
+
+          // term 2 : Int(fw_I.bw_II + bw_I.fw_II)
+
+          const Complex diff = kx_I - kx_II[j];
+
+          if (abs(diff) > eps) // normal case
+            term2[j] += C*I / diff
+              * (  fw_I_u * bw_II_u[j] - bw_I_u * fw_II_u[j]
+                 - fw_I_l * bw_II_l[j] + bw_I_l * fw_II_l[j] );
+          else // normalisation integral (same modes) or degenerate case
+            term2[j] += C * d[k] * ( fw_I_l*bw_II_l[j] + bw_I_l*fw_II_l[j] );
+        }
+      }
+
+      for (int j=0; j<N; j++)
+      {
+        if (a.pol[i] != b.pol[j]) // TE and TM are orthogonal.
+          (*O)(i+1,j+1) = 0.0;
+        else
+          (*O)(i+1,j+1) = (a.pol[i] == TE)
+            ? b.kz0[j] / omega * (term1[j] + term2[j])
+            : a.kz0[i] / omega * (term1[j] - term2[j]);
+      }
+    }
+  }
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // overlap_TM_TE
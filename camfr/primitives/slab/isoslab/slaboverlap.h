@@ -60,6 +60,27 @@ Complex overlap(const SlabMode* mode_I,
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// overlap_matrix
+//
+//   Calculates the matrix O(i,j) = overlap(mode i of medium_I, 
+//   mode j of medium_II) in one go, using the fields in part I_index
+//   (II_index) of the cache for medium_I (medium_II).
+//
+//   Rather than doing N^2 calls to overlap(), the mode data is tabulated
+//   once per layer and the closed form layer integrals are evaluated
+//   for a whole row of the matrix at a time. The rows are divided over
+//   'threads' threads.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void overlap_matrix(const SlabImpl* medium_I, const SlabImpl* medium_II,
+                    const SlabCache& cache, const std::vector<Complex>& disc,
+                    int I_index, int II_index, cMatrix* O, int threads=1);
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // overlap_TM_TE
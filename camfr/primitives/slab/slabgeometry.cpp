@@ -0,0 +1,499 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     slabgeometry.cpp
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include "slabgeometry.h"
+
+using std::vector;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SharedSlabs
+//
+/////////////////////////////////////////////////////////////////////////////
+
+SharedSlabs shared_slabs;
+
+// Layer thicknesses are rounded to this resolution (um) in the key.
+
+const Real shared_slabs_resolution = 1e-9;
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CircleShape::intersection_at_x
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool CircleShape::intersection_at_x(Real x, Real* y0, Real* y1) const
+{
+  const Real D = r*r - (x-cx)*(x-cx);
+
+  if (D <= 0)
+    return false;
+
+  *y0 = cy - sqrt(D);
+  *y1 = cy + sqrt(D);
+
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// RectangleShape::RectangleShape
+//
+/////////////////////////////////////////////////////////////////////////////
+
+RectangleShape::RectangleShape(Real x0_, Real y0_, Real x1_, Real y1_,
+                               Material& m)
+  : Shape(m), x0(std::min(x0_, x1_)), y0(std::min(y0_, y1_)),
+              x1(std::max(x0_, x1_)), y1(std::max(y0_, y1_)) {}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// RectangleShape::intersection_at_x
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool RectangleShape::intersection_at_x(Real x, Real* y0_, Real* y1_) const
+{
+  if ( (x < x0) || (x > x1) )
+    return false;
+
+  *y0_ = y0;
+  *y1_ = y1;
+
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// PolygonShape::PolygonShape
+//
+/////////////////////////////////////////////////////////////////////////////
+
+PolygonShape::PolygonShape(const vector<Real>& x, const vector<Real>& y,
+                           Material& m)
+  : Shape(m), px(x), py(y)
+{
+  if ( (px.size() != py.size()) || (px.size() < 3) )
+  {
+    py_error("Error: polygon needs at least three (x,y) vertices.");
+    exit (-1);
+  }
+
+  x_min = *std::min_element(px.begin(), px.end());
+  x_max = *std::max_element(px.begin(), px.end());
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// PolygonShape::intersection_at_x
+//
+//   Since the polygon is convex, the intersection is the range spanned by
+//   all the edges crossing x.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool PolygonShape::intersection_at_x(Real x, Real* y0, Real* y1) const
+{
+  if ( (x < x_min) || (x > x_max) )
+    return false;
+
+  bool found = false;
+
+  for (unsigned int i=0; i<px.size(); i++)
+  {
+    const unsigned int j = (i+1 == px.size()) ? 0 : i+1;
+
+    if (   (x < std::min(px[i], px[j]))
+        || (x > std::max(px[i], px[j])) )
+      continue;
+
+    Real ya, yb;
+
+    if (px[i] == px[j]) // Vertical edge.
+    {
+      ya = std::min(py[i], py[j]);
+      yb = std::max(py[i], py[j]);
+    }
+    else
+      ya = yb = py[i] + (py[j]-py[i]) / (px[j]-px[i]) * (x-px[i]);
+
+    if (!found || (ya < *y0))
+      *y0 = ya;
+
+    if (!found || (yb > *y1))
+      *y1 = yb;
+
+    found = true;
+  }
+
+  return found;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SlabGeometry::~SlabGeometry
+//
+/////////////////////////////////////////////////////////////////////////////
+
+SlabGeometry::~SlabGeometry()
+{
+  for (unsigned int i=0; i<shapes.size(); i++)
+    delete shapes[i];
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SlabGeometry::add_*
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void SlabGeometry::add_circle(Real cx, Real cy, Real r, Material& m)
+{
+  shapes.push_back(new CircleShape(cx, cy, r, m));
+}
+
+void SlabGeometry::add_rectangle(Real x0, Real y0, Real x1, Real y1,
+                                 Material& m)
+{
+  shapes.push_back(new RectangleShape(x0, y0, x1, y1, m));
+}
+
+void SlabGeometry::add_triangle(Real x0, Real y0, Real x1, Real y1,
+                                Real x2, Real y2, Material& m)
+{
+  vector<Real> x, y;
+
+  x.push_back(x0); x.push_back(x1); x.push_back(x2);
+  y.push_back(y0); y.push_back(y1); y.push_back(y2);
+
+  shapes.push_back(new PolygonShape(x, y, m));
+}
+
+void SlabGeometry::add_polygon(const vector<Real>& x, const vector<Real>& y,
+                               Material& m)
+{
+  shapes.push_back(new PolygonShape(x, y, m));
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SlabGeometry::slice_at
+//
+//   Vertical slice through the geometry at x, consolidated in y.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline bool same_y(Real y0, Real y1) {return abs(y0-y1) < 1e-6;}
+
+Slice SlabGeometry::slice_at(Real x, Real y0, Real y1, Real dy) const
+{
+  Slice slice(1, SliceLayer(y0, y1, background));
+
+  for (unsigned int i=0; i<shapes.size(); i++)
+  {
+    Real ys0, ys1;
+
+    if (!shapes[i]->intersection_at_x(x, &ys0, &ys1))
+      continue;
+
+    if (ys0 < y0)
+      ys0 = y0;
+    if (ys1 > y1)
+      ys1 = y1;
+
+    if (abs(ys0-ys1) < .001*dy)
+      continue;
+
+    Slice new_slice;
+
+    for (unsigned int j=0; j<slice.size(); j++)
+    {
+      if (    (slice[j].y1 < ys0) || same_y(slice[j].y1, ys0)
+           || (slice[j].y0 > ys1) || same_y(slice[j].y0, ys1) )
+      {
+        new_slice.push_back(slice[j]); // No intersection.
+        continue;
+      }
+
+      if (!same_y(slice[j].y0, ys0)) // Old material pre.
+        new_slice.push_back(SliceLayer(slice[j].y0, ys0, slice[j].mat));
+
+      new_slice.push_back(SliceLayer(ys0, ys1, shapes[i]->get_mat()));
+
+      while ( (slice[j].y1 < ys1) && (j+1 < slice.size()) )
+        j++;
+
+      if (!same_y(slice[j].y1, ys1)) // Old material post.
+        new_slice.push_back(SliceLayer(ys1, slice[j].y1, slice[j].mat));
+    }
+
+    slice.swap(new_slice);
+  }
+
+  // Consolidate in y-direction.
+
+  Slice new_slice;
+
+  for (unsigned int i=0; i<slice.size(); i++)
+  {
+    if (new_slice.size() && (new_slice.back().mat == slice[i].mat))
+      new_slice.back().y1 = slice[i].y1;
+    else
+      new_slice.push_back(slice[i]);
+  }
+
+  return new_slice;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// similar_slices
+//
+//  Determines if two slices are similar, i.e. the interface positions they
+//  contain are no more then 'dy' apart.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool similar_slices(const Slice& s1, const Slice& s2, Real dy)
+{
+  if (s1.size() != s2.size())
+    return false;
+
+  for (unsigned int i=0; i<s1.size(); i++)
+    if (s1[i].mat != s2[i].mat)
+      return false;
+
+  if (abs(dy) < 1e-12)
+    dy = 1e-12;
+
+  for (unsigned int i=0; i<s1.size(); i++)
+    if (   (abs(s1[i].y0 - s2[i].y0) >= dy)
+        || (abs(s1[i].y1 - s2[i].y1) >= dy) )
+      return false;
+
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// same_direction
+//
+//  Checks if the interfaces move in the same direction from a0 to a1 as
+//  from b0 to b1. Assumes all slices are similar.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool same_direction(const Slice& a0, const Slice& a1,
+                    const Slice& b0, const Slice& b1)
+{
+  for (unsigned int i=0; i<a0.size(); i++)
+    if (   ((a0[i].y0 < a1[i].y0) != (b0[i].y0 < b1[i].y0))
+        || ((a0[i].y1 < a1[i].y1) != (b0[i].y1 < b1[i].y1)) )
+      return false;
+
+  return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SlabGeometry::to_expression
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Expression SlabGeometry::to_expression(Real x0, Real x1, Real dx,
+                                       Real y0, Real y1, Real dy,
+                                       bool add_flipped)
+{
+  if ( (x0 > x1) || (y0 > y1) || (dx <= 0) )
+  {
+    py_error("Error: invalid boundaries for to_expression.");
+    exit (-1);
+  }
+
+  // Sample the geometry.
+
+  vector<Slice> slices;
+
+  for (Real x=x0+dx/2.0; x<x1; x+=dx)
+    slices.push_back(slice_at(x, y0, y1, dy));
+
+  if (slices.size() == 0)
+    slices.push_back(slice_at((x0+x1)/2.0, y0, y1, dy));
+
+  // Consolidate in x-direction.
+
+  vector<Slice> new_slices;
+  vector<Real> d;
+  Real d_sum = 0.0;
+
+  unsigned int i = 0;
+  while (i < slices.size())
+  {
+    unsigned int i_end = i+1;
+
+    while (    (i_end < slices.size())
+            && similar_slices(slices[i_end], slices[i], dy)
+            && same_direction(slices[i],       slices[i+1],
+                              slices[i_end-1], slices[i_end]) )
+      i_end++;
+
+    Slice s(slices[i]);
+
+    if (i_end > i+1) // Average.
+      for (unsigned int k=0; k<s.size(); k++)
+      {
+        Real s0 = 0.0, s1 = 0.0;
+
+        for (unsigned int n=i; n<i_end; n++)
+        {
+          s0 += slices[n][k].y0;
+          s1 += slices[n][k].y1;
+        }
+
+        s[k].y0 = s0 / (i_end-i);
+        s[k].y1 = s1 / (i_end-i);
+      }
+
+    new_slices.push_back(s);
+    d.push_back((i_end-i) * dx);
+    d_sum += d.back();
+
+    i = i_end;
+  }
+
+  d.back() += (x1-x0) - d_sum;
+
+  // Create expression.
+
+  Expression e;
+  vector<Slab*> slabs;
+
+  eps_average = inv_eps_average = 0.0;
+
+  for (unsigned int i=0; i<new_slices.size(); i++)
+  {
+    for (unsigned int j=0; j<new_slices[i].size(); j++)
+    {
+      const Real chunk_d = new_slices[i][j].y1 - new_slices[i][j].y0;
+      const Complex epsr = new_slices[i][j].mat->epsr();
+
+      eps_average     +=      epsr * chunk_d * d[i];
+      inv_eps_average += 1.0/epsr  * chunk_d * d[i];
+    }
+
+    slabs.push_back(shared_slabs.get(new_slices[i], y1-y0));
+    e.add_term(Term((*slabs.back())(d[i])));
+  }
+
+  if ( (x1 > x0) && (y1 > y0) )
+  {
+    eps_average     /= (x1-x0) * (y1-y0);
+    inv_eps_average /= (x1-x0) * (y1-y0);
+  }
+
+  // Add flipped scatterer.
+
+  if (add_flipped)
+    for (int i=slabs.size()-1; i>=0; i--)
+      e.add_term(Term((*slabs[i])(d[i])));
+
+  return e;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SharedSlabs::get
+//
+/////////////////////////////////////////////////////////////////////////////
+
+Slab* SharedSlabs::get(const Slice& slice, Real height)
+{
+  // Thicknesses, with the last one stretched to the total height.
+
+  vector<Real> t;
+  Real t_sum = 0.0;
+
+  for (unsigned int i=0; i<slice.size(); i++)
+  {
+    t.push_back(slice[i].y1 - slice[i].y0);
+    t_sum += t.back();
+  }
+
+  t.back() += height - t_sum;
+
+  Key key;
+  for (unsigned int i=0; i<slice.size(); i++)
+    key.push_back(std::make_pair(slice[i].mat->id(),
+      (long long) floor(t[i]/shared_slabs_resolution + 0.5)));
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::map<Key, Slab*>::iterator it = slabs.find(key);
+
+  if (it != slabs.end())
+  {
+    hits++;
+    return it->second;
+  }
+
+  Expression e;
+  for (unsigned int i=0; i<slice.size(); i++)
+    e.add_term(Term((*slice[i].mat)(t[i])));
+
+  Slab* slab = new Slab(e);
+  slabs[key] = slab;
+
+  return slab;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// SharedSlabs::clear
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void SharedSlabs::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  for (std::map<Key, Slab*>::iterator it = slabs.begin();
+       it != slabs.end(); ++it)
+    delete it->second;
+
+  slabs.clear();
+  hits = 0;
+}
@@ -0,0 +1,259 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     slabgeometry.h
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef SLABGEOMETRY_H
+#define SLABGEOMETRY_H
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include "generalslab.h"
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Rasteriser to convert a 2D geometry of convex shapes to an expression
+// of slabs. This is the native counterpart of Geometry.to_expression in
+// geometry.py, and uses the same coordinate system: x is the horizontal
+// propagation direction and y the vertical direction.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: Shape
+//
+//   Convex shape made of a single material.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class Shape
+{
+  public:
+
+    Shape(Material& m) : mat(&m) {}
+    virtual ~Shape() {}
+
+    // Returns false if the line at x does not intersect the shape, else
+    // the y coordinates where it enters and leaves, with y0 <= y1.
+
+    virtual bool intersection_at_x(Real x, Real* y0, Real* y1) const = 0;
+
+    Material* get_mat() const {return mat;}
+
+  protected:
+
+    Material* mat;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: CircleShape
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class CircleShape : public Shape
+{
+  public:
+
+    CircleShape(Real cx_, Real cy_, Real r_, Material& m)
+      : Shape(m), cx(cx_), cy(cy_), r(r_) {}
+
+    bool intersection_at_x(Real x, Real* y0, Real* y1) const;
+
+  protected:
+
+    Real cx, cy, r;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: RectangleShape
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class RectangleShape : public Shape
+{
+  public:
+
+    RectangleShape(Real x0, Real y0, Real x1, Real y1, Material& m);
+
+    bool intersection_at_x(Real x, Real* y0, Real* y1) const;
+
+  protected:
+
+    Real x0, y0, x1, y1;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: PolygonShape
+//
+//   Convex polygon, with the vertices given in order, either clockwise or
+//   counterclockwise.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class PolygonShape : public Shape
+{
+  public:
+
+    PolygonShape(const std::vector<Real>& x, const std::vector<Real>& y,
+                 Material& m);
+
+    bool intersection_at_x(Real x, Real* y0, Real* y1) const;
+
+  protected:
+
+    std::vector<Real> px, py;
+    Real x_min, x_max;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// STRUCT: SliceLayer
+//
+//   Part [y0, y1] of a vertical slice through the geometry.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+struct SliceLayer
+{
+    SliceLayer(Real y0_, Real y1_, Material* mat_)
+      : y0(y0_), y1(y1_), mat(mat_) {}
+
+    Real y0, y1;
+    Material* mat;
+};
+
+typedef std::vector<SliceLayer> Slice;
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: SlabGeometry
+//
+//   A geometry consisting of a background material and a list of shapes.
+//   If two shapes overlap, the shape added last takes precedence.
+//
+//   'to_expression' samples the geometry between x0 and x1 in steps of
+//   dx, and combines neighbouring slices if their interfaces are no more
+//   than dy apart, exactly like Geometry.to_expression.
+//
+//   Slices which are identical to a slice created before, by this or any
+//   other SlabGeometry, share the same Slab object. That way, their modes
+//   are only calculated once and the interface cache is reused as well.
+//   These slabs live until the end of the program, like the slab_cache
+//   list in geometry.py, see SharedSlabs.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class SlabGeometry
+{
+  public:
+
+    SlabGeometry(Material& background_mat)
+      : background(&background_mat), eps_average(0.0), inv_eps_average(0.0)
+      {}
+
+    ~SlabGeometry();
+
+    void add_circle(Real cx, Real cy, Real r, Material& m);
+
+    void add_rectangle(Real x0, Real y0, Real x1, Real y1, Material& m);
+
+    void add_triangle(Real x0, Real y0, Real x1, Real y1,
+                      Real x2, Real y2, Material& m);
+
+    void add_polygon(const std::vector<Real>& x, const std::vector<Real>& y,
+                     Material& m);
+
+    unsigned int size() const {return shapes.size();}
+
+    Expression to_expression(Real x0, Real x1, Real dx,
+                             Real y0, Real y1, Real dy,
+                             bool add_flipped=false);
+
+    // Averages of eps and 1/eps over the area of the last to_expression.
+
+    Complex get_eps_average()     const {return eps_average;}
+    Complex get_inv_eps_average() const {return inv_eps_average;}
+
+  protected:
+
+    Slice slice_at(Real x, Real y0, Real y1, Real dy) const;
+
+    Material* background;
+
+    std::vector<Shape*> shapes;
+
+    Complex eps_average, inv_eps_average;
+
+  private:
+
+    SlabGeometry(const SlabGeometry&);
+    SlabGeometry& operator=(const SlabGeometry&);
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// CLASS: SharedSlabs
+//
+//   Store of the slabs created by SlabGeometry, indexed by the ids of
+//   their layer materials and by their thicknesses. There is a single
+//   process-wide store, which can be used from several threads at once.
+//
+//   The slabs live until the end of the program, as expressions and
+//   stacks elsewhere can still refer to them. 'free_tmps' only drops the
+//   interface and overlap matrices cached for them.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class SharedSlabs
+{
+  public:
+
+    SharedSlabs() : hits(0) {}
+    ~SharedSlabs() {clear();}
+
+    // Returns the slab for these layers, creating it if needed. The last
+    // layer is stretched such that the total height is 'height'.
+
+    Slab* get(const Slice& slice, Real height);
+
+    void clear();
+
+    unsigned long size() const {return slabs.size();}
+    unsigned long get_hits() const {return hits;}
+
+  protected:
+
+    typedef std::vector<std::pair<unsigned long, long long> > Key;
+
+    std::map<Key, Slab*> slabs;
+
+    std::mutex mutex;
+
+    unsigned long hits;
+};
+
+extern SharedSlabs shared_slabs;
+
+
+
+#endif
@@ -168,10 +168,20 @@ SlabMatrixCache::~SlabMatrixCache()
 
 void SlabMatrixCache::deregister(SlabImpl* wg)
 {
+  // Erasing invalidates the iterators, so collect the keys first.
+
+  vector<pair<SlabImpl*, SlabImpl*> > to_wipe;
+  
   for (Cache<pair<SlabImpl*, SlabImpl*>, OverlapMatrices*>::iter
          i=cache.begin(); i!=cache.end(); ++i)
     if ( (i->first.first == wg) || (i->first.second == wg) )
-      cache.erase(i->first);
+    {
+      delete i->second;
+      to_wipe.push_back(i->first);
+    }
+
+  for (unsigned int i=0; i<to_wipe.size(); i++)
+    cache.erase(to_wipe[i]);
 }
 
 
@@ -199,5 +209,5 @@ void SlabMatrixCache::clear()
 //
 /////////////////////////////////////////////////////////////////////////////
 
-SlabMatrixCache slabmatrix_cache;
+thread_local SlabMatrixCache slabmatrix_cache;
 
@@ -76,7 +76,7 @@ class SlabMatrixCache
 //
 /////////////////////////////////////////////////////////////////////////////
 
-extern SlabMatrixCache slabmatrix_cache;
+extern thread_local SlabMatrixCache slabmatrix_cache;
 
 
 #endif
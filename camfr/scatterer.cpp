@@ -16,11 +16,11 @@ cVector dummy; // Used to keep the compiler happy.
 
 /////////////////////////////////////////////////////////////////////////////
 //
-// MultiScatterer::recalc_needed
+// MultiScatterer::settings_changed
 //  
 /////////////////////////////////////////////////////////////////////////////
 
-bool MultiScatterer::recalc_needed() const
+bool MultiScatterer::settings_changed() const
 {
   if (global.always_recalculate == true)
     return true;
@@ -36,6 +36,27 @@ bool MultiScatterer::recalc_needed() const
   if (abs(global.slab_ky - last_slab_ky) > eps)
     return true;
 
+  return false;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// MultiScatterer::recalc_needed
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+bool MultiScatterer::recalc_needed() const
+{
+  if (settings_changed())
+    return true;
+
+  if (materials_version(get_materials()) != last_materials_version)
+    return true;
+
+  const Real eps = 1e-10;
+
   if (!global.gain_mat)
     return false;
 
@@ -141,6 +162,7 @@ void DenseScatterer::copy_RT_from(const DenseScatterer& sc)
   if (global.gain_mat) 
     last_gain_mat_n = sc.last_gain_mat_n;
   last_slab_ky = sc.last_slab_ky;
+  last_materials_version = sc.last_materials_version;
 }
 
 
@@ -318,6 +340,7 @@ void DiagScatterer::copy_RT_from(const DiagScatterer& sc_d)
   if (global.gain_mat) 
     last_gain_mat_n = sc_d.last_gain_mat_n;
   last_slab_ky = sc_d.last_slab_ky;
+  last_materials_version = sc_d.last_materials_version;
 }
 
 
@@ -338,6 +361,25 @@ void DiagScatterer::swap_RT_with(DiagScatterer& sc_d)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// DiagScatterer::memory
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+std::size_t DiagScatterer::memory() const
+{
+  std::size_t elements = R12.size() + R21.size() + T12.size() + T21.size();
+
+  if (R12_dense)
+    elements += R12_dense->size() + R21_dense->size()
+              + T12_dense->size() + T21_dense->size();
+
+  return elements*sizeof(Complex);
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // DiagScatterer::convert_to_dense
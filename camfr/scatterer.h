@@ -49,6 +49,10 @@ class Scatterer
     virtual void  calcRT() {}
     virtual void allocRT() {}
     virtual void  freeRT() {}
+
+    // Bytes used by the R and T matrices.
+
+    virtual std::size_t memory() const {return 0;}
      
   protected:
     
@@ -75,13 +79,18 @@ class MultiScatterer : public Scatterer
   public:
 
     MultiScatterer()
-      : last_lambda(0.0), last_gain_mat_n(0.0), last_slab_ky(0,0) {}
+      : last_lambda(0.0), last_gain_mat_n(0.0), last_slab_ky(0,0),
+        last_materials_version(0) {}
     MultiScatterer(Waveguide& inc, Waveguide& ext)
       : Scatterer(inc, ext), last_lambda(0.0), last_gain_mat_n(0.0), 
-        last_slab_ky(0.0) {}
+        last_slab_ky(0.0), last_materials_version(0) {}
 
     bool recalc_needed() const;
 
+    // Like recalc_needed, but ignoring changes in the materials.
+
+    bool settings_changed() const;
+
     virtual const cMatrix& get_R12() const = 0;
     virtual const cMatrix& get_R21() const = 0;
     virtual const cMatrix& get_T12() const = 0;
@@ -94,12 +103,13 @@ class MultiScatterer : public Scatterer
 
   protected:
 
-    // The wavelength and gain the matrices were last calculated for,
-    // are used to determine if recalculation is needed.
+    // The wavelength, gain and material versions the matrices were last
+    // calculated for, are used to determine if recalculation is needed.
 
     Complex last_lambda;
     Complex last_gain_mat_n;
     Complex last_slab_ky;
+    unsigned long last_materials_version;
 };
 
 
@@ -147,6 +157,9 @@ class DenseScatterer : public MultiScatterer
     
     void copy_RT_from(const DenseScatterer& sc);
     void swap_RT_with(      DenseScatterer& sc);
+
+    std::size_t memory() const
+      {return (R12.size()+R21.size()+T12.size()+T21.size())*sizeof(Complex);}
     
   protected:
 
@@ -205,6 +218,8 @@ class DiagScatterer : public MultiScatterer
 
     void copy_RT_from(const DiagScatterer& sc_d);
     void swap_RT_with(      DiagScatterer& sc_d);
+
+    std::size_t memory() const;
        
   protected:
 
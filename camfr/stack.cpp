@@ -268,6 +268,325 @@ vector<Complex*> StackImpl::get_thicknesses() const
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// StackImpl::operator=
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+StackImpl& StackImpl::operator=(const StackImpl& s)
+{
+  if (this == &s)
+    return *this;
+
+  free_composites();
+
+  chunks        = s.chunks;
+  no_of_periods = s.no_of_periods;
+
+  return *this;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// inner_thicknesses
+//
+//   Thicknesses of all chunks of sc and of its own substacks, or nothing
+//   if sc is not a stack.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void inner_thicknesses(const Scatterer* sc, vector<Complex>* d)
+{
+  const StackImpl* st = dynamic_cast<const StackImpl*>(sc);
+  if (!st)
+    return;
+
+  const vector<Chunk>* chunks = st->get_chunks();
+  
+  for (unsigned int k=0; k<chunks->size(); k++)
+  {
+    d->push_back((*chunks)[k].d);
+    inner_thicknesses((*chunks)[k].sc, d);
+  }
+}
+
+vector<Complex> inner_thicknesses(const Scatterer* sc)
+{
+  vector<Complex> d;
+  inner_thicknesses(sc, &d);
+  return d;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// StackImpl::thicknesses_changed
+//
+//   True if a chunk thickness was changed (e.g. through the pointers
+//   returned by get_thicknesses) since the last calculation, also inside
+//   a chunk that is itself a stack, or if the stack wasn't calculated yet.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+bool StackImpl::thicknesses_changed() const
+{
+  if (    (last_d.size()       != chunks.size())
+       || (last_inner_d.size() != chunks.size()) )
+    return true;
+
+  for (unsigned int k=0; k<chunks.size(); k++)
+    if (    (chunks[k].d != last_d[k])
+         || (inner_thicknesses(chunks[k].sc) != last_inner_d[k]) )
+      return true;
+
+  return false;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// StackImpl::find_dirty_chunks
+//
+//   A chunk is dirty if its thickness changed, if a thickness inside it
+//   changed when it is a substack, if one of its materials changed (e.g.
+//   through Material::set_n), or if 'all' is true.
+//
+//   The scatterers of the chunks themselves are not queried, since they
+//   may be shared with other stacks that already recalculated them.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void StackImpl::find_dirty_chunks(bool all)
+{
+  if (    (last_d.size()       != chunks.size())
+       || (last_inner_d.size() != chunks.size())
+       || (last_version.size() != chunks.size()) )
+    all = true;
+
+  dirty.resize(chunks.size());
+
+  for (unsigned int k=0; k<chunks.size(); k++)
+    dirty[k] =    all
+               || (chunks[k].d != last_d[k])
+               || (inner_thicknesses(chunks[k].sc) != last_inner_d[k])
+               || (   materials_version(chunks[k].sc->get_materials())
+                   != last_version[k]);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// StackImpl::remember_chunks
+//
+//   Stores the chunk thicknesses, including those inside substacks, and
+//   the material versions the stack was calculated for.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void StackImpl::remember_chunks()
+{
+  last_d.resize(chunks.size());
+  last_inner_d.resize(chunks.size());
+  last_version.resize(chunks.size());
+
+  for (unsigned int k=0; k<chunks.size(); k++)
+  {
+    last_d[k]       = chunks[k].d;
+    last_inner_d[k] = inner_thicknesses(chunks[k].sc);
+    last_version[k] = materials_version(chunks[k].sc->get_materials());
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// StackImpl::free_composites
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void StackImpl::free_composites()
+{
+  for (unsigned int k=0; k<prefix.size(); k++)
+    delete prefix[k];
+
+  for (unsigned int k=0; k<suffix.size(); k++)
+    delete suffix[k];
+
+  prefix.clear();
+  suffix.clear();
+  last_d.clear();
+  last_inner_d.clear();
+  last_version.clear();
+  dirty.clear();
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// StackImpl::free_composites
+//
+//   Frees the prefixes and suffixes which contain one of the chunks a..b.
+//   The others are kept for the next calculation.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void StackImpl::free_composites(int a, int b)
+{
+  const int K = prefix.size();
+
+  for (int k=a; k<K; k++)
+  {
+    delete prefix[k];
+    prefix[k] = NULL;
+  }
+
+  for (int k=0; (k<=b) && (k<K); k++)
+  {
+    delete suffix[k];
+    suffix[k] = NULL;
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// stack_prefix
+//
+//   Returns the combination of chunks 0..k, extending the longest
+//   valid prefix one chunk at a time if needed.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+T* stack_prefix(T* stack, int k)
+{
+  int j = k;
+  while ( (j >= 0) && !stack->prefix[j] )
+    j--;
+
+  for (int i=j+1; i<=k; i++)
+  {
+    vector<Chunk> pair;
+    if (i > 0)
+      pair.push_back(Chunk(stack->prefix[i-1]));
+    pair.push_back(stack->chunks[i]);
+
+    T* combined = new T;
+    S_scheme(pair, combined);
+    stack->prefix[i] = combined;
+  }
+
+  return dynamic_cast<T*>(stack->prefix[k]);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// stack_suffix
+//
+//   Returns the combination of chunks k..end, extending the longest
+//   valid suffix one chunk at a time if needed.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+T* stack_suffix(T* stack, int k)
+{
+  const int K = stack->chunks.size();
+
+  int j = k;
+  while ( (j < K) && !stack->suffix[j] )
+    j++;
+
+  for (int i=j-1; i>=k; i--)
+  {
+    vector<Chunk> pair;
+    pair.push_back(stack->chunks[i]);
+    if (i < K-1)
+      pair.push_back(Chunk(stack->suffix[i+1]));
+
+    T* combined = new T;
+    S_scheme(pair, combined);
+    stack->suffix[i] = combined;
+  }
+
+  return dynamic_cast<T*>(stack->suffix[k]);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// stack_calcRT_incremental
+//
+//   If chunks a..b are dirty, the result is the star product of the
+//   prefix 0..a-1, the chunks a..b and the suffix b+1..end. The prefixes
+//   and suffixes which do not contain dirty chunks are kept from the
+//   previous calculation, so changing a single chunk costs two star
+//   products once the stack has been calculated with that chunk dirty.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+void stack_calcRT_incremental(T* stack)
+{
+  const int K = stack->chunks.size();
+
+  if (stack->prefix.size() != stack->chunks.size())
+  {
+    stack->prefix.assign(K, NULL);
+    stack->suffix.assign(K, NULL);
+  }
+
+  // Find range of dirty chunks.
+
+  int a = K, b = -1;
+
+  for (int k=0; k<K; k++)
+    if (stack->dirty[k])
+    {
+      if (k < a) a = k;
+      b = k;
+    }
+
+  if (b < 0) // Recalculation forced in another way.
+  {
+    a = 0;
+    b = K-1;
+  }
+
+  // Drop combinations containing dirty chunks.
+
+  stack->free_composites(a, b);
+
+  // Combine.
+
+  vector<Chunk> parts;
+
+  if (a > 0)
+    parts.push_back(Chunk(stack_prefix(stack, a-1)));
+
+  for (int k=a; k<=b; k++)
+    parts.push_back(stack->chunks[k]);
+
+  if (b < K-1)
+    parts.push_back(Chunk(stack_suffix(stack, b+1)));
+
+  S_scheme(parts, stack);
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // stack_calcRT
@@ -282,7 +601,12 @@ void stack_calcRT(T* stack)
 { 
   if (stack->no_of_periods == 1)
   {
-    S_scheme(stack->chunks, stack);
+    if (global.incremental_stacks && 
+        (stack->dirty.size() == stack->chunks.size()))
+      stack_calcRT_incremental(stack);
+    else
+      S_scheme(stack->chunks, stack);
+    
     return;
   }
 
@@ -400,9 +724,17 @@ DenseStack::DenseStack(const Expression& e, unsigned int no_of_periods)
 
 void DenseStack::calcRT()
 {
-  if (!recalc_needed())
+  const bool all      = settings_changed();
+  const bool material = !all && recalc_needed();
+
+  if (!all && !material && !thicknesses_changed())
     return;
 
+  if (global.incremental_stacks && (no_of_periods == 1))
+    find_dirty_chunks(all);
+  else
+    free_composites();
+
   allocRT();
 
   for (unsigned int i=0; i<chunks.size(); i++)
@@ -416,6 +748,9 @@ void DenseStack::calcRT()
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
   last_slab_ky = global.slab_ky;
+  last_materials_version = materials_version(get_materials());
+
+  remember_chunks();
 }
 
 
@@ -429,6 +764,7 @@ void DenseStack::calcRT()
 void DenseStack::freeRT()
 {
   DenseScatterer::freeRT();
+  free_composites();
   
   for (unsigned int i=0; i<chunks.size(); i++)
     chunks[i].sc->freeRT();
@@ -475,9 +811,17 @@ DiagStack::DiagStack(const Expression& e, unsigned int no_of_periods)
 
 void DiagStack::calcRT()
 { 
-  if (!recalc_needed())
+  const bool all      = settings_changed();
+  const bool material = !all && recalc_needed();
+
+  if (!all && !material && !thicknesses_changed())
     return;
 
+  if (global.incremental_stacks && (no_of_periods == 1))
+    find_dirty_chunks(all);
+  else
+    free_composites();
+
   allocRT();
 
   for (unsigned int i=0; i<chunks.size(); i++)
@@ -491,6 +835,9 @@ void DiagStack::calcRT()
   if (global.gain_mat)
     last_gain_mat_n = global.gain_mat->n();
   last_slab_ky = global.slab_ky;
+  last_materials_version = materials_version(get_materials());
+
+  remember_chunks();
 }
 
 
@@ -504,6 +851,7 @@ void DiagStack::calcRT()
 void DiagStack::freeRT()
 {
   DiagScatterer::freeRT();
+  free_composites();
   
   for (unsigned int i=0; i<chunks.size(); i++)
     chunks[i].sc->freeRT();
@@ -574,7 +922,8 @@ void MonoStack::calcRT()
 
 Stack::Stack(const Expression& e, unsigned int no_of_periods_)
   : expression(e), no_of_periods(no_of_periods_), 
-    inc_field(fortranArray), inc_field_bw(fortranArray)
+    inc_field(fortranArray), inc_field_bw(fortranArray),
+    cache_generation(interface_cache.get_generation())
 {
   sc = create_sc(expression, no_of_periods);
   flat_sc = create_sc(expression.flatten());
@@ -591,7 +940,8 @@ Stack::Stack(const Expression& e, unsigned int no_of_periods_)
 
 Stack::Stack(const Term& t)
   : expression(Expression(t)), no_of_periods(1), 
-    inc_field(fortranArray), inc_field_bw(fortranArray)
+    inc_field(fortranArray), inc_field_bw(fortranArray),
+    cache_generation(interface_cache.get_generation())
 {
   sc = create_sc(expression, no_of_periods);
   flat_sc = create_sc(expression.flatten());
@@ -610,7 +960,8 @@ Stack::Stack(const Stack& s)
   : expression(s.expression), no_of_periods(s.no_of_periods),
     interface_positions(s.interface_positions),
     interface_field(s.interface_field),
-    inc_field(fortranArray), inc_field_bw(fortranArray)
+    inc_field(fortranArray), inc_field_bw(fortranArray),
+    cache_generation(interface_cache.get_generation())
 {
   inc_field.resize(s.inc_field.shape());
   inc_field = s.inc_field;
@@ -708,10 +1059,39 @@ bool Stack::single_material() const
 
 void Stack::calcRT()
 {
-  if (sc)
-    sc->calcRT();
-  else
+  if (!sc)
+  {
     py_error("No scatterer defined.");
+    return;
+  }
+
+  interface_cache.enter();
+
+  sc->calcRT();
+
+  // The interface cache may have freed the matrices of some interfaces
+  // of this stack, which are still needed for the fields. Only these are
+  // recalculated: the matrices of the stack itself and its prefix and
+  // suffix combinations are not kept in the cache.
+
+  if (cache_generation != interface_cache.get_generation())
+  {
+    const vector<Chunk>* chunks
+      = dynamic_cast<StackImpl*>(flat_sc)->get_chunks();
+
+    for (unsigned int k=0; k<chunks->size(); k++)
+    {
+      Scatterer* s = (*chunks)[k].sc;
+
+      if (    interface_cache.get_eviction(s->get_inc(), s->get_ext())
+            > cache_generation )
+        s->calcRT();
+    }
+    
+    cache_generation = interface_cache.get_generation();
+  }
+
+  interface_cache.leave();
 }
 
 
@@ -733,6 +1113,46 @@ void Stack::allocRT()
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Stack::set_thickness
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void Stack::set_thickness(unsigned int k, const Complex& d)
+{
+  if (!sc)
+  {
+    py_error("No scatterer defined.");
+    return;
+  }
+
+  vector<Complex*> d_sc
+    = dynamic_cast<const StackImpl*>(sc)->get_thicknesses();
+  vector<Complex*> d_flat
+    = dynamic_cast<const StackImpl*>(flat_sc)->get_thicknesses();
+
+  if ( (no_of_periods != 1) || (d_sc.size() != d_flat.size()) )
+  {
+    py_error("Error: set_thickness not supported for this stack.");
+    return;
+  }
+
+  if (k >= d_sc.size())
+  {
+    py_error("Error: chunk index out of range.");
+    return;
+  }
+
+  *d_sc[k]   = d;
+  *d_flat[k] = d;
+
+  calc_interface_positions();
+  interface_field.clear();
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Stack::freeRT
@@ -829,6 +1249,109 @@ cVector Stack::get_trans_field()
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Stack::check_inc_fields
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void Stack::check_inc_fields(const cMatrix& inc, const cMatrix* inc_bw)
+{
+  if (!as_multi())
+  {
+    py_error("Error: multiple excitations not supported for MonoStacks.");
+    exit (-1);
+  }
+
+  if (inc.rows() != global.N)
+  {
+    py_error("Error: incident fields should have N rows.");
+    exit (-1);
+  }
+
+  if (    inc_bw 
+       && (    (inc_bw->rows()    != inc.rows()) 
+            || (inc_bw->columns() != inc.columns()) ) )
+  {
+    py_error("Error: forward and backward incident fields don't match.");
+    exit (-1);
+  }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Stack::get_refl_fields
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+cMatrix Stack::get_refl_fields(const cMatrix& inc, const cMatrix* inc_bw)
+{
+  check_inc_fields(inc, inc_bw);
+  
+  calcRT();
+
+  cMatrix refl(inc.rows(), inc.columns(), fortranArray);
+  multiply(as_multi()->get_R12(), inc, &refl);
+
+  if (inc_bw)
+    multiply(as_multi()->get_T21(), *inc_bw, &refl, 1.0, 1.0);
+
+  return refl;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Stack::get_trans_fields
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+cMatrix Stack::get_trans_fields(const cMatrix& inc, const cMatrix* inc_bw)
+{
+  check_inc_fields(inc, inc_bw);
+  
+  calcRT();
+
+  cMatrix trans(inc.rows(), inc.columns(), fortranArray);
+  multiply(as_multi()->get_T12(), inc, &trans);
+
+  if (inc_bw)
+    multiply(as_multi()->get_R21(), *inc_bw, &trans, 1.0, 1.0);
+
+  return trans;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Stack::get_interface_fields
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void Stack::get_interface_fields(const cMatrix& inc, const cMatrix* inc_bw,
+                                 vector<cMatrix>* fw, vector<cMatrix>* bw)
+{
+  fw->clear();
+  bw->clear();
+
+  cMatrix fw0(inc.rows(), inc.columns(), fortranArray);
+  fw0 = inc;
+  
+  fw->push_back(fw0);
+  bw->push_back(get_refl_fields(inc, inc_bw));
+
+  const vector<Chunk>* chunks
+    = dynamic_cast<StackImpl*>(flat_sc)->get_chunks();
+
+  S_scheme_fields_S_multi(*chunks, fw, bw, inc_bw);
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Stack::inc_field_expansion
@@ -977,6 +1500,107 @@ Field Stack::field(const Coord& coord)
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//
+// Stack::field_grid
+//
+//   The z positions are grouped per waveguide. For each waveguide, the
+//   mode profiles are tabulated on the c1 grid in matrices P (c1 x modes)
+//   for every field component, and the coefficients of all z positions
+//   are gathered in matrices C (modes x z). The fields then follow from
+//   the product P*C, with C = fw+bw or fw-bw depending on the symmetry
+//   of the component.
+//  
+/////////////////////////////////////////////////////////////////////////////
+
+void Stack::field_grid(const vector<Complex>& c1, const vector<Complex>& z,
+                       cHyperM* result, const Complex& c2)
+{
+  // If needed, calculate field at each interface.
+  
+  if (interface_field.size() <= 1)
+    calc_interface_fields();
+
+  const int n_c1 = c1.size();
+  const int n_z  =  z.size();
+
+  result->resize(n_z, n_c1, 6);
+
+  // Group z positions per waveguide.
+
+  const vector<Chunk>* chunks
+    = dynamic_cast<StackImpl*>(flat_sc)->get_chunks();
+
+  vector<Waveguide*> wgs;
+  vector<vector<int> > z_indices;
+  
+  for (int k=0; k<n_z; k++)
+  {
+    unsigned int index = index_lookup(z[k], Min, interface_positions);
+    
+    if (index == chunks->size())
+      index--;
+
+    Waveguide* wg = (*chunks)[index].sc->get_ext();
+
+    unsigned int w = 0;
+    while ( (w < wgs.size()) && (wgs[w] != wg) )
+      w++;
+
+    if (w == wgs.size())
+    {
+      wgs.push_back(wg);
+      z_indices.push_back(vector<int>());
+    }
+
+    z_indices[w].push_back(k);
+  }
+
+  // Loop over waveguides.
+
+  vector<Coord> coords;
+  for (int x=0; x<n_c1; x++)
+    coords.push_back(Coord(c1[x], c2, 0.0));
+
+  const int N = global.N;
+  
+  for (unsigned int w=0; w<wgs.size(); w++)
+  {
+    const int n = z_indices[w].size();
+    
+    // Tabulate mode profiles.
+
+    ModeProfiles profiles(wgs[w], coords);
+
+    // Gather expansion coefficients.
+
+    cMatrix fw_all(N, n, fortranArray);
+    cMatrix bw_all(N, n, fortranArray);
+
+    cVector fw(N, fortranArray);
+    cVector bw(N, fortranArray);
+
+    for (int k=0; k<n; k++)
+    {
+      fw_bw_field(Coord(0.0, 0.0, z[z_indices[w][k]]), &fw, &bw);
+
+      fw_all(blitz::Range::all(), k+1) = fw;
+      bw_all(blitz::Range::all(), k+1) = bw;
+    }
+
+    // Calculate fields.
+
+    cHyperM f;
+    profiles.fields(fw_all, bw_all, &f);
+
+    for (int k=0; k<n; k++)
+      (*result)(z_indices[w][k], blitz::Range::all(), blitz::Range::all())
+        = f(k, blitz::Range::all(), blitz::Range::all());
+  }
+}
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // fw_bw_field
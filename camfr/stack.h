@@ -18,6 +18,7 @@
 #include "chunk.h"
 #include "S_scheme.h"
 #include "expression.h"
+#include "icache.h"
 
 /////////////////////////////////////////////////////////////////////////////
 //
@@ -44,7 +45,11 @@ class StackImpl
   
     StackImpl(const std::vector<Chunk>& chunks, unsigned int no_of_periods=1);
     StackImpl(const Expression& e,              unsigned int no_of_periods=1);
-    virtual ~StackImpl() {}
+    StackImpl(const StackImpl& s)
+      : chunks(s.chunks), no_of_periods(s.no_of_periods) {}
+    virtual ~StackImpl() {free_composites();}
+
+    StackImpl& operator=(const StackImpl& s);
 
     Complex stack_get_total_thickness()          const;
     std::vector<Material*> stack_get_materials() const;
@@ -57,12 +62,44 @@ class StackImpl
     const std::vector<Chunk>* get_chunks() const {return &chunks;}
     
     template <class T> friend void stack_calcRT(T* stack);
+    template <class T> friend void stack_calcRT_incremental(T* stack);
+    template <class T> friend T* stack_prefix(T* stack, int k);
+    template <class T> friend T* stack_suffix(T* stack, int k);
     
   protected:
 
     std::vector<Chunk> chunks;
     unsigned int  no_of_periods;
 
+    // Bookkeeping to detect changes in thickness or material, and for
+    // global.incremental_stacks. The combined scatterers are owned by the
+    // stack and are of the same type as the stack.
+    //
+    // For K chunks, there are up to 2K combined scatterers, each with four
+    // R and T matrices. For a DenseStack that is 2K*4*N*N complex numbers,
+    // i.e. 128*K*N*N bytes, on top of the matrices of the stack itself.
+    // They are not part of the interface cache and its budget. They are
+    // freed by freeRT, by a calculation without global.incremental_stacks,
+    // and per range when chunks change.
+
+    bool thicknesses_changed() const;
+    void find_dirty_chunks(bool all);
+    void remember_chunks();
+    void free_composites();
+    void free_composites(int a, int b); // Those containing chunks a..b.
+
+    // Chunks changed since the last calculation, and their thicknesses,
+    // the thicknesses inside substack chunks and the material versions
+    // at that calculation.
+
+    std::vector<bool>                  dirty;
+    std::vector<Complex>               last_d;
+    std::vector<std::vector<Complex> > last_inner_d;
+    std::vector<unsigned long>         last_version;
+
+    std::vector<Scatterer*> prefix; // prefix[k]: chunks 0..k, or NULL.
+    std::vector<Scatterer*> suffix; // suffix[k]: chunks k..end, or NULL.
+
   private:
     
     void create_from(const Expression& e);
@@ -195,7 +232,8 @@ class Stack
   public:
 
     Stack() : sc(NULL), flat_sc(NULL), 
-              inc_field(fortranArray), inc_field_bw(fortranArray) {}
+              inc_field(fortranArray), inc_field_bw(fortranArray),
+              cache_generation(interface_cache.get_generation()) {}
 
     Stack(const Expression& e, unsigned int no_of_periods=1);
     Stack(const Term& t);
@@ -214,6 +252,12 @@ class Stack
     bool    single_material() const;
 
     Complex get_total_thickness() const {return sc->get_total_thickness();}
+
+    // Changes the thickness of chunk k (0 based), i.e. the propagation
+    // after the k'th interface, without rebuilding the stack. Only for
+    // stacks without periodic extension or substacks.
+
+    void set_thickness(unsigned int k, const Complex& d);
     
     std::vector<Material*> get_materials() const {return sc->get_materials();}
 
@@ -230,12 +274,34 @@ class Stack
     cVector get_refl_field();
     cVector get_trans_field();
 
+    // Counterparts of the above for K excitations at once, given as the
+    // columns of the N x K matrix 'inc' (and optionally 'inc_bw'). The 
+    // incident field set by set_inc_field is left untouched.
+    // get_interface_fields returns the N x K expansions at the same
+    // positions as get_interface_field.
+
+    cMatrix get_refl_fields (const cMatrix& inc, const cMatrix* inc_bw=NULL);
+    cMatrix get_trans_fields(const cMatrix& inc, const cMatrix* inc_bw=NULL);
+
+    void get_interface_fields(const cMatrix& inc, const cMatrix* inc_bw,
+                              std::vector<cMatrix>* fw,
+                              std::vector<cMatrix>* bw);
+
     FieldExpansion inc_field_expansion();
     FieldExpansion ext_field_expansion();
     
     Field field(const Coord& coord);
     void fw_bw_field(const Coord& coord, cVector* fw, cVector* bw);
 
+    // Field on a grid of c1 and z values, at a fixed c2. The result has
+    // dimensions (z, c1, component), with components in the order
+    // E1, E2, Ez, H1, H2, Hz. The mode profiles of each waveguide are only
+    // evaluated once, rather than once for every z.
+
+    void field_grid(const std::vector<Complex>& c1,
+                    const std::vector<Complex>& z,
+                    cHyperM* result, const Complex& c2=0.0);
+
     void set_interface_field(const std::vector<FieldExpansion>& field);
     void get_interface_field(      std::vector<FieldExpansion>* field);
 
@@ -298,6 +364,11 @@ class Stack
     std::vector<Complex> interface_positions;
 
     cVector inc_field, inc_field_bw;
+
+    // Generation of the interface cache at the last calculation, used to
+    // find the interfaces of this stack that were freed since.
+
+    unsigned long cache_generation;
     bool bw_inc;
     
     std::vector<FieldExpansion> interface_field;
@@ -309,6 +380,8 @@ class Stack
     void calc_interface_positions();
 
     void calc_interface_fields();
+
+    void check_inc_fields(const cMatrix& inc, const cMatrix* inc_bw);
 };
 
 
@@ -0,0 +1,163 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     sweep.cpp
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <set>
+#include "sweep.h"
+#include "context.h"
+
+using std::vector;
+using std::set;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// stack_waveguides
+//
+//   Waveguides of all chunks of a stack, including those of substacks.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+set<Waveguide*> stack_waveguides(const Stack& stack)
+{
+  set<Waveguide*> waveguides;
+
+  const vector<Chunk>* chunks
+    = dynamic_cast<const StackImpl*>(stack.get_flat_sc())->get_chunks();
+
+  for (unsigned int k=0; k<chunks->size(); k++)
+  {
+    waveguides.insert((*chunks)[k].sc->get_inc());
+    waveguides.insert((*chunks)[k].sc->get_ext());
+  }
+
+  return waveguides;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// check_sweep
+//
+/////////////////////////////////////////////////////////////////////////////
+
+std::string check_sweep(const vector<Stack*>& stacks,
+                        const vector<Element>& elements)
+{
+  if (stacks.empty())
+    return "no stacks given to sweep_lambda.";
+
+  // Stacks should be independent.
+
+  set<Waveguide*> seen;
+
+  for (unsigned int i=0; i<stacks.size(); i++)
+  {
+    for (unsigned int j=0; j<i; j++)
+      if (stacks[i] == stacks[j])
+        return "the same stack is given twice to sweep_lambda.";
+
+    set<Waveguide*> waveguides = stack_waveguides(*stacks[i]);
+
+    for (set<Waveguide*>::iterator w=waveguides.begin();
+         w!=waveguides.end(); ++w)
+      if (!seen.insert(*w).second)
+        return "stacks given to sweep_lambda share a waveguide.";
+  }
+
+  // Element indices.
+
+  const int N = stacks[0]->as_multi() ? global.N : 1;
+
+  for (unsigned int e=0; e<elements.size(); e++)
+    if (    (elements[e].first  < 1) || (elements[e].first  > N)
+         || (elements[e].second < 1) || (elements[e].second > N) )
+      return "element index out of bounds in sweep_lambda.";
+
+  return "";
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// sweep_lambda
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void sweep_lambda(const vector<Stack*>& stacks, const vector<Complex>& lambdas,
+                  const vector<Element>& elements, cMatrix* R12, cMatrix* T12)
+{
+  const std::string error = check_sweep(stacks, elements);
+
+  if (!error.empty())
+  {
+    py_error("Error: " + error);
+    return;
+  }
+
+  // Determine which elements to store.
+
+  const int N = stacks[0]->as_multi() ? global.N : 1;
+
+  vector<Element> el(elements);
+  if (el.empty())
+    for (int i=1; i<=N; i++)
+      for (int j=1; j<=N; j++)
+        el.push_back(Element(i,j));
+
+  const int L = lambdas.size();
+  const int E = el.size();
+
+  // Results of the right shape are written in place, so R12 and T12 can
+  // be views of storage provided by the caller.
+
+  if ((R12->rows() != L) || (R12->columns() != E))
+    R12->resize(L,E);
+  if ((T12->rows() != L) || (T12->columns() != E))
+    T12->resize(L,E);
+
+  // Loop over wavelengths, dealing them out dynamically, as the cost of
+  // mode finding can vary strongly over the spectrum.
+
+  const ThreadContext context = get_thread_context();
+
+  #pragma omp parallel num_threads(stacks.size())
+  {
+    ContextSwitch context_switch(context);
+
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+
+    Stack* stack = stacks[thread];
+
+    #pragma omp for schedule(dynamic)
+    for (int l=0; l<L; l++)
+    {
+      global.lambda = lambdas[l];
+      stack->calcRT();
+
+      for (int e=0; e<E; e++)
+      {
+        (*R12)(l+1,e+1) = stack->R12(el[e].first, el[e].second);
+        (*T12)(l+1,e+1) = stack->T12(el[e].first, el[e].second);
+      }
+    }
+
+    // Interfaces created by the workers are keyed on waveguides which
+    // they cannot see being destroyed.
+
+    if (thread != 0)
+      clear_thread_caches();
+  }
+}
@@ -0,0 +1,59 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// File:     sweep.h
+//
+// Copyright (C) 1998-2006 Peter Bienstman - Ghent University
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <vector>
+#include <string>
+#include "stack.h"
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// sweep_lambda
+//
+//   Calculates R12 and T12 of a stack for a list of wavelengths.
+//
+//   'stacks' contains independent copies of the same structure, i.e.
+//   built from different Waveguide objects, since a Waveguide stores the
+//   modes for the wavelength it was last calculated for. Each copy is
+//   handed to its own worker thread, so the number of threads equals the
+//   number of stacks. The workers run with the solver settings of the
+//   calling thread, apart from the wavelength, and have their own
+//   interface cache. Stacks that are not independent are refused, see
+//   check_sweep.
+//
+//   'elements' lists the (i,j) matrix elements to return (indices
+//   starting at 1). If it is empty, all N*N elements are returned, with j
+//   running fastest.
+//
+//   Row l of R12 and T12 contains the requested elements for lambdas[l].
+//   R12 and T12 are only resized if they do not already have the shape
+//   (lambdas, elements), so they can be views of existing storage.
+//
+//   The global wavelength of the calling thread is left untouched.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+typedef std::pair<int,int> Element;
+
+// Returns an empty string if sweep_lambda can be run on these stacks and
+// elements, else a description of the problem. Stacks that are the same
+// or share a waveguide are rejected, as their workers would race.
+
+std::string check_sweep(const std::vector<Stack*>& stacks,
+                        const std::vector<Element>& elements);
+
+void sweep_lambda(const std::vector<Stack*>& stacks,
+                  const std::vector<Complex>& lambdas,
+                  const std::vector<Element>& elements,
+                  cMatrix* R12, cMatrix* T12);
+
+
+
+#endif
@@ -13,66 +13,232 @@
 #ifndef STORAGE_H
 #define STORAGE_H
 
-#include <map>
 #include <vector>
+#include <functional>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Hash functions used by Cache. Pairs of pointers, the most common key,
+// get a dedicated hash, since the low bits of pointers are mostly zero.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+inline std::size_t cache_mix(unsigned long long h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+
+  return std::size_t(h);
+}
+
+template <class T>
+struct CacheHash
+{
+  std::size_t operator()(const T& t) const 
+    {return cache_mix(std::hash<T>()(t));}
+};
+
+template <class A, class B>
+struct CacheHash<std::pair<A*, B*> >
+{
+  std::size_t operator()(const std::pair<A*, B*>& p) const
+    {
+      unsigned long long a = reinterpret_cast<std::size_t>(p.first);
+      unsigned long long b = reinterpret_cast<std::size_t>(p.second);
+
+      return cache_mix(a ^ (b*0x9e3779b97f4a7c15ULL + (a<<6) + (a>>2)));
+    }
+};
+
+
 
 /////////////////////////////////////////////////////////////////////////////
 //
 // A general lookup cache that can grow arbitrarily large.
 //
+// Implemented as a hash table with open addressing and linear probing.
+// Iterators point to a std::pair<Key, Value> and are invalidated by
+// 'store' and 'erase'.
+//
 /////////////////////////////////////////////////////////////////////////////
 
 template <class Key, class Value>
 class Cache
 {
+  protected:
+
+    struct Slot
+    {
+      Slot() : full(false) {}
+
+      std::pair<Key, Value> kv;
+      bool full;
+    };
+
+    template <class S, class P>
+    class Iterator
+    {
+      public:
+
+        Iterator(S* p_, S* end_) : p(p_), end(end_) {skip();}
+
+        P& operator* () const {return  p->kv;}
+        P* operator->() const {return &p->kv;}
+
+        Iterator& operator++() {++p; skip(); return *this;}
+
+        bool operator==(const Iterator& i) const {return p == i.p;}
+        bool operator!=(const Iterator& i) const {return p != i.p;}
+
+      protected:
+
+        void skip() {while ( (p != end) && !p->full ) ++p;}
+
+        S* p;
+        S* end;
+    };
+
   public:
   
-    Cache() {}
+    Cache() : entries(0) {}
     
     ~Cache() {}
     
-    typedef typename std::map<Key, Value>::const_iterator const_iter;
-    typedef typename std::map<Key, Value>::      iterator       iter;
+    typedef Iterator<const Slot, const std::pair<Key, Value> > const_iter;
+    typedef Iterator<      Slot,       std::pair<Key, Value> >       iter;
     
     bool lookup(const Key& key, Value* value) const
       {
-        const_iter i = storage.find(key);
+        const Value* v = find(key);
 
-        if (i == storage.end())
+        if (!v)
           return false;
         else
         {
-          *value = i->second;
+          *value = *v;
           return true;
         }
       }
+
+    // Returns a pointer to the stored value, which can be updated in
+    // place, or NULL if the key is not present.
+
+    const Value* find(const Key& key) const
+      {
+        if (entries == 0)
+          return NULL;
+        
+        const std::size_t mask = slots.size() - 1;
+        
+        for (std::size_t i=hash(key) & mask; slots[i].full; i=(i+1) & mask)
+          if (slots[i].kv.first == key)
+            return &slots[i].kv.second;
+
+        return NULL;
+      }
+
+    Value* find(const Key& key) 
+      {
+        const Cache* c = this;
+        return const_cast<Value*>(c->find(key));
+      }
     
     void store(const Key& key, const Value& value)
       {
-        std::pair<Key, Value> new_pair(key, value);
+        Value* v = find(key);
+
+        if (v) // Entry was already present.
+        {
+          *v = value;
+          return;
+        }
+
+        if ( 4*(entries+1) > 3*slots.size() )
+          grow();
+
+        const std::size_t mask = slots.size() - 1;
+
+        std::size_t i = hash(key) & mask;
+        while (slots[i].full)
+          i = (i+1) & mask;
 
-        std::pair<const_iter, bool> result = storage.insert(new_pair);
+        slots[i].kv.first  = key;
+        slots[i].kv.second = value;
+        slots[i].full      = true;
 
-        if (result.second == false) // Entry was already present.
+        entries++;
+      }
+
+    void erase(const Key& key)
+      {
+        if (entries == 0)
+          return;
+        
+        const std::size_t mask = slots.size() - 1;
+
+        std::size_t i = hash(key) & mask;
+        while (slots[i].full && !(slots[i].kv.first == key))
+          i = (i+1) & mask;
+
+        if (!slots[i].full)
+          return;
+
+        // Shift back the following entries of the probe sequence, 
+        // so that no tombstones are needed.
+
+        for (std::size_t j=(i+1) & mask; slots[j].full; j=(j+1) & mask)
         {
-          storage.erase(key);
-          storage.insert(new_pair);
+          const std::size_t home = hash(slots[j].kv.first) & mask;
+          
+          if ( ((j-home) & mask) >= ((j-i) & mask) )
+          {
+            slots[i] = slots[j];
+            i = j;
+          }
         }
+
+        slots[i] = Slot();
+        entries--;
       }
 
-    void erase(const Key& key) {storage.erase(key);}
+    void clear() {slots.clear(); entries = 0;}
 
-    void clear() {storage.clear();}
+    std::size_t size() const {return entries;}
 
-    const_iter begin() const {return storage.begin();}
-    const_iter   end() const {return storage.end();}
+    const_iter begin() const 
+      {return const_iter(slots.data(), slots.data() + slots.size());}
+    const_iter   end() const
+      {return const_iter(slots.data() + slots.size(),
+                         slots.data() + slots.size());}
 
-          iter begin()       {return storage.begin();}
-          iter   end()       {return storage.end();}    
+          iter begin()
+      {return iter(slots.data(), slots.data() + slots.size());}
+          iter   end()
+      {return iter(slots.data() + slots.size(), slots.data() + slots.size());}
     
   protected:
     
-    std::map<Key, Value> storage;
+    std::vector<Slot> slots; // Size is zero or a power of two.
+    std::size_t entries;
+
+    CacheHash<Key> hash;
+
+    void grow()
+      {
+        std::vector<Slot> old;
+        old.swap(slots);
+
+        slots.resize(old.empty() ? 16 : 2*old.size());
+        entries = 0;
+
+        for (std::size_t i=0; i<old.size(); i++)
+          if (old[i].full)
+            store(old[i].kv.first, old[i].kv.second);
+      }
 };
 
 
@@ -39,7 +39,8 @@ const Waveguide_length Waveguide::operator()(const Complex& d) const
 
 MultiWaveguide::MultiWaveguide(const MultiWaveguide& w)
   : Waveguide(w.uniform, w.core), 
-    last_lambda(w.last_lambda), last_gain_mat_n(w.last_gain_mat_n)
+    last_lambda(w.last_lambda), last_gain_mat_n(w.last_gain_mat_n),
+    last_materials_version(w.last_materials_version)
 {
   for (unsigned int i=0; i<modeset.size(); i++)
     delete modeset[i];
@@ -88,6 +89,9 @@ bool MultiWaveguide::recalc_needed() const
   if (abs(global.lambda - last_lambda) > eps)
     return true;
 
+  if (materials_version(get_materials()) != last_materials_version)
+    return true;
+
   if (!global.gain_mat)
     return false;
 
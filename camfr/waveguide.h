@@ -106,6 +106,11 @@ class Waveguide
       {return 1.0;}
 
     virtual std::string repr() const = 0;
+
+    // Canonical description of the waveguide and the solver settings,
+    // used as key in the disk cache. Empty if it can't be cached.
+
+    virtual std::string disk_key() const {return "";}
     
   protected:
 
@@ -143,7 +148,7 @@ class MultiWaveguide : public Waveguide
 
     MultiWaveguide(bool uniform=false, Material* core=NULL)
       : Waveguide(uniform, core),
-        last_lambda(0.0), last_gain_mat_n(0.0) {}
+        last_lambda(0.0), last_gain_mat_n(0.0), last_materials_version(0) {}
 
     MultiWaveguide(const MultiWaveguide&);
 
@@ -188,11 +193,12 @@ class MultiWaveguide : public Waveguide
 
     std::vector<Mode*> modeset;
     
-    // The wavelength and gain the modes were last calculated for,
-    // are used to determine if recalculation is needed.
+    // The wavelength, gain and material versions the modes were last
+    // calculated for, are used to determine if recalculation is needed.
 
     Complex last_lambda;
     Complex last_gain_mat_n;
+    unsigned long last_materials_version;
 };
 
 
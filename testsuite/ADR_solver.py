@@ -40,6 +40,23 @@ class ADR_solver(unittest.TestCase):
 
         print n_eff_0, "expected", n_eff_0_OK
         mode0_pass = abs((n_eff_0 - n_eff_0_OK)/n_eff_0_OK) < eps.testing_eps
+
+        # Same slab, with the contour integration spread over threads.
+
+        set_threads(4)
+
+        s_ADR_2 = Slab(InP(1.5) + InGaAsP_1_25(0.1) + InGaAsP_1_55(.15)  \
+                       + InGaAsP_1_25(0.1)                               \
+                       + InP(0.5) + InGaAs(0.05) + FeCo(0.05))
+
+        s_ADR_2.calc()
+
+        set_threads(1)
+
+        n_eff_0 = s_ADR_2.mode(0).n_eff()
+        print n_eff_0, "expected", n_eff_0_OK
+        if abs((n_eff_0 - n_eff_0_OK)/n_eff_0_OK) > eps.testing_eps:
+            mode0_pass = 0
         
         free_tmps()
         set_solver(track)
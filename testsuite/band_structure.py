@@ -0,0 +1,91 @@
+#! /usr/bin/env python
+
+####################################################################
+#
+# Band structure of a BlochSection over a list of k-points.
+#
+####################################################################
+
+from camfr import *
+
+import unittest, eps
+
+class band_structure(unittest.TestCase):
+    def testband_structure(self):
+        
+        """Band structure"""
+
+        print
+        print "Running band structure..."
+
+        set_lambda(1.55)
+        set_fourier_orders(1,1)
+
+        GaAs_m = Material(3.5)
+        air_m  = Material(1.0)
+
+        s1 = Slab(air_m(0.2) + GaAs_m(0.2) + air_m(0.2))
+        s2 = Slab(air_m(0.6))
+
+        section = BlochSection(s1(0.3) + s2(0.3))
+
+        k_path = [(0.0, 0.0), (0.5, 0.0), (1.0, 0.5)]
+
+        kz = section.band_structure(k_path, 2)
+
+        # Compare with solving the points one by one.
+
+        passed = 1
+        for k in range(len(k_path)):
+            section.set_kx0_ky0(k_path[k][0], k_path[k][1])
+            section.calc()
+            kz_OK = section.mode(0).kz()
+            print kz[k,0], "expected", kz_OK
+            if abs((kz[k,0] - kz_OK)/kz_OK) > eps.testing_eps:
+                passed = 0
+
+        section.set_kx0_ky0(0, 0)
+
+        # Only calculate the modes closest to a target index.
+
+        old_N = N()
+        set_N(4)
+        set_n_eff_target(3.5)
+
+        kz_partial = section.band_structure(k_path, 2)
+
+        set_N(old_N)
+        set_n_eff_target(0)
+
+        for k in range(len(k_path)):
+            print kz_partial[k,0], "expected", kz[k,0]
+            if abs((kz_partial[k,0] - kz[k,0])/kz[k,0]) > eps.testing_eps:
+                passed = 0
+
+        # A new refractive index should not reuse the Fourier matrices
+        # of the old one.
+
+        GaAs_m.set_n(3.4)
+
+        kz_new = section.band_structure(k_path, 2)
+
+        GaAs_2 = Material(3.4)
+        s1_2 = Slab(air_m(0.2) + GaAs_2(0.2) + air_m(0.2))
+        section_2 = BlochSection(s1_2(0.3) + s2(0.3))
+
+        kz_new_OK = section_2.band_structure(k_path, 2)
+
+        for k in range(len(k_path)):
+            print kz_new[k,0], "expected", kz_new_OK[k,0]
+            if abs((kz_new[k,0] - kz_new_OK[k,0])/kz_new_OK[k,0]) \
+                 > eps.testing_eps:
+                passed = 0
+
+        free_tmps()
+        
+        self.failUnless(passed)
+
+suite = unittest.makeSuite(band_structure, 'test')        
+
+if __name__ == "__main__":
+    unittest.main()
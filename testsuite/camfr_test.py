@@ -15,7 +15,10 @@ import blazed_grating, substacks, planarTE, planarTM, VCSEL, SpE, \
        stack2, degenerate2, grating3, sudbo, polariton2, degenerate3, \
        degenerate4, backward, planar_VCSEL, shift, blochstack, w1reson, \
        surface_plasmon, plasmon_biosensor, backward2, backward3, slab3, \
-       section1, section2, section3, metal_coupler
+       section1, section2, section3, metal_coupler, sweep, icache, diskcache, \
+       field_grid, band_structure, section_symmetry, slab_TE_TM, \
+       incremental_stack, cavity_complex, multi_excitation, slab_geometry, \
+       numpy_views, stack_tree
 
 alltests = unittest.TestSuite((blazed_grating.suite, substacks.suite, 
        planarTE.suite, planarTM.suite, VCSEL.suite, SpE.suite, fw_bw.suite,
@@ -30,7 +33,11 @@ alltests = unittest.TestSuite((blazed_grating.suite, substacks.suite,
        planar_VCSEL.suite, blochstack.suite, w1reson.suite, slab3.suite,
        surface_plasmon.suite, plasmon_biosensor.suite, backward2.suite,
        backward3.suite, section1.suite, section2.suite, section3.suite,
-       metal_coupler.suite ))
+       metal_coupler.suite, sweep.suite, icache.suite,
+       diskcache.suite, field_grid.suite, band_structure.suite,
+       section_symmetry.suite, slab_TE_TM.suite, incremental_stack.suite,
+       cavity_complex.suite, multi_excitation.suite, slab_geometry.suite,
+       numpy_views.suite, stack_tree.suite ))
 
 if __name__ == "__main__":
     r = unittest.TextTestRunner()
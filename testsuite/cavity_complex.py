@@ -0,0 +1,177 @@
+#!/usr/bin/env python
+
+####################################################################
+#
+# Planar VCSEL at threshold refined to a complex wavelength, and an
+# oxide VCSEL whose minima are bracketed on parallel cavity copies.
+#
+####################################################################
+
+from camfr import *
+
+import unittest, eps
+
+class cavity_complex(unittest.TestCase):
+    def testcavity_complex(self):
+        
+        """Cavity complex lambda"""
+
+        print
+        print "Running cavity complex lambda..."
+
+        set_lambda(.980)
+        set_N(1)
+        set_polarisation(TE)
+
+        # Define materials.
+
+        GaAs_m   = Material(3.53)
+        AlGaAs_m = Material(3.08)
+        air_m    = Material(1.00)
+
+        gain_m = Material(3.53)
+
+        set_gain_material(gain_m)
+
+        # Define geometry parameters
+
+        d_GaAs   = .06949
+        d_AlGaAs = .07963
+
+        # Define cross sections
+
+        GaAs   = Planar(  GaAs_m)
+        AlGaAs = Planar(AlGaAs_m)
+        air    = Planar(   air_m)
+        QW     = Planar(  gain_m)
+
+        GaAs.set_theta(0)
+
+        # Define cavity.
+
+        top = Stack(GaAs(0) + AlGaAs(d_AlGaAs) + GaAs(d_GaAs) \
+                    + 24*(AlGaAs(d_AlGaAs) + GaAs(d_GaAs)) + air(0))
+  
+        bottom = Stack(GaAs(.13659) + QW(.00500) + GaAs(.13659) \
+                       + 30*(AlGaAs(d_AlGaAs) + GaAs(d_GaAs)) + GaAs(0))
+  
+        cavity = Cavity(bottom, top)
+
+        cavity.find_mode(.975, .985, 0.0, 0.015, 2)
+
+        lambda_r = get_lambda().real
+
+        # At threshold, the complex resonance lies on the real axis.
+        
+        lambda_c = cavity.find_complex_lambda(lambda_r)
+
+        print lambda_c, "expected", lambda_r
+
+        lambda_pass = abs((lambda_c - lambda_r)/lambda_r) < 1e-5
+
+        free_tmps()
+
+        set_lambda(1.55)
+
+        self.failUnless(lambda_pass)
+
+    def testcavity_copies(self):
+        
+        """Cavity bracketing on copies"""
+
+        print
+        print "Running cavity bracketing on copies..."
+
+        set_lambda(.980)
+        set_N(10)
+        set_circ_order(1)
+        set_circ_PML(-0.1)
+
+        # Define materials.
+
+        GaAs_m   = Material(3.53)
+        AlGaAs_m = Material(3.08)
+        AlAs_m   = Material(2.95)
+        AlOx_m   = Material(1.60)
+        air_m    = Material(1.00)
+
+        gain_m = Material(3.53)
+        loss_m = Material(3.53 - 0.01j)
+
+        set_gain_material(gain_m)
+
+        # Define geometry parameters
+
+        r = 4.0
+        d_cladding = 4.0
+ 
+        d_GaAs   = .06949
+        d_AlGaAs = .07963
+
+        # Each cavity gets its own waveguides, so that the copies can be
+        # evaluated in parallel.
+
+        def oxide_VCSEL():
+            GaAs   = Circ(  GaAs_m(r+d_cladding))
+            AlGaAs = Circ(AlGaAs_m(r+d_cladding))
+            air    = Circ(   air_m(r+d_cladding))
+
+            ox = Circ(AlAs_m(r) + AlOx_m(d_cladding))
+            QW = Circ(gain_m(r) + loss_m(d_cladding))
+
+            top = Stack(GaAs(0) + AlGaAs(.2*d_AlGaAs) + ox(.2*d_AlGaAs) \
+                  + AlGaAs(.6*d_AlGaAs) + GaAs(d_GaAs)                  \
+                  + 24*(AlGaAs(d_AlGaAs) + GaAs(d_GaAs)) + air(0))
+
+            bottom = Stack(GaAs(.13659) + QW(.00500) + GaAs(.13659)     \
+                     + 30*(AlGaAs(d_AlGaAs) + GaAs(d_GaAs)) + GaAs(0))
+
+            return [Cavity(bottom, top), top, bottom]
+
+        # Serial reference.
+
+        cavity = oxide_VCSEL()
+
+        cavity[0].find_all_modes(.975, .985, .0025, 0.0, 0.015, 1, 1)
+
+        lambda_ref = get_lambda().real
+        gain_ref   = gain_m.gain()
+
+        # Same search with the brackets spread over three threads.
+
+        set_threads(3)
+
+        copies = [oxide_VCSEL(), oxide_VCSEL()]
+        cavity[0].set_bracket_copies([c[0] for c in copies])
+
+        gain_m.set_n(3.53)
+        set_lambda(.980)
+
+        cavity[0].find_all_modes(.975, .985, .0025, 0.0, 0.015, 1, 1)
+
+        wavelength = get_lambda().real
+        gain = gain_m.gain()
+
+        print wavelength, "expected", lambda_ref
+        print gain, "expected", gain_ref
+
+        wavelength_pass \
+          = abs((wavelength - lambda_ref)/lambda_ref) < eps.testing_eps
+        gain_pass = abs((gain - gain_ref)/gain_ref) < 20*eps.testing_eps
+
+        cavity[0].set_bracket_copies([])
+
+        set_threads(1)
+
+        free_tmps()
+
+        set_circ_PML(0)
+
+        set_lambda(1.55)
+
+        self.failUnless(wavelength_pass and gain_pass)
+
+suite = unittest.makeSuite(cavity_complex, 'test')        
+
+if __name__ == "__main__":
+    unittest.main()
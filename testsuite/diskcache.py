@@ -0,0 +1,66 @@
+#! /usr/bin/env python
+
+####################################################################
+#
+# Persistent disk cache for modes and interfaces.
+#
+####################################################################
+
+from camfr import *
+
+import unittest, eps, os, tempfile
+
+def calc_R():
+
+    GaAs_m = Material(3.5)
+    air_m  = Material(1.0)
+
+    GaAs = Slab(air_m(1) + GaAs_m(0.2) + air_m(1))
+    air  = Slab(air_m(2.2))
+
+    s = Stack(air(0) + GaAs(0.3) + air(0.2) + GaAs(0.3) + air(0))
+    s.calc()
+    
+    return s.R12(0,0)
+
+class diskcache(unittest.TestCase):
+    def testdiskcache(self):
+        
+        """Disk cache"""
+
+        print
+        print "Running disk cache..."
+
+        set_N(20)
+        set_polarisation(TE)
+        set_lambda(1.55)
+
+        filename = tempfile.mktemp()
+
+        # First run fills the cache, second one reads from it.
+
+        open_disk_cache(filename)
+        R_OK = calc_R()
+        close_disk_cache()
+
+        open_disk_cache(filename)
+        R = calc_R()
+        stats = disk_cache_stats()
+        close_disk_cache()
+
+        os.remove(filename)
+
+        print R, "expected", R_OK
+        print stats
+
+        passed =     abs((R - R_OK)/R_OK) < eps.testing_eps \
+                 and stats["hits"] > 0
+        
+        free_tmps()
+        
+        self.failUnless(passed)
+
+suite = unittest.makeSuite(diskcache, 'test')        
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,69 @@
+#! /usr/bin/env python
+
+####################################################################
+#
+# Batched field evaluation on a grid.
+#
+####################################################################
+
+from camfr import *
+
+import unittest, eps
+
+class field_grid(unittest.TestCase):
+    def testfield_grid(self):
+        
+        """Field grid"""
+
+        print
+        print "Running field grid..."
+
+        set_N(20)
+        set_polarisation(TE)
+        set_lambda(1.55)
+
+        GaAs_m = Material(3.5)
+        air_m  = Material(1.0)
+
+        GaAs = Slab(air_m(1) + GaAs_m(0.2) + air_m(1))
+        air  = Slab(air_m(2.2))
+
+        s = Stack(GaAs(0.5) + air(0.3) + GaAs(0.5))
+
+        inc = zeros(N())
+        inc[0] = 1
+        s.set_inc_field(inc)
+        s.calc()
+
+        x = [0.3, 1.1, 1.25]
+        z = [0.1, 0.6, 0.9, 1.2]
+
+        f = s.field_grid(x, z)
+
+        passed = 1
+        for k in range(len(z)):
+            for i in range(len(x)):
+                E2_OK = s.field(Coord(x[i], 0, z[k])).E2()
+                E2    = f[k,i,1]
+                print E2, "expected", E2_OK
+                if abs(E2 - E2_OK) > eps.testing_eps * (abs(E2_OK) + 1e-3):
+                    passed = 0
+
+        # Compare tabulated mode profiles with direct evaluation.
+
+        P = GaAs.mode_profiles([Coord(xi, 0, 0) for xi in x])
+        for i in range(len(x)):
+            E2_OK = GaAs.mode(2).field(Coord(x[i], 0, 0)).E2()
+            E2    = P[1,i,2]
+            print E2, "expected", E2_OK
+            if abs(E2 - E2_OK) > eps.testing_eps * (abs(E2_OK) + 1e-3):
+                passed = 0
+
+        free_tmps()
+        
+        self.failUnless(passed)
+
+suite = unittest.makeSuite(field_grid, 'test')        
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,75 @@
+#! /usr/bin/env python
+
+####################################################################
+#
+# Interface cache with a memory budget.
+#
+####################################################################
+
+from camfr import *
+
+import unittest, eps
+
+class icache(unittest.TestCase):
+    def testicache(self):
+        
+        """Interface cache"""
+
+        print
+        print "Running interface cache..."
+
+        set_N(20)
+        set_polarisation(TE)
+        set_lambda(1.55)
+
+        GaAs_m = Material(3.5)
+        air_m  = Material(1.0)
+
+        GaAs = Slab(air_m(1) + GaAs_m(0.2) + air_m(1))
+        air  = Slab(air_m(2.2))
+
+        s1 = Stack(air(0) + GaAs(0.3) + air(0.2) + GaAs(0.3) + air(0))
+        s2 = Stack(GaAs(0) + air(0.4) + GaAs(0))
+
+        inc = zeros(N())
+        inc[0] = 1
+
+        s1.calc()
+        R_OK = s1.R12(0,0)
+
+        s1.set_inc_field(inc)
+        f_OK = s1.field(Coord(1.1,0,0.4)).E2()
+
+        # Calculating s2 with a tiny budget frees the interfaces of s1.
+        # Only these should be recalculated, as the fields need them.
+
+        reset_interface_cache_stats()
+        set_interface_cache_budget(1)
+
+        s2.calc()
+        s1.calc()
+        R = s1.R12(0,0)
+
+        s1.set_inc_field(inc)
+        f = s1.field(Coord(1.1,0,0.4)).E2()
+
+        stats = interface_cache_stats()
+
+        print R, "expected", R_OK
+        print f, "expected", f_OK
+        print stats
+
+        set_interface_cache_budget(0)
+
+        passed =     abs((R - R_OK)/R_OK) < eps.testing_eps \
+                 and abs((f - f_OK)/f_OK) < eps.testing_eps \
+                 and stats["evictions"] > 0
+        
+        free_tmps()
+        
+        self.failUnless(passed)
+
+suite = unittest.makeSuite(icache, 'test')        
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,209 @@
+#! /usr/bin/env python
+
+###################################################################
+#
+# Incremental stack recalculation after a change in gain material.
+#
+###################################################################
+
+from camfr import *
+
+import unittest, eps
+
+class incremental_stack(unittest.TestCase):
+    def testincremental_stack(self):
+
+        """Incremental stack"""
+
+        print
+        print "Running incremental stack..."
+
+        set_N(20)
+        set_lambda(1.55)
+
+        GaAs = Material(3.5)
+        air  = Material(1.0)
+        act  = Material(3.5)
+
+        set_gain_material(act)
+
+        wg     = Slab(air(2.0) + GaAs(0.2) + air(2.0))
+        active = Slab(air(2.0) +  act(0.2) + air(2.0))
+
+        s = Stack(wg(0) + wg(0.5) + active(0.3) + wg(0.4) + \
+                  active(0.2) + wg(0.6) + wg(0))
+
+        set_incremental_stacks(1)
+
+        R = []
+        for n in [3.5, 3.5-0.01j, 3.5-0.03j]:
+            act.set_n(n)
+            s.calc()
+            R.append(s.R12(0,0))
+
+        set_incremental_stacks(0)
+
+        n_pass = 1
+        for i, n in enumerate([3.5, 3.5-0.01j, 3.5-0.03j]):
+            act.set_n(n)
+            s_2 = Stack(wg(0) + wg(0.5) + active(0.3) + wg(0.4) + \
+                        active(0.2) + wg(0.6) + wg(0))
+            s_2.calc()
+            R_OK = s_2.R12(0,0)
+            print R[i], "expected", R_OK
+            if abs((R[i] - R_OK) / R_OK) > eps.testing_eps:
+                n_pass = 0
+
+        free_tmps()
+
+        self.failUnless(n_pass)
+
+    def testincremental_stack_thickness(self):
+
+        """Incremental stack thickness"""
+
+        print
+        print "Running incremental stack thickness..."
+
+        set_N(20)
+        set_lambda(1.55)
+
+        GaAs = Material(3.5)
+        AlAs = Material(2.9)
+        air  = Material(1.0)
+
+        wg  = Slab(air(2.0) + GaAs(0.2) + air(2.0))
+        wg2 = Slab(air(2.0) + AlAs(0.3) + air(2.0))
+
+        set_incremental_stacks(1)
+
+        s = Stack(wg(0) + wg(0.5) + wg2(0.3) + wg(0.4) + \
+                  wg2(0.2) + wg(0.6) + wg(0))
+        s.calc()
+
+        # Chunk 2 is the propagation in wg after the first wg2 section.
+
+        R = []
+        for d in [0.45, 0.55]:
+            s.set_thickness(2, d)
+            s.calc()
+            R.append(s.R12(0,0))
+
+        set_incremental_stacks(0)
+
+        n_pass = 1
+        for i, d in enumerate([0.45, 0.55]):
+            s_2 = Stack(wg(0) + wg(0.5) + wg2(0.3) + wg(d) + \
+                        wg2(0.2) + wg(0.6) + wg(0))
+            s_2.calc()
+            R_OK = s_2.R12(0,0)
+            print R[i], "expected", R_OK
+            if abs((R[i] - R_OK) / R_OK) > eps.testing_eps:
+                n_pass = 0
+
+        free_tmps()
+
+        self.failUnless(n_pass)
+
+    def testincremental_stack_material(self):
+
+        """Incremental stack material"""
+
+        print
+        print "Running incremental stack material..."
+
+        set_N(20)
+        set_lambda(1.55)
+
+        GaAs = Material(3.5)
+        AlAs = Material(2.9)
+        air  = Material(1.0)
+
+        wg  = Slab(air(2.0) + GaAs(0.2) + air(2.0))
+        wg2 = Slab(air(2.0) + AlAs(0.3) + air(2.0))
+
+        set_incremental_stacks(1)
+
+        s = Stack(wg(0) + wg(0.5) + wg2(0.3) + wg(0.4) + \
+                  wg2(0.2) + wg(0.6) + wg(0))
+        s.calc()
+
+        # AlAs is not the gain material, so only the version of the
+        # material signals the change.
+
+        R = []
+        for n in [3.0, 3.1]:
+            AlAs.set_n(n)
+            s.calc()
+            R.append(s.R12(0,0))
+
+        set_incremental_stacks(0)
+
+        n_pass = 1
+        for i, n in enumerate([3.0, 3.1]):
+            AlAs_2 = Material(n)
+            wg2_2 = Slab(air(2.0) + AlAs_2(0.3) + air(2.0))
+            s_2 = Stack(wg(0) + wg(0.5) + wg2_2(0.3) + wg(0.4) + \
+                        wg2_2(0.2) + wg(0.6) + wg(0))
+            s_2.calc()
+            R_OK = s_2.R12(0,0)
+            print R[i], "expected", R_OK
+            if abs((R[i] - R_OK) / R_OK) > eps.testing_eps:
+                n_pass = 0
+
+        free_tmps()
+
+        self.failUnless(n_pass)
+
+    def testincremental_stack_nested(self):
+
+        """Incremental stack nested thickness"""
+
+        print
+        print "Running incremental stack nested thickness..."
+
+        set_N(20)
+        set_lambda(1.55)
+
+        GaAs = Material(3.5)
+        AlAs = Material(2.9)
+        air  = Material(1.0)
+
+        wg  = Slab(air(2.0) + GaAs(0.2) + air(2.0))
+        wg2 = Slab(air(2.0) + AlAs(0.3) + air(2.0))
+
+        set_incremental_stacks(1)
+
+        sub = Stack(wg(0) + wg2(0.3) + wg(0.4) + wg2(0.2) + wg(0))
+        s = Stack(wg(0) + wg(0.5) + sub + wg(0.6) + wg(0))
+        s.calc()
+
+        # Chunk 1 of the substack is the propagation in wg between the
+        # wg2 sections. Only the substack sees the new thickness.
+
+        R = []
+        for d in [0.45, 0.55]:
+            sub.set_thickness(1, d)
+            s.calc()
+            R.append(s.R12(0,0))
+
+        set_incremental_stacks(0)
+
+        n_pass = 1
+        for i, d in enumerate([0.45, 0.55]):
+            s_2 = Stack(wg(0) + wg(0.5) + wg2(0.3) + wg(d) + \
+                        wg2(0.2) + wg(0.6) + wg(0))
+            s_2.calc()
+            R_OK = s_2.R12(0,0)
+            print R[i], "expected", R_OK
+            if abs((R[i] - R_OK) / R_OK) > eps.testing_eps:
+                n_pass = 0
+
+        free_tmps()
+
+        self.failUnless(n_pass)
+
+suite = unittest.makeSuite(incremental_stack, 'test')
+
+if __name__ == "__main__":
+    unittest.main()
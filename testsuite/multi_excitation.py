@@ -0,0 +1,64 @@
+#! /usr/bin/env python
+
+####################################################################
+#
+# Several excitations at once compared to one at a time.
+#
+####################################################################
+
+from camfr import *
+
+import unittest, eps, numpy
+
+class multi_excitation(unittest.TestCase):
+    def testmulti_excitation(self):
+        
+        """Multiple excitations"""
+
+        print
+        print "Running multiple excitations..."
+
+        set_N(10)
+        set_lambda(1.55)
+        set_polarisation(TE)
+
+        GaAs_m = Material(3.5)
+        air_m  = Material(1.0)
+
+        GaAs = Slab(air_m(1) + GaAs_m(0.2) + air_m(1))
+        air  = Slab(air_m(2.2))
+
+        s = Stack(air(0) + GaAs(0.3) + air(0.2) + GaAs(0.3) + air(0))
+
+        inc = numpy.zeros((N(), 3), complex)
+        for k in range(3):
+            inc[k,k] = 1
+
+        R = s.refl_fields(inc)
+        T = s.trans_fields(inc)
+        fw, bw = s.interface_fields(inc)
+
+        passed = True
+
+        for k in range(3):
+            s.set_inc_field(inc[:,k])
+
+            R_OK = s.refl_field()
+            T_OK = s.trans_field()
+
+            print R[k,k], "expected", R_OK[k]
+
+            for i in range(N()):
+                passed = passed and abs(R[i,k] - R_OK[i]) < eps.testing_eps
+                passed = passed and abs(T[i,k] - T_OK[i]) < eps.testing_eps
+                passed = passed and abs(bw[0,i,k] - R_OK[i]) < eps.testing_eps
+                passed = passed and abs(fw[-1,i,k]- T_OK[i]) < eps.testing_eps
+
+        free_tmps()
+        
+        self.failUnless(passed)
+
+suite = unittest.makeSuite(multi_excitation, 'test')        
+
+if __name__ == "__main__":
+    unittest.main()
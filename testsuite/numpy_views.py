@@ -0,0 +1,123 @@
+#! /usr/bin/env python
+
+####################################################################
+#
+# Array views, output arrays and bulk accessors.
+#
+####################################################################
+
+from camfr import *
+
+import unittest, eps, numpy
+
+class numpy_views(unittest.TestCase):
+    def testnumpy_views(self):
+        
+        """NumPy views"""
+
+        print
+        print "Running NumPy views..."
+
+        set_N(10)
+        set_lambda(1.55)
+        set_polarisation(TE)
+
+        GaAs_m = Material(3.5)
+        air_m  = Material(1.0)
+
+        GaAs = Slab(air_m(1) + GaAs_m(0.2) + air_m(1))
+        air  = Slab(air_m(2.2))
+
+        s = Stack(air(0) + GaAs(0.3) + air(0.2) + GaAs(0.3) + air(0))
+        s.calc()
+
+        N = 10
+        passed = True
+
+        # Existing accessors return copies, views are explicitly named.
+
+        R12_copy = s.R12()
+        R12 = s.R12_view()
+        print R12[0,0], "expected", s.R12(0,0)
+
+        passed = passed and R12_copy.flags.writeable
+        passed = passed and not R12.flags.writeable
+        for i in range(N):
+            for j in range(N):
+                passed = passed and R12[i,j] == s.R12(i,j)
+                passed = passed and R12_copy[i,j] == s.R12(i,j)
+
+        # The view keeps its stack alive.
+
+        def T21_view():
+            t = Stack(air(0) + GaAs(0.3) + air(0))
+            t.calc()
+            return t.T21_view(), t.T21(0,0)
+
+        T21, T21_00 = T21_view()
+        passed = passed and T21.shape == (N,N) and T21[0,0] == T21_00
+
+        # Caller-provided output, in C order, Fortran order or strided.
+
+        for T12 in [numpy.zeros((N,N), complex),
+                    numpy.zeros((N,N), complex, order='F'),
+                    numpy.zeros((2*N,N), complex)[::2,:]]:
+            s.T12(T12)
+            for i in range(N):
+                for j in range(N):
+                    passed = passed and T12[i,j] == s.T12(i,j)
+
+        # Outputs that would be broadcast or converted are rejected.
+
+        for bad in [numpy.zeros((1,N), complex), numpy.zeros((N,N,1), complex),
+                    numpy.zeros((N,N), float)]:
+            try:
+                s.T12(bad)
+                passed = False
+            except ValueError:
+                pass
+
+        # Mode profiles into an output array.
+
+        coords = [Coord(x,0,0) for x in [0.5, 1.1, 1.7]]
+        profiles = air.mode_profiles(coords)
+        profiles_out = numpy.zeros((6,len(coords),N), complex, order='F')
+        air.mode_profiles(coords, profiles_out)
+        passed = passed and (profiles == profiles_out).all()
+
+        # All kz values at once.
+
+        kz = air.kz_values()
+        for i in range(N):
+            passed = passed and kz[i] == air.mode(i).kz()
+
+        # Sweep into output arrays.
+
+        lambdas = [1.50, 1.55, 1.60]
+
+        R, T = sweep_lambda(s, lambdas)
+
+        for order_R, order_T in [('C','C'), ('F','F'), ('C','F')]:
+            R_out = numpy.zeros((len(lambdas),N,N), complex, order=order_R)
+            T_out = numpy.zeros((len(lambdas),N,N), complex, order=order_T)
+            sweep_lambda(s, lambdas, [], R_out, T_out)
+
+            passed = passed and numpy.abs(R - R_out).max() < eps.testing_eps
+            passed = passed and numpy.abs(T - T_out).max() < eps.testing_eps
+
+        R_e, T_e = sweep_lambda(s, lambdas, [(0,0), (1,2)])
+        R_out = numpy.zeros((2,len(lambdas)), complex).T
+        T_out = numpy.zeros((len(lambdas),2), complex)
+        sweep_lambda(s, lambdas, [(0,0), (1,2)], R_out, T_out)
+
+        passed = passed and numpy.abs(R_e - R_out).max() < eps.testing_eps
+        passed = passed and numpy.abs(T_e - T_out).max() < eps.testing_eps
+
+        free_tmps()
+        
+        self.failUnless(passed)
+
+suite = unittest.makeSuite(numpy_views, 'test')        
+
+if __name__ == "__main__":
+    unittest.main()
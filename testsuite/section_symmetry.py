@@ -0,0 +1,96 @@
+#! /usr/bin/env python
+
+###################################################################
+#
+# Symmetry-reduced Fourier solver for a buried rectangular core.
+#
+###################################################################
+
+from camfr import *
+
+import unittest, eps
+
+class section_symmetry(unittest.TestCase):
+    def testsection_symmetry(self):
+
+        """Section symmetry"""
+
+        print
+        print "Running section symmetry..."
+        
+        set_lambda(1.55)
+        set_N(4)
+
+        SiO2_m = Material(1.45)
+        Si_m   = Material(3.50)
+
+        clad = Slab(SiO2_m(1.5))
+        core = Slab(SiO2_m(0.5) + Si_m(0.5) + SiO2_m(0.5))
+
+        s_full = Section(clad(0.5) + core(0.5) + clad(0.5), 8, 8)
+        s_full.calc()
+
+        s_symm = Section(clad(0.5) + core(0.5) + clad(0.5), 8, 8)
+        s_symm.set_symmetry(1, 1)
+        s_symm.calc()
+
+        # The problem should really have been split in four parity
+        # blocks, rather than solved in full after a failed check.
+
+        blocks = [s_symm.symmetry_block_size(b) for b in range(4)]
+        print "parity blocks", blocks
+
+        passed = (min(blocks) > 0) and (2*max(blocks) <= sum(blocks))
+        for i in range(4):
+            n_eff    = s_symm.mode(i).n_eff()
+            n_eff_OK = s_full.mode(i).n_eff()
+            print n_eff, "expected", n_eff_OK
+            if abs((n_eff - n_eff_OK)/n_eff_OK) > eps.testing_eps:
+                passed = 0
+
+        free_tmps()
+        
+        self.failUnless(passed)
+
+    def testsection_symmetry_fallback(self):
+
+        """Section symmetry fallback"""
+
+        print
+        print "Running section symmetry fallback..."
+
+        set_lambda(1.55)
+        set_N(4)
+
+        SiO2_m = Material(1.45)
+        Si_m   = Material(3.50)
+
+        clad = Slab(SiO2_m(1.5))
+        core = Slab(SiO2_m(0.3) + Si_m(0.5) + SiO2_m(0.7))
+
+        # Core is off-centre, so the declared symmetry is wrong and the
+        # solver should fall back to the full problem.
+
+        s_full = Section(clad(0.5) + core(0.5) + clad(0.5), 8, 8)
+        s_full.calc()
+
+        s_symm = Section(clad(0.5) + core(0.5) + clad(0.5), 8, 8)
+        s_symm.set_symmetry(1, 1)
+        s_symm.calc()
+
+        passed = (s_symm.symmetry_block_size(0) == 0)
+        for i in range(4):
+            n_eff    = s_symm.mode(i).n_eff()
+            n_eff_OK = s_full.mode(i).n_eff()
+            print n_eff, "expected", n_eff_OK
+            if abs((n_eff - n_eff_OK)/n_eff_OK) > eps.testing_eps:
+                passed = 0
+
+        free_tmps()
+
+        self.failUnless(passed)
+
+suite = unittest.makeSuite(section_symmetry, 'test')
+
+if __name__ == "__main__":
+    unittest.main()
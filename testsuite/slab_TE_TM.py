@@ -0,0 +1,81 @@
+#! /usr/bin/env python
+
+###################################################################
+#
+# Slab with TE and TM modes found concurrently.
+#
+###################################################################
+
+from camfr import *
+
+import unittest, eps
+
+class slab_TE_TM(unittest.TestCase):
+    def testslab_TE_TM(self):
+
+        """Slab TE_TM"""
+
+        print
+        print "Running slab TE_TM..."
+
+        set_lambda(1.55)
+        set_N(20)
+        set_polarisation(TE_TM)
+
+        core = Material(3.5)
+        clad = Material(1.45)
+
+        # Compare modes found with 2 threads with those found serially,
+        # in slabs with and without out-of-plane wavevector, and with
+        # the ASR solver, which falls back to a sequential search.
+
+        n_pass = 1
+
+        for case in ["slab_ky=0", "slab_ky=2", "ASR"]:
+
+            print case
+
+            if case == "slab_ky=2":
+                set_beta(2.0)
+            if case == "ASR":
+                set_solver(ASR)
+
+            s = Slab(clad(2.0) + core(0.5) + clad(2.0))
+            s.calc()
+
+            n_serial = [s.mode(i).n_eff() for i in range(20)]
+            f_serial = [s.mode(i).field(Coord(2.2,0,0)) for i in range(20)]
+
+            set_threads(2)
+
+            s_2 = Slab(clad(2.0) + core(0.5) + clad(2.0))
+            s_2.calc()
+
+            set_threads(1)
+
+            for i in range(20):
+                n = s_2.mode(i).n_eff()
+                if abs((n - n_serial[i]) / n_serial[i]) > eps.testing_eps:
+                    print i, n, "expected", n_serial[i]
+                    n_pass = 0
+
+                f = s_2.mode(i).field(Coord(2.2,0,0))
+                for E, E_OK in [(f.E1(), f_serial[i].E1()),
+                                (f.E2(), f_serial[i].E2())]:
+                    if abs(E - E_OK) > eps.testing_eps * (abs(E_OK) + 1e-3):
+                        print i, E, "expected", E_OK
+                        n_pass = 0
+
+            free_tmps()
+
+            set_beta(0)
+            set_solver(track)
+
+        set_polarisation(TE)
+
+        self.failUnless(n_pass)
+
+suite = unittest.makeSuite(slab_TE_TM, 'test')
+
+if __name__ == "__main__":
+    unittest.main()
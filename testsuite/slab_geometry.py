@@ -0,0 +1,123 @@
+#! /usr/bin/env python
+
+###################################################################
+#
+# Native geometry rasterizer compared to the Python slicing.
+#
+###################################################################
+
+from camfr import *
+
+import unittest, eps
+
+# Wrapping a shape hides it from the native rasterizer.
+
+class PythonShape:
+    def __init__(self, s):
+        self.s   = s
+        self.mat = s.mat
+
+    def intersection_at_x(self, x):
+        return self.s.intersection_at_x(x)
+
+class slab_geometry(unittest.TestCase):
+    def testslab_geometry(self):
+        
+        """Native geometry rasterizer"""
+
+        print
+        print "Running native geometry rasterizer..."
+        
+        set_N(20)
+        set_lambda(1.55)
+        set_lower_wall(slab_H_wall)
+
+        GaAs = Material(3.37)
+        air  = Material(1.0)
+
+        a = 0.5
+        periods = 4
+
+        shapes = []
+        for i in range(periods):
+            shapes.append(Circle(Point(i*a, a), 0.15 + 0.01*i, air))
+        shapes.append(Triangle(Point(-a/2., 0), Point(-a/2., a/2.),
+                               Point(periods*a, 0.1), air))
+        shapes.append(Polygon([Point(0, 1.5*a), Point(a, 1.4*a),
+                               Point(a, 1.8*a), Point(0, 1.9*a)], air))
+
+        g_native = Geometry(GaAs)
+        g_python = Geometry(GaAs)
+        for s in shapes:
+            g_native += s
+            g_python += PythonShape(s)
+
+        args = (-a/2., periods*a - a/2., a/20., 0, 2*a, a/20.)
+
+        n0 = shared_slabs()
+        e_native = g_native.to_expression(*args)
+        s_native = Stack(e_native)
+        n1 = shared_slabs()
+
+        # Identical slices should share their slabs.
+
+        s_again = Stack(g_native.to_expression(*args))
+        n2 = shared_slabs()
+
+        s_python = Stack(g_python.to_expression(*args))
+
+        s_native.calc()
+        s_again.calc()
+        s_python.calc()
+
+        R_native = s_native.R12(0,0)
+        R_again  = s_again.R12(0,0)
+        R_python = s_python.R12(0,0)
+
+        print R_native, "expected", R_python
+
+        R_pass = abs((R_native-R_python)/R_python) < eps.testing_eps \
+             and abs((R_again -R_python)/R_python) < eps.testing_eps
+        cache_pass = (n1 > n0) and (n2 == n1)
+
+        # The shared slabs survive free_tmps, so that an expression made
+        # before can still be used. A new material never picks up the
+        # slabs of an old one.
+
+        free_tmps()
+        kept_pass = (shared_slabs() == n2)
+
+        s_later = Stack(e_native)
+        s_later.calc()
+
+        R_later = s_later.R12(0,0)
+
+        air2 = Material(1.0)
+        g_new = Geometry(GaAs)
+        for s in shapes:
+            if isinstance(s, Circle):
+                g_new += Circle(s.c, s.r, air2)
+            else:
+                g_new += s
+
+        s_new = Stack(g_new.to_expression(*args))
+        s_new.calc()
+        n3 = shared_slabs()
+
+        R_new = s_new.R12(0,0)
+
+        print R_later, R_new, "expected", R_python
+
+        R_pass = R_pass and abs((R_later-R_python)/R_python) < eps.testing_eps
+        R_pass = R_pass and abs((R_new-R_python)/R_python) < eps.testing_eps
+        cache_pass = cache_pass and kept_pass and (n3 > n2)
+
+        free_tmps()
+        set_lower_wall(slab_E_wall)
+
+        self.failUnless(R_pass and cache_pass)
+
+suite = unittest.makeSuite(slab_geometry, 'test')
+
+if __name__ == "__main__":
+    unittest.main()
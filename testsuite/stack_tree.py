@@ -0,0 +1,62 @@
+#! /usr/bin/env python
+
+###################################################################
+#
+# Tree combination of the S-scheme with several threads.
+#
+###################################################################
+
+from camfr import *
+
+import unittest, eps
+
+class stack_tree(unittest.TestCase):
+    def teststack_tree(self):
+
+        """Stack tree"""
+
+        print
+        print "Running stack tree..."
+
+        set_N(20)
+        set_lambda(1.55)
+
+        GaAs = Material(3.5)
+        AlAs = Material(2.9)
+        air  = Material(1.0)
+
+        wg  = Slab(air(2.0) + GaAs(0.2) + air(2.0))
+        wg2 = Slab(air(2.0) + AlAs(0.4) + air(2.0))
+
+        def calc_RT():
+            s = Stack(wg(0) + wg(0.5) + wg2(0.3) + wg(0.4) + wg2(0.2) \
+                      + wg(0.6) + wg2(0.1) + wg(0))
+            s.calc()
+            return [[s.R12(i,j) for j in range(3)] for i in range(3)] + \
+                   [[s.T12(i,j) for j in range(3)] for i in range(3)] + \
+                   [[s.R21(i,j) for j in range(3)] for i in range(3)] + \
+                   [[s.T21(i,j) for j in range(3)] for i in range(3)]
+
+        set_threads(1)
+        RT_OK = calc_RT()
+
+        n_pass = 1
+        for threads in [2, 3, 4]:
+            set_threads(threads)
+            RT = calc_RT()
+            for i in range(len(RT)):
+                for j in range(len(RT[i])):
+                    if abs(RT[i][j] - RT_OK[i][j]) > \
+                       eps.testing_eps * (abs(RT_OK[i][j]) + 1e-10):
+                        print threads, RT[i][j], "expected", RT_OK[i][j]
+                        n_pass = 0
+
+        set_threads(1)
+        free_tmps()
+
+        self.failUnless(n_pass)
+
+suite = unittest.makeSuite(stack_tree, 'test')
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,86 @@
+#! /usr/bin/env python
+
+####################################################################
+#
+# Parallel wavelength sweep compared to a serial loop.
+#
+####################################################################
+
+from camfr import *
+
+import unittest, eps
+
+def make_stack():
+
+    GaAs_m = Material(3.5)
+    air_m  = Material(1.0)
+
+    GaAs = Slab(air_m(1) + GaAs_m(0.2) + air_m(1))
+    air  = Slab(air_m(2.2))
+
+    s = Stack(air(0) + GaAs(0.3) + air(0.2) + GaAs(0.3) + air(0))
+
+    # Keep the waveguides alive as long as the stack.
+    
+    return s, [GaAs_m, air_m, GaAs, air]
+
+class sweep(unittest.TestCase):
+    def testsweep(self):
+        
+        """Sweep"""
+
+        print
+        print "Running sweep..."
+
+        set_N(10)
+        set_polarisation(TE)
+
+        s1, keep1 = make_stack()
+        s2, keep2 = make_stack()
+
+        lambdas = [1.50, 1.52, 1.55, 1.58, 1.60]
+
+        R12, T12 = sweep_lambda([s1, s2], lambdas)
+        R00, T11 = sweep_lambda([s1, s2], lambdas, [(0,0), (1,1)])
+
+        passed = True
+
+        for l in range(len(lambdas)):
+            set_lambda(lambdas[l])
+            s1.calc()
+
+            R_OK = s1.R12(0,0)
+            T_OK = s1.T12(1,1)
+
+            print R12[l,0,0], "expected", R_OK
+        
+            passed = passed and abs((R12[l,0,0] - R_OK)/R_OK) < eps.testing_eps
+            passed = passed and abs((T12[l,1,1] - T_OK)/T_OK) < eps.testing_eps
+            passed = passed and abs((R00[l,0]   - R_OK)/R_OK) < eps.testing_eps
+            passed = passed and abs((T11[l,1]   - T_OK)/T_OK) < eps.testing_eps
+
+        # Stacks sharing a waveguide would race on its modes.
+
+        rejected = 0
+        try:
+            sweep_lambda([s1, s1], lambdas)
+        except ValueError:
+            rejected = rejected + 1
+
+        s3 = Stack(keep1[3](0) + keep1[2](0.5) + keep1[3](0))
+        try:
+            sweep_lambda([s1, s3], lambdas)
+        except ValueError:
+            rejected = rejected + 1
+
+        passed = passed and (rejected == 2)
+
+        free_tmps()
+        
+        self.failUnless(passed)
+
+suite = unittest.makeSuite(sweep, 'test')        
+
+if __name__ == "__main__":
+    unittest.main()
+    